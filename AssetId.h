@@ -1,29 +1,41 @@
 #pragma once
-#include <memory>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 #include "Serialization.h"
 
-struct AssetId_private;
-//wraps GUID
+//wraps GUID, stored by value so it can be copied and hashed without allocating
 class AssetId {
-	std::shared_ptr<AssetId_private> assetId_privateSPtr;
+	uint64_t high = 0;
+	uint64_t low = 0;
 public:
-	AssetId();
+	AssetId() = default;
 	static AssetId CreateNewAssetId();
-	static bool TryParse(std::string& string, AssetId& out_assetId);
+	static bool TryParse(const std::string& string, AssetId& out_assetId);
+
+	bool operator==(const AssetId& other) const { return high == other.high && low == other.low; }
+	bool operator!=(const AssetId& other) const { return !(*this == other); }
+	bool operator<(const AssetId& other) const { return high != other.high ? high < other.high : low < other.low; }
 
-	bool operator==(const AssetId& other) const;
-	operator std::string() const;
 	std::string ToString() const;
-	unsigned short GetHashCode() const;
-	bool IsEmpty() const;
+	uint64_t GetHashCode() const {
+		// GUIDs are mostly random already, mixing makes sure both halves affect the low bits used for bucketing
+		uint64_t hash = high * 0x9E3779B97F4A7C15ull ^ low;
+		hash ^= hash >> 32;
+		hash *= 0xD6E8FEB86659FD93ull;
+		hash ^= hash >> 32;
+		return hash;
+	}
+	bool IsEmpty() const { return high == 0 && low == 0; }
 };
 
+static_assert(std::is_trivially_copyable_v<AssetId> && sizeof(AssetId) == 16);
+
 namespace std {
 	template<>
-	struct std::hash<AssetId> {
+	struct hash<AssetId> {
 		std::size_t operator()(const AssetId& key) const noexcept {
-			return key.GetHashCode();
+			return static_cast<std::size_t>(key.GetHashCode());
 		}
 	};
 }
@@ -37,4 +49,4 @@ namespace Serialization {
 		auto str = DeserializeStdString(stream);
 		return AssetId::TryParse(str, out_AssetId);
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,98 @@
+#include "AssetLoader.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "Files.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Resources.h"
+
+void AssetLoader::ScheduleDecode(const std::string& absoluteAssetPath) {
+	++pendingJobs;
+	++totalSteps;
+	JobSystem::Schedule([absoluteAssetPath] {
+		PROFILE_SCOPE("Texture::DecodeFromAssetFile");
+		Rendering::DecodedImage image;
+		// textureSheets share the .asset extension and are skipped here
+		if (Rendering::Texture::DecodeFromAssetFile(absoluteAssetPath, image)) {
+			std::lock_guard lock(decodedMutex);
+			decodedImages.push_back(std::move(image));
+		}
+		++completedJobs;
+		--pendingJobs;
+	});
+}
+
+void AssetLoader::QueueDirectory(const char* directory, const bool includeSubdirectories) {
+	directories.push_back({ directory, includeSubdirectories });
+	++totalSteps;
+
+	const auto schedule = [](const std::filesystem::directory_entry& entry) {
+		if (!entry.is_regular_file() || entry.is_symlink()) return;
+		if (entry.path().extension() != AssetHeader::FileExtension) return;
+		ScheduleDecode(entry.path().string());
+	};
+
+	if (includeSubdirectories) {
+		for (auto& entry : Files::GetDirectoryIteratorRecursive(directory)) schedule(entry);
+	}
+	else {
+		for (auto& entry : Files::GetDirectoryIterator(directory)) schedule(entry);
+	}
+}
+
+bool AssetLoader::Update(const double budgetMilliseconds) {
+	if (!IsLoading()) return false;
+
+	using clock = std::chrono::steady_clock;
+	const auto deadline = clock::now() + std::chrono::duration<double, std::milli>(budgetMilliseconds);
+
+	// uploads, at least one per call so loading always progresses
+	do {
+		if (nextUpload == uploadQueue.size()) {
+			uploadQueue.clear();
+			nextUpload = 0;
+			std::lock_guard lock(decodedMutex);
+			uploadQueue.swap(decodedImages);
+		}
+		if (uploadQueue.empty()) break;
+
+		Rendering::DecodedImage& image = uploadQueue[nextUpload++];
+		Rendering::Texture* _;
+		if (!Rendering::Texture::CreateFromDecodedImage(image, _)) {
+			std::cout << "Unable to create texture from: " << image.ImageFilePath << std::endl;
+		}
+	} while (clock::now() < deadline);
+
+	if (pendingJobs > 0 || nextUpload < uploadQueue.size()) return true;
+	{
+		std::lock_guard lock(decodedMutex);
+		if (!decodedImages.empty()) return true;
+	}
+
+	// textures are done, resolve everything else one directory per call
+	const DirectoryRequest& request = directories[nextDirectory++];
+	Resources::LoadDirectory(request.Directory.c_str(), false, request.IncludeSubdirectories);
+	++completedSteps;
+
+	if (IsLoading()) return true;
+
+	directories.clear();
+	nextDirectory = 0;
+	totalSteps = completedSteps = 0;
+	completedJobs = 0;
+	return false;
+}
+
+void AssetLoader::Finish() {
+	while (Update(1000.0)) {
+		// help decoding instead of waiting for the workers
+		if (pendingJobs > 0 && !JobSystem::RunPendingJob()) std::this_thread::yield();
+	}
+}
+
+float AssetLoader::GetProgress() {
+	if (totalSteps == 0) return 1.0f;
+	return static_cast<float>(GetCompletedSteps()) / static_cast<float>(totalSteps);
+}
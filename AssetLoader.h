@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Texture.h"
+
+// Loads asset directories without blocking the main thread.
+// Texture asset files are read and decoded by JobSystem workers, Update uploads them to the GPU under a time budget.
+// Once all textures are uploaded, the queued directories are passed to Resources::LoadDirectory in order,
+// which loads textureSheets, tiles and creates meta files for new images.
+class AssetLoader {
+	struct DirectoryRequest {
+		std::string Directory;
+		bool IncludeSubdirectories;
+	};
+
+	inline static std::vector<DirectoryRequest> directories;
+	inline static size_t nextDirectory = 0;
+
+	// written by workers
+	inline static std::mutex decodedMutex;
+	inline static std::vector<Rendering::DecodedImage> decodedImages;
+	inline static std::atomic<size_t> pendingJobs = 0;
+	inline static std::atomic<size_t> completedJobs = 0;
+
+	// main thread only, swapped with decodedImages so workers are not blocked during uploads
+	inline static std::vector<Rendering::DecodedImage> uploadQueue;
+	inline static size_t nextUpload = 0;
+	inline static size_t totalSteps = 0;
+	inline static size_t completedSteps = 0;
+
+	static void ScheduleDecode(const std::string& absoluteAssetPath);
+
+public:
+	static void QueueDirectory(const char* directory, bool includeSubdirectories);
+
+	// Main thread, call once per frame. Returns true while assets are still loading.
+	static bool Update(double budgetMilliseconds);
+	// Blocks until everything queued is loaded
+	static void Finish();
+
+	static bool IsLoading() { return nextDirectory < directories.size(); }
+	// 0 to 1, decoded images and directory passes count as one step each
+	static float GetProgress();
+	static size_t GetCompletedSteps() { return completedSteps + completedJobs; }
+	static size_t GetTotalSteps() { return totalSteps; }
+};
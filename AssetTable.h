@@ -0,0 +1,102 @@
+#pragma once
+#include <utility>
+#include <vector>
+
+#include "AssetId.h"
+
+// Flat open addressing hash table keyed by AssetId, uses linear probing and backward shift deletion.
+// Empty AssetIds mark free slots and can not be stored.
+template<typename T>
+class AssetTable {
+	struct Slot {
+		AssetId Key;
+		T Value{};
+	};
+
+	std::vector<Slot> slots;
+	size_t count = 0;
+
+	size_t HomeIndex(const AssetId& key) const { return static_cast<size_t>(key.GetHashCode()) & (slots.size() - 1); }
+
+	// Index of the key or of the empty slot it would be inserted into
+	size_t Probe(const AssetId& key) const {
+		size_t index = HomeIndex(key);
+		while (!slots[index].Key.IsEmpty() && slots[index].Key != key) index = (index + 1) & (slots.size() - 1);
+		return index;
+	}
+
+	void Rehash(const size_t newCapacity) {
+		std::vector<Slot> oldSlots(newCapacity);
+		oldSlots.swap(slots);
+		for (auto& slot : oldSlots) {
+			if (slot.Key.IsEmpty()) continue;
+			slots[Probe(slot.Key)] = std::move(slot);
+		}
+	}
+
+public:
+	T* Find(const AssetId& key) {
+		if (count == 0 || key.IsEmpty()) return nullptr;
+		Slot& slot = slots[Probe(key)];
+		return slot.Key.IsEmpty() ? nullptr : &slot.Value;
+	}
+
+	const T* Find(const AssetId& key) const {
+		return const_cast<AssetTable*>(this)->Find(key);
+	}
+
+	bool Contains(const AssetId& key) const { return Find(key) != nullptr; }
+
+	// Returns the value of key, inserting a default value if it does not exist yet
+	T& operator[](const AssetId& key) {
+		if (key.IsEmpty()) throw std::exception("AssetTable can not store empty AssetIds");
+		// keep load factor at or below 1/2 so probe sequences stay short
+		if ((count + 1) * 2 > slots.size()) Rehash(slots.empty() ? 16 : slots.size() * 2);
+
+		Slot& slot = slots[Probe(key)];
+		if (slot.Key.IsEmpty()) {
+			slot.Key = key;
+			++count;
+		}
+		return slot.Value;
+	}
+
+	bool Erase(const AssetId& key) {
+		if (count == 0 || key.IsEmpty()) return false;
+		const size_t mask = slots.size() - 1;
+		size_t hole = Probe(key);
+		if (slots[hole].Key.IsEmpty()) return false;
+
+		// move following entries of the probe sequence back into the hole, so lookups never stop early
+		for (size_t next = (hole + 1) & mask; !slots[next].Key.IsEmpty(); next = (next + 1) & mask) {
+			const size_t home = HomeIndex(slots[next].Key);
+			const bool homeIsBetween = hole <= next ? hole < home && home <= next : hole < home || home <= next;
+			if (homeIsBetween) continue;
+			slots[hole] = std::move(slots[next]);
+			hole = next;
+		}
+		slots[hole] = Slot{};
+		--count;
+		return true;
+	}
+
+	void Clear() {
+		slots.clear();
+		count = 0;
+	}
+
+	size_t Size() const { return count; }
+	bool Empty() const { return count == 0; }
+
+	// func(const AssetId& key, T& value)
+	template<typename Func>
+	void ForEach(Func&& func) {
+		for (auto& slot : slots) if (!slot.Key.IsEmpty()) func(slot.Key, slot.Value);
+	}
+
+	// func(const AssetId& key, const T& value)
+	template<typename Func>
+	void ForEach(Func&& func) const {
+		for (const auto& slot : slots) if (!slot.Key.IsEmpty()) func(slot.Key, slot.Value);
+	}
+};
@@ -0,0 +1,260 @@
+#include "AssetWatcher.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "Files.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Resources.h"
+#include "TextureSheet.h"
+
+#include <Windows.h>
+
+namespace {
+	// textures before the textureSheets and tiles using them, tiles before prefabs
+	int GetReimportOrder(const AssetType type) {
+		switch (type) {
+			case AssetType::TextureInternal:
+			case AssetType::Texture: return 0;
+			case AssetType::TextureSheet: return 1;
+			case AssetType::Tile: return 2;
+			default: return 3;
+		}
+	}
+}
+
+bool AssetWatcher::Start(const std::vector<std::string>& directories) {
+	if (IsRunning()) return true;
+
+	watchedDirectories = directories;
+	stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+	if (stopEvent == nullptr) {
+		std::cout << "Unable to create asset watcher stop event, error: " << GetLastError() << std::endl;
+		return false;
+	}
+	watchThread = std::thread(WatchLoop);
+	return true;
+}
+
+void AssetWatcher::Stop() {
+	if (!IsRunning()) return;
+
+	SetEvent(stopEvent);
+	watchThread.join();
+	CloseHandle(stopEvent);
+	stopEvent = nullptr;
+
+	std::lock_guard lock(reimportMutex);
+	for (auto& reimport : reimports) free(reimport.Image.Data);
+	reimports.clear();
+}
+
+void AssetWatcher::WatchLoop() {
+	const std::filesystem::path root = std::filesystem::current_path();
+	HANDLE directory = CreateFileW(root.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+	                               OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+	if (directory == INVALID_HANDLE_VALUE) {
+		std::cout << "Unable to watch " << root.string() << " for changes, polling instead. error: " << GetLastError() << std::endl;
+		PollLoop();
+		return;
+	}
+
+	OVERLAPPED overlapped{};
+	overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+	const HANDLE events[] = { overlapped.hEvent, stopEvent };
+	// DWORD aligned, as ReadDirectoryChangesW requires
+	std::vector<DWORD> buffer(16 * 1024);
+	constexpr DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+	bool poll = false;
+	while (true) {
+		ResetEvent(overlapped.hEvent);
+		if (!ReadDirectoryChangesW(directory, buffer.data(), static_cast<DWORD>(buffer.size() * sizeof(DWORD)), TRUE, filter, nullptr, &overlapped, nullptr)) {
+			// network drives and some file systems do not support change notifications
+			std::cout << "Unable to watch " << root.string() << " for changes, polling instead. error: " << GetLastError() << std::endl;
+			poll = true;
+			break;
+		}
+
+		DWORD byteCount = 0;
+		if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0) {
+			// the buffer has to outlive the cancelled read
+			CancelIoEx(directory, &overlapped);
+			GetOverlappedResult(directory, &overlapped, &byteCount, TRUE);
+			break;
+		}
+		if (!GetOverlappedResult(directory, &overlapped, &byteCount, FALSE)) continue;
+		if (byteCount == 0) {
+			std::cout << "Too many file changes at once, some assets were not reloaded" << std::endl;
+			continue;
+		}
+
+		const auto* bytes = reinterpret_cast<const uint8_t*>(buffer.data());
+		for (size_t offset = 0;;) {
+			const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(bytes + offset);
+			// removed assets stay loaded until restart
+			if (info->Action != FILE_ACTION_REMOVED && info->Action != FILE_ACTION_RENAMED_OLD_NAME) {
+				OnFileChanged(root / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR)));
+			}
+			if (info->NextEntryOffset == 0) break;
+			offset += info->NextEntryOffset;
+		}
+	}
+
+	CloseHandle(overlapped.hEvent);
+	CloseHandle(directory);
+	if (poll) PollLoop();
+}
+
+void AssetWatcher::PollLoop() {
+	std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes;
+	bool isFirstScan = true;
+	do {
+		for (const auto& directory : watchedDirectories) {
+			std::error_code iteratorError;
+			for (auto it = std::filesystem::recursive_directory_iterator(Files::GetAbsolutePath(directory), iteratorError);
+			     !iteratorError && it != std::filesystem::recursive_directory_iterator(); it.increment(iteratorError)) {
+				// files may be removed while iterating
+				std::error_code error;
+				if (!it->is_regular_file(error)) continue;
+				const auto writeTime = it->last_write_time(error);
+				if (error) continue;
+
+				auto [entry, inserted] = writeTimes.try_emplace(it->path().string(), writeTime);
+				if (!inserted && entry->second == writeTime) continue;
+				entry->second = writeTime;
+				if (!isFirstScan) OnFileChanged(it->path());
+			}
+		}
+		isFirstScan = false;
+	} while (WaitForSingleObject(stopEvent, PollIntervalMilliseconds) == WAIT_TIMEOUT);
+}
+
+void AssetWatcher::OnFileChanged(const std::filesystem::path& absolutePath) {
+	const bool isWatched = std::any_of(watchedDirectories.begin(), watchedDirectories.end(), [&absolutePath](const std::string& directory) {
+		return Files::PathIsSubPathOf(absolutePath, Files::GetAbsolutePath(directory));
+	});
+	if (!isWatched) return;
+
+	std::lock_guard lock(changedMutex);
+	changedFiles[absolutePath.string()] = Clock::now();
+}
+
+void AssetWatcher::ScheduleReimport(const std::filesystem::path& absoluteAssetPath) {
+	++pendingJobs;
+	JobSystem::Schedule([absoluteAssetPath] {
+		PROFILE_SCOPE("AssetWatcher::Reimport");
+		Reimport reimport;
+		reimport.AbsoluteAssetPath = absoluteAssetPath;
+		bool success = AssetHeader::TryReadHeaderFromFile(absoluteAssetPath, &reimport.Header);
+		if (success) {
+			switch (reimport.Header.aType) {
+				case AssetType::TextureInternal:
+				case AssetType::Texture:
+					success = Rendering::Texture::DecodeFromAssetFile(absoluteAssetPath, reimport.Image);
+					break;
+				case AssetType::TextureSheet:
+					success = Rendering::TextureSheet::DecodeFromAssetFile(absoluteAssetPath, reimport.Image);
+					break;
+				case AssetType::Tile:
+				case AssetType::Prefab:
+					break;
+				default:
+					success = false;
+					break;
+			}
+		}
+
+		if (success) {
+			std::lock_guard lock(reimportMutex);
+			reimports.push_back(std::move(reimport));
+		}
+		else free(reimport.Image.Data);
+		--pendingJobs;
+	});
+}
+
+bool AssetWatcher::Apply(Reimport& reimport) {
+	const AssetHeader& header = reimport.Header;
+	Rendering::DecodedImage& image = reimport.Image;
+	switch (header.aType) {
+		case AssetType::TextureInternal:
+		case AssetType::Texture: {
+			Rendering::Texture* texture = nullptr;
+			if (!Resources::AssetIsLoaded(header.aId)) return Rendering::Texture::CreateFromDecodedImage(image, texture);
+
+			const bool found = image.IsInternal ? Resources::TryGetInternalTexture(image.ImageFilePath.c_str(), texture) : Resources::TryGetTexture(header.aId, texture);
+			if (!found) {
+				free(image.Data);
+				image.Data = nullptr;
+				return false;
+			}
+			texture->RefreshFromDecodedImage(image);
+			return true;
+		}
+		case AssetType::TextureSheet: {
+			Rendering::TextureSheet* textureSheet = nullptr;
+			if (Resources::TryGetTextureSheet(header.aId, textureSheet)) return textureSheet->Reload(reimport.AbsoluteAssetPath, image);
+
+			free(image.Data);
+			image.Data = nullptr;
+			return Resources::RefreshAsset(header);
+		}
+		default:
+			return Resources::RefreshAsset(header);
+	}
+}
+
+bool AssetWatcher::Update() {
+	if (!IsRunning()) return false;
+
+	std::vector<std::filesystem::path> settledFiles;
+	{
+		std::lock_guard lock(changedMutex);
+		const auto settleTime = Clock::now() - std::chrono::milliseconds(DebounceMilliseconds);
+		for (auto it = changedFiles.begin(); it != changedFiles.end();) {
+			if (it->second > settleTime) {
+				++it;
+				continue;
+			}
+			settledFiles.emplace_back(it->first);
+			it = changedFiles.erase(it);
+		}
+	}
+
+	bool reloaded = false;
+	for (const auto& path : settledFiles) {
+		// images are reimported through their meta file
+		if (AssetHeader::IsAssetFileExtension(path.extension().string())) {
+			ScheduleReimport(path);
+			continue;
+		}
+		const std::filesystem::path metaPath = path.string() + AssetHeader::FileExtension;
+		if (std::filesystem::exists(metaPath)) ScheduleReimport(metaPath);
+		else if (std::filesystem::is_regular_file(path) && Rendering::Texture::CanCreateFromPath(path.string().c_str())) {
+			// new image, creates its meta file the same way refreshing the directory does
+			Resources::LoadDirectory(Files::GetRelativePath(path.parent_path()).c_str(), false, false);
+			reloaded = true;
+		}
+	}
+
+	// applied together once all jobs are done, so assets are reloaded before the ones depending on them
+	if (pendingJobs > 0) return reloaded;
+	std::vector<Reimport> finished;
+	{
+		std::lock_guard lock(reimportMutex);
+		finished.swap(reimports);
+	}
+	if (finished.empty()) return reloaded;
+
+	PROFILE_SCOPE("AssetWatcher::Apply");
+	std::stable_sort(finished.begin(), finished.end(), [](const Reimport& a, const Reimport& b) {
+		return GetReimportOrder(a.Header.aType) < GetReimportOrder(b.Header.aType);
+	});
+	for (auto& reimport : finished) {
+		if (Apply(reimport)) reloaded = true;
+		else std::cout << "Unable to reload asset: " << reimport.AbsoluteAssetPath.string() << std::endl;
+	}
+	return reloaded;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Assets.h"
+#include "Texture.h"
+
+// Reloads assets whose files changed on disk, so edits made in other programs show up without refreshing directories.
+// A watcher thread collects changed files from ReadDirectoryChangesW, or by comparing write times if the directory can not be watched.
+// Files are reimported once they did not change for DebounceMilliseconds, since programs often write a file in several steps.
+// Asset files are read and images decoded by JobSystem workers, Update applies the results in place on the main thread.
+class AssetWatcher {
+	using Clock = std::chrono::steady_clock;
+
+	struct Reimport {
+		AssetHeader Header;
+		std::filesystem::path AbsoluteAssetPath;
+		// textures and textureSheets only
+		Rendering::DecodedImage Image;
+	};
+
+	// relative to the working directory
+	inline static std::vector<std::string> watchedDirectories;
+	inline static std::thread watchThread;
+	// signalled to stop the watcher thread
+	inline static void* stopEvent = nullptr;
+
+	// written by the watcher thread, absolute path to the time of its last change
+	inline static std::mutex changedMutex;
+	inline static std::unordered_map<std::string, Clock::time_point> changedFiles;
+
+	// written by workers
+	inline static std::mutex reimportMutex;
+	inline static std::vector<Reimport> reimports;
+	inline static std::atomic<size_t> pendingJobs = 0;
+
+	static void WatchLoop();
+	static void PollLoop();
+	static void OnFileChanged(const std::filesystem::path& absolutePath);
+	static void ScheduleReimport(const std::filesystem::path& absoluteAssetPath);
+	static bool Apply(Reimport& reimport);
+
+public:
+	static constexpr int DebounceMilliseconds = 250;
+	static constexpr int PollIntervalMilliseconds = 1000;
+
+	// Watches the directories including their subdirectories, paths are relative to the working directory
+	static bool Start(const std::vector<std::string>& directories);
+	// Call after JobSystem::Shutdown, frees reimports that were not applied
+	static void Stop();
+	static bool IsRunning() { return watchThread.joinable(); }
+
+	// Main thread, once per frame. Returns true if assets were reloaded, tileMaps and file browsers have to be refreshed then.
+	static bool Update();
+};
@@ -11,7 +11,8 @@ enum class AssetType {
 	Texture = 2,
 	TextureSheet = 3,
 	Tile = 4,
-	Level = 5
+	Level = 5,
+	Prefab = 6
 };
 
 class IPersistentAsset {
@@ -46,7 +47,8 @@ struct AssetHeader {
 			case AssetType::TextureInternal:
 			case AssetType::TextureSheet: return true;
 			case AssetType::Tile:
-			case AssetType::Level: return false;
+			case AssetType::Level:
+			case AssetType::Prefab: return false;
 			case AssetType::UNKNOWN:
 			default: throw std::exception("unhandled default case");
 		}
@@ -63,12 +65,14 @@ struct AssetHeader {
 				return ".tile";
 			case AssetType::Level:
 				return ".level";
+			case AssetType::Prefab:
+				return ".prefab";
 			default: throw std::exception("unhandled default case");
 		}
 	}
 
 	static bool IsAssetFileExtension(const std::string& extension) {
-		return extension == ".asset" || extension == ".tile" || extension == ".level";
+		return extension == ".asset" || extension == ".tile" || extension == ".level" || extension == ".prefab";
 	}
 
 	static bool TryReadHeaderFromFile(const std::filesystem::path& absolutePath, AssetHeader* out_header) {
@@ -0,0 +1,151 @@
+#include "AtlasPacker.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+Rendering::AtlasPacker::AtlasPacker(const int width, const int height, const int padding) : width(width), height(height), padding(padding) {
+	Reset();
+}
+
+void Rendering::AtlasPacker::Reset() {
+	skyline.clear();
+	skyline.push_back({ 0, 0, width });
+	freeRects.clear();
+	usedArea = 0;
+}
+
+int Rendering::AtlasPacker::Fit(const size_t nodeIndex, const int rectWidth, const int rectHeight) const {
+	const int x = skyline[nodeIndex].x;
+	if (x + rectWidth > width) return -1;
+
+	int y = skyline[nodeIndex].y;
+	int widthLeft = rectWidth;
+	for (size_t i = nodeIndex; widthLeft > 0; ++i) {
+		if (i >= skyline.size()) return -1;
+		y = std::max(y, skyline[i].y);
+		if (y + rectHeight > height) return -1;
+		widthLeft -= skyline[i].width;
+	}
+	return y;
+}
+
+void Rendering::AtlasPacker::AddSkylineLevel(const size_t nodeIndex, const int x, const int y, const int rectWidth, const int rectHeight) {
+	skyline.insert(skyline.begin() + nodeIndex, { x, y + rectHeight, rectWidth });
+
+	// shrink or remove the nodes now covered by the new one
+	for (size_t i = nodeIndex + 1; i < skyline.size(); ++i) {
+		const SkylineNode& previous = skyline[i - 1];
+		SkylineNode& node = skyline[i];
+		const int previousEnd = previous.x + previous.width;
+		if (node.x >= previousEnd) break;
+
+		const int shrink = previousEnd - node.x;
+		node.x += shrink;
+		node.width -= shrink;
+		if (node.width > 0) break;
+
+		skyline.erase(skyline.begin() + i);
+		--i;
+	}
+
+	// merge neighbouring nodes of equal height
+	for (size_t i = 0; i + 1 < skyline.size(); ++i) {
+		if (skyline[i].y != skyline[i + 1].y) continue;
+		skyline[i].width += skyline[i + 1].width;
+		skyline.erase(skyline.begin() + i + 1);
+		--i;
+	}
+}
+
+bool Rendering::AtlasPacker::TryPackFreeRect(const int paddedWidth, const int paddedHeight, glm::ivec2& out_paddedPosition) {
+	// smallest free rect that fits wins, ties go to the oldest
+	size_t bestIndex = freeRects.size();
+	int bestArea = INT_MAX;
+	for (size_t i = 0; i < freeRects.size(); ++i) {
+		const glm::ivec4& rect = freeRects[i];
+		if (rect.z < paddedWidth || rect.w < paddedHeight || rect.z * rect.w >= bestArea) continue;
+		bestArea = rect.z * rect.w;
+		bestIndex = i;
+	}
+	if (bestIndex == freeRects.size()) return false;
+
+	const glm::ivec4 rect = freeRects[bestIndex];
+	freeRects.erase(freeRects.begin() + bestIndex);
+	out_paddedPosition = glm::ivec2(rect.x, rect.y);
+
+	// guillotine split of the rest, the longer leftover side keeps the full extent of the free rect
+	const int rightWidth = rect.z - paddedWidth;
+	const int topHeight = rect.w - paddedHeight;
+	const bool splitHorizontally = rightWidth < topHeight;
+	if (rightWidth > 0) freeRects.emplace_back(rect.x + paddedWidth, rect.y, rightWidth, splitHorizontally ? paddedHeight : rect.w);
+	if (topHeight > 0) freeRects.emplace_back(rect.x, rect.y + paddedHeight, splitHorizontally ? rect.z : paddedWidth, topHeight);
+	return true;
+}
+
+bool Rendering::AtlasPacker::TryPack(const int rectWidth, const int rectHeight, glm::ivec2& out_position) {
+	const int paddedWidth = rectWidth + padding * 2;
+	const int paddedHeight = rectHeight + padding * 2;
+
+	if (glm::ivec2 paddedPosition; TryPackFreeRect(paddedWidth, paddedHeight, paddedPosition)) {
+		usedArea += static_cast<size_t>(paddedWidth) * paddedHeight;
+		out_position = paddedPosition + glm::ivec2(padding, padding);
+		return true;
+	}
+
+	int bestBottom = INT_MAX;
+	int bestWidth = INT_MAX;
+	size_t bestIndex = skyline.size();
+	glm::ivec2 bestPosition(0, 0);
+
+	// lowest resting position wins, ties go to the narrowest node so gaps get filled first
+	for (size_t i = 0; i < skyline.size(); ++i) {
+		const int y = Fit(i, paddedWidth, paddedHeight);
+		if (y < 0) continue;
+
+		const int bottom = y + paddedHeight;
+		if (bottom < bestBottom || (bottom == bestBottom && skyline[i].width < bestWidth)) {
+			bestBottom = bottom;
+			bestWidth = skyline[i].width;
+			bestIndex = i;
+			bestPosition = glm::ivec2(skyline[i].x, y);
+		}
+	}
+
+	if (bestIndex == skyline.size()) return false;
+
+	AddSkylineLevel(bestIndex, bestPosition.x, bestPosition.y, paddedWidth, paddedHeight);
+	usedArea += static_cast<size_t>(paddedWidth) * paddedHeight;
+	out_position = bestPosition + glm::ivec2(padding, padding);
+	return true;
+}
+
+void Rendering::AtlasPacker::Release(const glm::ivec2& position, const int rectWidth, const int rectHeight) {
+	const int paddedWidth = rectWidth + padding * 2;
+	const int paddedHeight = rectHeight + padding * 2;
+	usedArea -= std::min(usedArea, static_cast<size_t>(paddedWidth) * paddedHeight);
+	if (usedArea == 0) {
+		Reset();
+		return;
+	}
+	freeRects.emplace_back(position - glm::ivec2(padding, padding), paddedWidth, paddedHeight);
+}
+
+void Rendering::AtlasPacker::ExtrudeImage(const unsigned char* rgbaPixels, const int imageWidth, const int imageHeight, const int padding, std::vector<unsigned char>& out_pixels) {
+	constexpr int pixelSize = 4;
+	const int paddedWidth = imageWidth + padding * 2;
+	const int paddedHeight = imageHeight + padding * 2;
+	out_pixels.resize(static_cast<size_t>(paddedWidth) * paddedHeight * pixelSize);
+
+	for (int y = 0; y < paddedHeight; ++y) {
+		const int srcY = std::clamp(y - padding, 0, imageHeight - 1);
+		const unsigned char* srcRow = rgbaPixels + static_cast<size_t>(srcY) * imageWidth * pixelSize;
+		unsigned char* dstRow = out_pixels.data() + static_cast<size_t>(y) * paddedWidth * pixelSize;
+
+		memcpy(dstRow + padding * pixelSize, srcRow, static_cast<size_t>(imageWidth) * pixelSize);
+		for (int x = 0; x < padding; ++x) {
+			memcpy(dstRow + x * pixelSize, srcRow, pixelSize);
+			memcpy(dstRow + (padding + imageWidth + x) * pixelSize, srcRow + (imageWidth - 1) * pixelSize, pixelSize);
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace Rendering {
+	// Skyline bottom-left rectangle packer. Pure CPU and deterministic: the same sequence of requests always yields the same placements.
+	// Released rects are kept in a free list and handed out again before the skyline grows.
+	class AtlasPacker {
+		struct SkylineNode {
+			int x;
+			int y;
+			int width;
+		};
+
+		int width;
+		int height;
+		int padding;
+		size_t usedArea = 0;
+		std::vector<SkylineNode> skyline;
+		// padded rects given back by Release, xy = position, zw = size
+		std::vector<glm::ivec4> freeRects;
+
+		// Returns y position the rect would rest on when placed at node index, -1 if it does not fit
+		int Fit(size_t nodeIndex, int rectWidth, int rectHeight) const;
+		void AddSkylineLevel(size_t nodeIndex, int x, int y, int rectWidth, int rectHeight);
+		bool TryPackFreeRect(int paddedWidth, int paddedHeight, glm::ivec2& out_paddedPosition);
+	public:
+		AtlasPacker(int width, int height, int padding);
+
+		// out_position is the position of the unpadded rect, padding is reserved around it on every side
+		bool TryPack(int rectWidth, int rectHeight, glm::ivec2& out_position);
+		// Gives back a rect returned by TryPack, the whole page is reset once nothing is left on it
+		void Release(const glm::ivec2& position, int rectWidth, int rectHeight);
+		void Reset();
+
+		int GetWidth() const { return width; }
+		int GetHeight() const { return height; }
+		int GetPadding() const { return padding; }
+		float GetOccupancy() const { return static_cast<float>(usedArea) / static_cast<float>(width * height); }
+
+		// Copies a tightly packed rgba image into a buffer that is padding pixels larger on every side, repeating the edge pixels outwards
+		static void ExtrudeImage(const unsigned char* rgbaPixels, int imageWidth, int imageHeight, int padding, std::vector<unsigned char>& out_pixels);
+	};
+}
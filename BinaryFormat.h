@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+
+// Fixed-width little-endian helpers for the binary asset formats.
+// Scalars are assembled byte by byte, bulk blocks are copied as-is since every platform we build for is little-endian.
+namespace Serialization {
+	template<typename T>
+	void WriteLittleEndian(std::ostream& oStream, const T value) {
+		static_assert(std::is_integral_v<T>, "only integral values have a fixed byte order");
+		using UnsignedT = std::make_unsigned_t<T>;
+		const auto bits = static_cast<UnsignedT>(value);
+		char bytes[sizeof(T)];
+		for (size_t i = 0; i < sizeof(T); ++i) {
+			bytes[i] = static_cast<char>((bits >> (i * 8)) & 0xFF);
+		}
+		oStream.write(bytes, sizeof(T));
+	}
+
+	inline void WriteString32(std::ostream& oStream, const std::string& str) {
+		WriteLittleEndian(oStream, static_cast<uint32_t>(str.size()));
+		oStream.write(str.data(), static_cast<std::streamsize>(str.size()));
+	}
+
+	inline void WriteBlock(std::ostream& oStream, const void* data, const size_t byteSize) {
+		oStream.write(static_cast<const char*>(data), static_cast<std::streamsize>(byteSize));
+	}
+
+	// Reads from a memory range, any read past the end fails and leaves the reader in a failed state.
+	class BinaryReader {
+		const uint8_t* data;
+		size_t size;
+		size_t offset = 0;
+		bool failed = false;
+
+	public:
+		BinaryReader(const void* data, const size_t size) : data(static_cast<const uint8_t*>(data)), size(size) {}
+
+		template<typename T>
+		bool Read(T& out_value) {
+			static_assert(std::is_integral_v<T>, "only integral values have a fixed byte order");
+			const uint8_t* bytes = ReadBlock(sizeof(T));
+			if (bytes == nullptr) return false;
+			std::make_unsigned_t<T> bits = 0;
+			for (size_t i = 0; i < sizeof(T); ++i) {
+				bits |= static_cast<std::make_unsigned_t<T>>(bytes[i]) << (i * 8);
+			}
+			out_value = static_cast<T>(bits);
+			return true;
+		}
+
+		bool ReadString32(std::string& out_string, const uint32_t stringSizeCap = 2048) {
+			uint32_t length = 0;
+			if (!Read(length)) return false;
+			if (length > stringSizeCap) {
+				failed = true;
+				return false;
+			}
+			const uint8_t* chars = ReadBlock(length);
+			if (chars == nullptr) return false;
+			out_string.assign(reinterpret_cast<const char*>(chars), length);
+			return true;
+		}
+
+		// Returns pointer into the underlying memory, nullptr if fewer than byteSize bytes remain
+		const uint8_t* ReadBlock(const size_t byteSize) {
+			if (failed || size - offset < byteSize) {
+				failed = true;
+				return nullptr;
+			}
+			const uint8_t* block = data + offset;
+			offset += byteSize;
+			return block;
+		}
+
+		bool ReadBlock(void* destination, const size_t byteSize) {
+			const uint8_t* block = ReadBlock(byteSize);
+			if (block == nullptr) return false;
+			memcpy(destination, block, byteSize);
+			return true;
+		}
+
+		size_t GetOffset() const { return offset; }
+		size_t GetRemaining() const { return size - offset; }
+		bool HasFailed() const { return failed; }
+	};
+
+	// Lets std::istream based deserialization read from a memory mapped file without copying it
+	class MemoryStreamBuffer : public std::streambuf {
+	public:
+		MemoryStreamBuffer(const void* data, const size_t size) {
+			char* begin = const_cast<char*>(static_cast<const char*>(data));
+			setg(begin, begin, begin + size);
+		}
+
+		size_t GetPosition() const { return static_cast<size_t>(gptr() - eback()); }
+	};
+}
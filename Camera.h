@@ -2,6 +2,7 @@
 
 #include "Input.h"
 
+#include <cfloat>
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -364,6 +365,10 @@ namespace Rendering {
 			return &projectionMatrix;
 		}
 
+		Frustum GetFrustum() {
+			return Frustum(projectionMatrix * *GetViewMatrix());
+		}
+
 		Ray ScreenPointToRay(int x_pos, int y_pos) const {
 			// is NOT accurate in 3D!
 			const mat inverseMat = inverse(projectionMatrix * viewMat);
@@ -410,6 +415,53 @@ namespace Rendering {
 			return collisionPoint;
 		}
 
+		// Inverse of ScreenToGridPosition, y is 0 at the bottom of the screen
+		vec2 GridToScreenPosition(const vec2 gridPos) const {
+			const vec4 clip = projectionMatrix * viewMat * vec4(gridPos, 0, 1);
+			const vec2 normalized = (vec2(clip) / clip.w + vec2(1.0f)) * 0.5f;
+			return normalized * vec2(width, height);
+		}
+
+		// Grid cells covered by the part of the view frustum that crosses the grid plane.
+		// Corner rays that miss the plane, like the upper ones of a tilted perspective view, end at the far clipping plane.
+		// out_min is greater than out_max if the grid plane is not visible at all.
+		void GetVisibleGridBounds(ivec2& out_min, ivec2& out_max) const {
+			const mat inverseMat = inverse(projectionMatrix * viewMat);
+			// bit 0, 1 and 2 of the index select the right, top and far side
+			vec3 corners[8];
+			for (int i = 0; i < 8; ++i) {
+				const vec4 corner = inverseMat * vec4(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f, 1.0f);
+				corners[i] = vec3(corner) / corner.w;
+			}
+
+			// the visible part of the grid plane is bounded by where the frustum edges cross it
+			vec2 minPos(FLT_MAX);
+			vec2 maxPos(-FLT_MAX);
+			const auto include = [&](const vec3 point) {
+				minPos = min(minPos, vec2(point));
+				maxPos = max(maxPos, vec2(point));
+			};
+			for (int a = 0; a < 8; ++a) {
+				for (int side = 1; side < 8; side <<= 1) {
+					if (a & side) continue;
+					const vec3 from = corners[a];
+					const vec3 to = corners[a | side];
+					if (from.z == 0.0f) include(from);
+					if (to.z == 0.0f) include(to);
+					if ((from.z < 0.0f) == (to.z < 0.0f) || from.z == 0.0f || to.z == 0.0f) continue;
+					include(from + (to - from) * (from.z / (from.z - to.z)));
+				}
+			}
+
+			if (minPos.x > maxPos.x) {
+				out_min = ivec2(0);
+				out_max = ivec2(-1);
+				return;
+			}
+			out_min = ivec2(floor(minPos));
+			out_max = ivec2(floor(maxPos));
+		}
+
 		vec3 ScreenToWorldCoordinatesDepth(int x_pos, int y_pos, int z_pos) const {
 			const mat inverseMat = inverse(projectionMatrix * viewMat);
 
@@ -9,7 +9,9 @@
 #include "Strings.h"
 #include "Texture.h"
 #include "TextureSheet.h"
+#include "ThumbnailCache.h"
 #include "Tile.h"
+#include "Prefab.h"
 
 
 FileBrowser::FileBrowser(const char* start_directory, std::string title, std::function<void(FileBrowserFile&)> onFileClick,
@@ -33,7 +35,42 @@ FileBrowser::FileBrowser(const char* start_directory, std::string title, std::fu
 	RefreshCurrentDirectory();
 }
 
-bool DrawFileButton(const Rendering::Texture* texture, const int elementCount, const std::string& name, const std::string& description, const int size, bool shouldHighlight = false, const FileBrowserFile* file = nullptr, bool* out_rightClicked = nullptr) {
+struct FileIcon {
+	ImTextureID TextureId = nullptr;
+	// textures are stored bottom row first
+	ImVec2 Uv0 = ImVec2(0, 1);
+	ImVec2 Uv1 = ImVec2(1, 0);
+
+	FileIcon(const Rendering::Texture* texture) : TextureId(reinterpret_cast<ImTextureID>(texture->GetTextureID())) {
+		ImGuiHelper::GetImageUvs(texture, Uv0, Uv1);
+	}
+	FileIcon(const Rendering::Thumbnail& thumbnail) : TextureId(reinterpret_cast<ImTextureID>(thumbnail.TextureId)),
+		Uv0(thumbnail.UvMin.x, thumbnail.UvMin.y), Uv1(thumbnail.UvMax.x, thumbnail.UvMax.y) {}
+};
+
+// Textures and textureSheets are listed without loading them, they are loaded once used
+bool LoadFileData(FileBrowserFile& file) {
+	if (file.Data != nullptr) return true;
+	if (!Resources::LoadAsset(file.AssetHeader)) return false;
+	switch (file.AssetHeader.aType) {
+		case AssetType::Texture:
+		{
+			Rendering::Texture* texture = nullptr;
+			if (Resources::TryGetTexture(file.AssetHeader.aId, texture)) file.Data = texture;
+			break;
+		}
+		case AssetType::TextureSheet:
+		{
+			Rendering::TextureSheet* textureSheet = nullptr;
+			if (Resources::TryGetTextureSheet(file.AssetHeader.aId, textureSheet)) file.Data = textureSheet;
+			break;
+		}
+		default: break;
+	}
+	return file.Data != nullptr;
+}
+
+bool DrawFileButton(const FileIcon& icon, const int elementCount, const std::string& name, const std::string& description, const int size, bool shouldHighlight = false, FileBrowserFile* file = nullptr, bool* out_rightClicked = nullptr) {
 	using namespace ImGui;
 
 	ImVec2 startPos = GetCursorStartPos();
@@ -48,7 +85,7 @@ bool DrawFileButton(const Rendering::Texture* texture, const int elementCount, c
 	SetCursorPos(IconDrawPos);
 	PushID(name.c_str());
 	if (shouldHighlight) ImGui::PushStyleColor(ImGuiCol_Button, (ImVec4)ImColor(255, 255, 255));
-	const bool clicked = ImageButton(reinterpret_cast<void*>(texture->GetTextureID()), ImVec2(iconSideLength, iconSideLength), ImVec2(0, 1), ImVec2(1, 0));
+	const bool clicked = ImageButton(icon.TextureId, ImVec2(iconSideLength, iconSideLength), icon.Uv0, icon.Uv1);
 	const bool wasRightClicked = IsItemClicked(ImGuiMouseButton_Right);
 
 	if (wasRightClicked && out_rightClicked != nullptr) {
@@ -61,22 +98,21 @@ bool DrawFileButton(const Rendering::Texture* texture, const int elementCount, c
 		(file->AssetHeader.aType == AssetType::Texture || file->AssetHeader.aType == AssetType::TextureSheet);
 	if (allowDragAndDrop) {
 		if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_None)) {
-			std::string payloadType;
-			void* payload = nullptr;
-			switch (file->AssetHeader.aType) {
-				case AssetType::Texture:
-					payloadType = "Texture";
-					payload = (void*)texture;
-					break;
-				case AssetType::TextureSheet:
-					payloadType = "TextureSheet";
-					payload = file->Data;
-					break;
-				default:
-					throw std::exception("unexpected file type for drag and drop", static_cast<int>(file->AssetHeader.aType));
+			if (LoadFileData(*file)) {
+				const char* payloadType = nullptr;
+				switch (file->AssetHeader.aType) {
+					case AssetType::Texture:
+						payloadType = "Texture";
+						break;
+					case AssetType::TextureSheet:
+						payloadType = "TextureSheet";
+						break;
+					default:
+						throw std::exception("unexpected file type for drag and drop", static_cast<int>(file->AssetHeader.aType));
+				}
+				ImGui::SetDragDropPayload(payloadType, &file->Data, sizeof(void*));
 			}
-			ImGui::SetDragDropPayload(payloadType.c_str(), &payload, sizeof(void*));
-			ImGuiHelper::Image(texture->GetTextureID());
+			ImGui::Image(icon.TextureId, ImVec2(32, 32), icon.Uv0, icon.Uv1);
 			TextUnformatted(file->AssetHeader.relativeAssetPath.filename().string().c_str());
 			ImGui::EndDragDropSource();
 		}
@@ -128,12 +164,15 @@ void FileBrowser::RenderImGuiWindow() {
 			const std::string currButton = imguiID + "_Items_" + std::to_string(buttonIndex);
 			const bool highlight = shouldHighlight == nullptr ? false : shouldHighlight(file);
 			bool wasRightClicked = false;
-			if (DrawFileButton(file.Texture, buttonIndex, currButton, file.AssetHeader.relativeAssetPath.filename().string(), buttonSize, highlight, &file, &wasRightClicked)) {
-				if (onFileClick != nullptr)
+			Rendering::Thumbnail thumbnail;
+			const FileIcon icon = !file.ThumbnailImagePath.empty() && Rendering::ThumbnailCache::TryGetThumbnail(file.ThumbnailImagePath, thumbnail)
+				? FileIcon(thumbnail) : FileIcon(file.Texture);
+			if (DrawFileButton(icon, buttonIndex, currButton, file.AssetHeader.relativeAssetPath.filename().string(), buttonSize, highlight, &file, &wasRightClicked)) {
+				if (onFileClick != nullptr && LoadFileData(file))
 					onFileClick(file);
 			}
 			if (wasRightClicked) {
-				if (onFileEdit != nullptr)
+				if (onFileEdit != nullptr && LoadFileData(file))
 					onFileEdit(file);
 			}
 			++buttonIndex;
@@ -157,7 +196,7 @@ void FileBrowser::RefreshCurrentDirectory() {
 	currentSubFolders.clear();
 
 	std::vector<AssetHeader> headers;
-	Resources::LoadDirectory(currentDirectory.string().c_str(), false, false, &headers);
+	Resources::LoadDirectory(currentDirectory.string().c_str(), false, false, &headers, false);
 	for (auto& dirEntry : Files::GetDirectoryIterator(currentDirectory.string().c_str())) {
 		if (dirEntry.is_directory()) {
 			currentSubFolders.push_back(dirEntry);
@@ -171,9 +210,9 @@ void FileBrowser::RefreshCurrentDirectory() {
 		switch (header.aType) {
 			case AssetType::Texture:
 			{
-				if (Resources::TryGetTexture(header.aId, fileBrowserFile.Texture)) {
-					fileBrowserFile.Data = fileBrowserFile.Texture;
-				}
+				if (Rendering::Texture* texture; Resources::TryGetTexture(header.aId, texture)) fileBrowserFile.Data = texture;
+				fileBrowserFile.ThumbnailImagePath = header.GetCorrespondingFilePath();
+				Rendering::ThumbnailCache::Refresh(fileBrowserFile.ThumbnailImagePath);
 				break;
 			}
 			case AssetType::Tile:
@@ -191,15 +230,22 @@ void FileBrowser::RefreshCurrentDirectory() {
 			}
 			case AssetType::TextureSheet:
 			{
-				Rendering::TextureSheet* textureSheet;
-				if (!Resources::TryGetTextureSheet(header.aId, textureSheet)) {
-					std::cout << "ERROR: Unable to get textureSheet: " << header.relativeAssetPath.string().c_str() << std::endl;
+				if (Rendering::TextureSheet* textureSheet; Resources::TryGetTextureSheet(header.aId, textureSheet)) fileBrowserFile.Data = textureSheet;
+				fileBrowserFile.ThumbnailImagePath = header.GetCorrespondingFilePath();
+				Rendering::ThumbnailCache::Refresh(fileBrowserFile.ThumbnailImagePath);
+				break;
+			}
+			case AssetType::Prefab:
+			{
+				Tiles::Prefab* prefab = nullptr;
+				if (!Resources::TryGetPrefab(header.aId, prefab)) {
+					std::cout << "ERROR: Unable to get prefab: " << header.relativeAssetPath.string().c_str() << std::endl;
 					continue;
 				}
-				if (const auto mainTex = textureSheet->GetMainTexture(); mainTex != nullptr) {
-					fileBrowserFile.Texture = mainTex;
+				fileBrowserFile.Data = prefab;
+				if (const Tiles::Tile* displayTile = prefab->GetDisplayTile(); displayTile != nullptr) {
+					Resources::TryGetTexture(displayTile->DisplayTexture, fileBrowserFile.Texture);
 				}
-				fileBrowserFile.Data = textureSheet;
 				break;
 			}
 			case AssetType::Level: break;
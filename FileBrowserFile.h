@@ -12,6 +12,8 @@ public:
 	FileBrowserFile(::AssetHeader header, FileBrowser* fileBrowser) : AssetHeader(std::move(header)), FileBrowser(fileBrowser) { }
 
 	Rendering::Texture* Texture = nullptr;
+	// textures and textureSheets are drawn from the thumbnail of this image instead of Texture
+	std::string ThumbnailImagePath;
 	FileBrowser* FileBrowser = nullptr;
 };
 
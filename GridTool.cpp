@@ -4,9 +4,12 @@
 #include "GridTool.h"
 
 #include "TileMap.h"
+#include <algorithm>
 #include <iostream>
 
 #include "Tile.h"
+#include "Camera.h"
+#include "Prefab.h"
 
 
 namespace GridTools {
@@ -37,17 +40,189 @@ namespace GridTools {
 		return false;
 	}
 
-	bool SelectTool::OnInteract(const InputMouseEvent* event, const glm::ivec2& position, bool& isStale) {
-		if (event->GetMouseKeyHold(MouseButton::Left) && !isStale) {
-			TileInstance* ti;
-			if (!toolBar->activeTileMap->TryGetTile(position, ti)) {
-				isStale = true;
+	bool FillTool::OnInteract(const InputMouseEvent* event, const glm::ivec2& position, bool& isStale) {
+		if (!event->GetMouseKeyDown(MouseButton::Left)) return false;
+
+		const Tile* tile = toolBar->GetSelectedTile();
+		if (tile == nullptr) {
+			std::cout << "Selected Tile is NULL!" << std::endl;
+			return false;
+		}
+		glm::ivec2 boundsMin, boundsMax;
+		Rendering::Camera::Main->GetVisibleGridBounds(boundsMin, boundsMax);
+		isStale = true;
+		return toolBar->activeTileMap->FloodFill(tile, position, boundsMin, boundsMax, toolBar->MaxFillArea) > 0;
+	}
+
+	std::vector<glm::ivec2> ShapeTool::GetShapeCells(const TileMap* tileMap, const glm::ivec2 end, const bool visibleOnly) const {
+		// shapes are rasterized in cells of GridDimensions
+		const glm::ivec2 dims = tileMap->GridDimensions;
+		const glm::ivec2 start = tileMap->ConvertToTileMapGridPosition(anchor) / dims;
+		const glm::ivec2 stop = tileMap->ConvertToTileMapGridPosition(end) / dims;
+		const glm::ivec2 minCell = glm::min(start, stop);
+		const glm::ivec2 maxCell = glm::max(start, stop);
+
+		glm::ivec2 clipMin(INT_MIN);
+		glm::ivec2 clipMax(INT_MAX);
+		if (visibleOnly) {
+			Rendering::Camera::Main->GetVisibleGridBounds(clipMin, clipMax);
+			clipMin = tileMap->ConvertToTileMapGridPosition(clipMin) / dims;
+			clipMax = tileMap->ConvertToTileMapGridPosition(clipMax) / dims;
+		}
+		const glm::ivec2 visibleMin = glm::max(minCell, clipMin);
+		const glm::ivec2 visibleMax = glm::min(maxCell, clipMax);
+
+		std::vector<glm::ivec2> cells;
+		// every shape lies within its bounding rectangle
+		if (glm::any(glm::greaterThan(visibleMin, visibleMax))) return cells;
+		switch (mode) {
+			case ShapeMode::FilledRectangle:
+				cells.reserve(static_cast<size_t>(visibleMax.x - visibleMin.x + 1) * (visibleMax.y - visibleMin.y + 1));
+				for (int y = visibleMin.y; y <= visibleMax.y; ++y) {
+					for (int x = visibleMin.x; x <= visibleMax.x; ++x) cells.emplace_back(x, y);
+				}
+				break;
+			case ShapeMode::OutlinedRectangle:
+				for (int x = visibleMin.x; x <= visibleMax.x; ++x) {
+					if (minCell.y == visibleMin.y) cells.emplace_back(x, minCell.y);
+					if (maxCell.y != minCell.y && maxCell.y == visibleMax.y) cells.emplace_back(x, maxCell.y);
+				}
+				for (int y = std::max(minCell.y + 1, visibleMin.y); y <= std::min(maxCell.y - 1, visibleMax.y); ++y) {
+					if (minCell.x == visibleMin.x) cells.emplace_back(minCell.x, y);
+					if (maxCell.x != minCell.x && maxCell.x == visibleMax.x) cells.emplace_back(maxCell.x, y);
+				}
+				break;
+			case ShapeMode::Line: {
+				// Bresenham
+				const glm::ivec2 delta(abs(stop.x - start.x), -abs(stop.y - start.y));
+				const glm::ivec2 step(start.x < stop.x ? 1 : -1, start.y < stop.y ? 1 : -1);
+				int error = delta.x + delta.y;
+				glm::ivec2 cell = start;
+				while (true) {
+					if (glm::all(glm::greaterThanEqual(cell, clipMin)) && glm::all(glm::lessThanEqual(cell, clipMax))) cells.push_back(cell);
+					if (cell == stop) break;
+					const int doubledError = 2 * error;
+					if (doubledError >= delta.y) {
+						error += delta.y;
+						cell.x += step.x;
+					}
+					if (doubledError <= delta.x) {
+						error += delta.x;
+						cell.y += step.y;
+					}
+				}
+				break;
+			}
+		}
+		for (auto& cell : cells) cell *= dims;
+		return cells;
+	}
+
+	void ShapeTool::Cancel() {
+		isDragging = false;
+		toolBar->Preview.Clear();
+	}
+
+	bool ShapeTool::OnInteract(const InputMouseEvent* event, const glm::ivec2& position, bool& isStale) {
+		const Tile* tile = toolBar->GetSelectedTile();
+		TileMap* tileMap = toolBar->activeTileMap;
+		if (event->GetMouseKeyDown(MouseButton::Left)) {
+			if (tile == nullptr) {
+				std::cout << "Selected Tile is NULL!" << std::endl;
 				return false;
 			}
-			Tile* parent = const_cast<Tile*>(ti->GetParent());
-			toolBar->SetSelectedTile(parent);
+			isDragging = true;
+			anchor = position;
+			lastEnd = glm::ivec2(INT_MAX);
+		}
+		if (!isDragging) return false;
+		if (tile == nullptr) {
+			Cancel();
+			return false;
+		}
+
+		if (event->GetMouseKeyHold(MouseButton::Left)) {
+			// the preview only holds the part of the shape in view
+			glm::ivec2 visibleMin, visibleMax;
+			Rendering::Camera::Main->GetVisibleGridBounds(visibleMin, visibleMax);
+			if (position != lastEnd || visibleMin != lastVisibleMin || visibleMax != lastVisibleMax) {
+				lastEnd = position;
+				lastVisibleMin = visibleMin;
+				lastVisibleMax = visibleMax;
+				std::vector<PreviewCell> cells;
+				for (const auto& cell : GetShapeCells(tileMap, position, true)) cells.push_back({ cell, tile });
+				toolBar->Preview.Set(std::move(cells), tileMap->TileDimensions);
+			}
+			return false;
+		}
+
+		// released, the full shape is placed up to the last previewed end and autotiling runs once for all of it
+		const glm::ivec2 end = lastEnd == glm::ivec2(INT_MAX) ? position : lastEnd;
+		tileMap->BeginEdit();
+		for (const auto& cell : GetShapeCells(tileMap, end, false)) tileMap->SetTile(tile, cell);
+		tileMap->CommitEdit();
+		Cancel();
+		isStale = true;
+		return true;
+	}
+
+	void StampTool::OnSelect() {
+		// forces a preview of the current clipboard on the next interaction
+		lastPosition = glm::ivec2(INT_MAX);
+		toolBar->Preview.Clear();
+	}
+
+	void StampTool::OnDeselect() {
+		toolBar->Preview.Clear();
+	}
+
+	bool StampTool::OnInteract(const InputMouseEvent* event, const glm::ivec2& position, bool& isStale) {
+		const Prefab& clipboard = toolBar->Clipboard;
+		TileMap* tileMap = toolBar->activeTileMap;
+		if (clipboard.IsEmpty()) return false;
+
+		if (position != lastPosition) {
+			lastPosition = position;
+			// same placement as TileMap::PasteRegion
+			const glm::ivec2 dims = tileMap->GridDimensions;
+			const glm::ivec2 origin = tileMap->ConvertToTileMapGridPosition(position) / dims;
+			std::vector<PreviewCell> cells;
+			for (int y = 0; y < clipboard.Size.y; ++y) {
+				for (int x = 0; x < clipboard.Size.x; ++x) {
+					const uint16_t index = clipboard.TileIndices[clipboard.GetCellIndex(glm::ivec2(x, y))];
+					if (index != 0) cells.push_back({ (origin + glm::ivec2(x, y)) * dims, clipboard.Palette[index] });
+				}
+			}
+			toolBar->Preview.Set(std::move(cells), tileMap->TileDimensions);
+		}
+
+		if (event->GetMouseKeyDown(MouseButton::Left) && !isStale) {
+			tileMap->PasteRegion(clipboard, position);
 			isStale = true;
+			return true;
+		}
+		return false;
+	}
+
+	bool SelectTool::OnInteract(const InputMouseEvent* event, const glm::ivec2& position, bool& isStale) {
+		if (event->GetMouseKeyDown(MouseButton::Left)) {
+			isDragging = true;
+			anchor = position;
+			toolBar->ClearSelection();
+
+			TileInstance ti;
+			if (toolBar->activeTileMap->TryGetTile(position, ti)) {
+				Tile* parent = const_cast<Tile*>(ti.GetParent());
+				toolBar->SetSelectedTile(parent);
+			}
+			isStale = true;
+		}
+
+		if (isDragging && event->GetMouseKeyHold(MouseButton::Left)) {
+			if (position != anchor) toolBar->SetSelection(anchor, position);
+			return false;
 		}
+		isDragging = false;
 		return false;
 	}
 }
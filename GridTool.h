@@ -1,4 +1,6 @@
 #pragma once
+#include <vector>
+#include <glm/vec2.hpp>
 
 class InputMouseEvent;
 namespace GridTools {
@@ -34,7 +36,61 @@ namespace GridTools {
 		bool OnInteract(const InputMouseEvent* event, const glm::ivec2& position, bool& isStale) override;
 	};
 
+	// Fills the connected empty or same tile region under the cursor with the selected tile
+	class FillTool : public GridTool {
+	public:
+		explicit FillTool(GridToolBar* gridToolBar) : GridTool(gridToolBar) {}
+
+		void OnSelect() override {}
+		void OnDeselect() override {}
+		bool OnInteract(const InputMouseEvent* event, const glm::ivec2& position, bool& isStale) override;
+	};
+
+	enum class ShapeMode {
+		FilledRectangle,
+		OutlinedRectangle,
+		Line
+	};
+
+	// Drags out a shape from the press to the release position. Only a preview is shown while dragging,
+	// all cells are placed in one batched edit on release.
+	class ShapeTool : public GridTool {
+		ShapeMode mode;
+		bool isDragging = false;
+		glm::ivec2 anchor{};
+		glm::ivec2 lastEnd{};
+		glm::ivec2 lastVisibleMin{};
+		glm::ivec2 lastVisibleMax{};
+
+		// Grid positions of the shape from anchor to end, visibleOnly leaves out cells outside the camera's view
+		std::vector<glm::ivec2> GetShapeCells(const TileMap* tileMap, glm::ivec2 end, bool visibleOnly) const;
+		void Cancel();
+
+	public:
+		ShapeTool(GridToolBar* gridToolBar, const ShapeMode mode) : GridTool(gridToolBar), mode(mode) {}
+
+		void OnSelect() override {}
+		void OnDeselect() override { Cancel(); }
+		bool OnInteract(const InputMouseEvent* event, const glm::ivec2& position, bool& isStale) override;
+	};
+
+	// Pastes the toolBar's clipboard with its bottom left corner at the cursor
+	class StampTool : public GridTool {
+		glm::ivec2 lastPosition{};
+
+	public:
+		explicit StampTool(GridToolBar* gridToolBar) : GridTool(gridToolBar) {}
+
+		void OnSelect() override;
+		void OnDeselect() override;
+		bool OnInteract(const InputMouseEvent* event, const glm::ivec2& position, bool& isStale) override;
+	};
+
+	// Clicking picks the tile under the cursor, dragging selects a region
 	class SelectTool : public GridTool {
+		bool isDragging = false;
+		glm::ivec2 anchor{};
+
 	public:
 		explicit SelectTool(GridToolBar* gridToolBar) : GridTool(gridToolBar) {}
 		void OnSelect() override {}
@@ -5,6 +5,8 @@
 #include "Camera.h"
 #include "GridTool.h"
 #include "Input.h"
+#include "TileEditHistory.h"
+#include "TileMap.h"
 
 namespace GridTools {
 
@@ -12,7 +14,12 @@ namespace GridTools {
 		tools = {
 			{GridToolType::Place, new PlacerTool(this)},
 			{GridToolType::Erase, new EraserTool(this)},
-			{GridToolType::Select, new class SelectTool(this)}
+			{GridToolType::Select, new class SelectTool(this)},
+			{GridToolType::Fill, new FillTool(this)},
+			{GridToolType::Rectangle, new ShapeTool(this, ShapeMode::FilledRectangle)},
+			{GridToolType::RectangleOutline, new ShapeTool(this, ShapeMode::OutlinedRectangle)},
+			{GridToolType::Line, new ShapeTool(this, ShapeMode::Line)},
+			{GridToolType::Stamp, new StampTool(this)}
 		};
 	}
 
@@ -45,8 +52,14 @@ namespace GridTools {
 		const auto gridPos = GetMouseGridPos();
 		if (gridPos != lastMouseGridPos) isStale = false;
 
+		// shape tools place their cells on release, which still belongs to the stroke
+		const bool isHeld = event->GetMouseKeyHold(MouseButton::Left);
+		if (editHistory != nullptr && (isHeld || event->GetMouseKeyUp(MouseButton::Left))) editHistory->BeginStroke(activeTileMap);
+
 		bool success = tools[activeTool]->OnInteract(event, gridPos, isStale);
 
+		if (editHistory != nullptr && !isHeld) editHistory->EndStroke();
+
 		lastMouseGridPos = gridPos;
 
 		return success;
@@ -69,4 +82,48 @@ namespace GridTools {
 		isStale = false;
 	}
 
+	void GridToolBar::SetSelection(const glm::ivec2 start, const glm::ivec2 end) {
+		hasSelection = true;
+		selectionStart = start;
+		selectionEnd = end;
+	}
+
+	bool GridToolBar::TryGetSelection(glm::ivec2& out_min, glm::ivec2& out_max) const {
+		if (!hasSelection || activeTileMap == nullptr) return false;
+		out_min = glm::min(selectionStart, selectionEnd);
+		out_max = glm::max(selectionStart, selectionEnd);
+		return true;
+	}
+
+	bool GridToolBar::CopySelection() {
+		glm::ivec2 min, max;
+		if (!TryGetSelection(min, max)) return false;
+		activeTileMap->CopyRegion(min, max, Clipboard);
+		return true;
+	}
+
+	bool GridToolBar::CutSelection() {
+		glm::ivec2 min, max;
+		if (!CopySelection() || !TryGetSelection(min, max)) return false;
+
+		if (editHistory != nullptr) editHistory->BeginStroke(activeTileMap);
+		activeTileMap->EraseRegion(min, max);
+		if (editHistory != nullptr) editHistory->EndStroke();
+		ClearSelection();
+		return true;
+	}
+
+	bool GridToolBar::Paste() {
+		if (Clipboard.IsEmpty()) return false;
+		// the stamp tool may already be active with an older clipboard
+		tools[GridToolType::Stamp]->OnSelect();
+		SelectTool(GridToolType::Stamp);
+		return true;
+	}
+
+	void GridToolBar::Paste(const Prefab& prefab) {
+		Clipboard = prefab;
+		Paste();
+	}
+
 }
@@ -4,10 +4,13 @@
 #include <glm/vec2.hpp>
 
 #include "GridToolType.h"
+#include "ToolPreview.h"
+#include "Prefab.h"
 
 namespace Tiles {
 	class Tile;
 	class TileMap;
+	class TileEditHistory;
 }
 
 class InputMouseEvent;
@@ -27,6 +30,10 @@ namespace GridTools {
 
 		glm::ivec2 lastMouseGridPos = { INT_MAX, INT_MAX };
 
+		bool hasSelection = false;
+		glm::ivec2 selectionStart{};
+		glm::ivec2 selectionEnd{};
+
 	public:
 		GridToolBar(GridToolBar&& other) = delete;
 		GridToolBar(GridToolBar& other) = delete;
@@ -36,7 +43,14 @@ namespace GridTools {
 		~GridToolBar();
 
 		TileMap* activeTileMap = nullptr;
-
+		// edits made while the left mouse button is held are recorded as one stroke, may be null
+		TileEditHistory* editHistory = nullptr;
+		// fills are also clipped to the visible part of the grid
+		size_t MaxFillArea = 1000000;
+		// ghost of the shape being dragged out, rendered by the TileMapManager
+		ToolPreview Preview;
+		// cells copied from a selection or a prefab, placed by the stamp tool
+		Prefab Clipboard;
 
 		void SelectTool(GridToolType type);
 		bool OnMouseEvent(const InputMouseEvent* event);
@@ -50,6 +64,17 @@ namespace GridTools {
 		void SetActiveTileMap(TileMap* tileMap) { activeTileMap = tileMap; }
 
 		void SetSelectedTile(Tile* tile);
+
+		// Region selection in grid positions of the active tileMap
+		void SetSelection(glm::ivec2 start, glm::ivec2 end);
+		void ClearSelection() { hasSelection = false; }
+		// inclusive bounds
+		bool TryGetSelection(glm::ivec2& out_min, glm::ivec2& out_max) const;
+		bool CopySelection();
+		bool CutSelection();
+		// Selects the stamp tool, returns false if there is nothing to paste
+		bool Paste();
+		void Paste(const Prefab& prefab);
 	};
 
 
@@ -3,7 +3,12 @@ namespace GridTools {
 	enum class GridToolType {
 		Place = 0,
 		Erase = 1 << 0,
-		Select = 1 << 1
+		Select = 1 << 1,
+		Fill = 1 << 2,
+		Rectangle = 1 << 3,
+		RectangleOutline = 1 << 4,
+		Line = 1 << 5,
+		Stamp = 1 << 6
 	};
 }
 
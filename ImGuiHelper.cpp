@@ -31,11 +31,32 @@ namespace ImGuiHelper {
 		return pressed;
 	}
 
+	void GetImageUvs(const Rendering::Texture* texture, ImVec2& out_uv0, ImVec2& out_uv1) {
+		const glm::vec4 uvRect = texture->GetUvRect();
+		// textures are stored bottom row first
+		out_uv0 = ImVec2(uvRect.x, uvRect.y + uvRect.w);
+		out_uv1 = ImVec2(uvRect.x + uvRect.z, uvRect.y);
+	}
+
+	void Image(const Rendering::Texture* texture, const ImVec2 size, const char* id) {
+		ImVec2 uv0, uv1;
+		GetImageUvs(texture, uv0, uv1);
+		if (id != 0) ImGui::PushID(id);
+		ImGui::Image(reinterpret_cast<ImTextureID>(texture->GetTextureID()), size, uv0, uv1);
+		if (id != 0) ImGui::PopID();
+	}
+
+	bool ImageButton(const Rendering::Texture* texture, const ImVec2 size, const int framePadding) {
+		ImVec2 uv0, uv1;
+		GetImageUvs(texture, uv0, uv1);
+		return ImGui::ImageButton(reinterpret_cast<ImTextureID>(texture->GetTextureID()), size, uv0, uv1, framePadding);
+	}
+
 	void DragSourceTexture(Rendering::Texture*& texture) {
 		if(texture == nullptr) return;
 		if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_SourceAllowNullID)) {
 			ImGui::SetDragDropPayload("Texture", &texture, sizeof(void*));
-			Image(texture->GetTextureID());
+			Image(texture);
 			ImGui::TextUnformatted(texture->Name.c_str());
 			ImGui::EndDragDropSource();
 		}
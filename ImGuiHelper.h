@@ -19,6 +19,11 @@ namespace ImGuiHelper {
 		return ImGui::ImageButton(reinterpret_cast<ImTextureID>(textureId), size, ImVec2(0, 1), ImVec2(1, 0), framePadding);
 	}
 
+	// Top left and bottom right uv for ImGui, subTextures only cover part of their GL texture
+	void GetImageUvs(const Rendering::Texture* texture, ImVec2& out_uv0, ImVec2& out_uv1);
+	void Image(const Rendering::Texture* texture, ImVec2 size = ImVec2(32, 32), const char* id = 0);
+	bool ImageButton(const Rendering::Texture* texture, ImVec2 size = ImVec2(32, 32), int framePadding = -1);
+
 	bool RectButton(const ImVec2 pos, const ImVec2 size, const char* id, bool* out_isHovered, bool* out_isHeld, ImColor color = ImColor(255, 255, 255, 255) );
 
 	inline void DropTargetTexture(std::function<void(Rendering::Texture*)> onDrop) {
@@ -0,0 +1,191 @@
+#include "ImportCache.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "BinaryFormat.h"
+#include "MappedFile.h"
+#include "Texture.h"
+#include "ThumbnailCache.h"
+
+using namespace Rendering;
+
+namespace {
+	// entries are pruned by write time, so reading one keeps it
+	void Touch(const std::filesystem::path& path) {
+		std::error_code error;
+		std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+	}
+}
+
+void ImportCache::Initialize(const std::filesystem::path& absoluteDirectory, const uintmax_t maxByteSize) {
+	directory = absoluteDirectory;
+	hitCount = 0;
+	missCount = 0;
+	Prune(maxByteSize);
+}
+
+void ImportCache::Prune(const uintmax_t maxByteSize) {
+	struct Entry {
+		std::filesystem::path Path;
+		std::filesystem::file_time_type WriteTime;
+		uintmax_t ByteSize;
+	};
+	std::vector<Entry> entries;
+	uintmax_t totalByteSize = 0;
+	std::error_code error;
+	for (const auto& file : std::filesystem::directory_iterator(directory, error)) {
+		if (!file.is_regular_file(error)) continue;
+		// left behind by interrupted writes
+		if (file.path().extension() == ".tmp") {
+			std::filesystem::remove(file.path(), error);
+			continue;
+		}
+		if (file.path().extension() != ".tex") continue;
+		entries.push_back({ file.path(), file.last_write_time(error), file.file_size(error) });
+		totalByteSize += entries.back().ByteSize;
+	}
+	if (totalByteSize <= maxByteSize) return;
+
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.WriteTime < b.WriteTime; });
+	size_t removedCount = 0;
+	for (const Entry& entry : entries) {
+		if (totalByteSize <= maxByteSize) break;
+		if (!std::filesystem::remove(entry.Path, error)) continue;
+		totalByteSize -= entry.ByteSize;
+		++removedCount;
+	}
+	std::cout << "Removed " << removedCount << " least recently used import cache entries" << std::endl;
+}
+
+std::filesystem::path ImportCache::GetEntryPath(const uint64_t key) {
+	std::ostringstream name;
+	name << std::hex << std::setw(16) << std::setfill('0') << key << ".tex";
+	return directory / name.str();
+}
+
+uint64_t ImportCache::GetKey(const unsigned char* imageFileContent, const size_t byteSize, const ImportSettings& settings) {
+	const unsigned char settingBytes[] = {
+		static_cast<unsigned char>(entryVersion), settings.FlipVertically, settings.GenerateMips, static_cast<unsigned char>(settings.Compression)
+	};
+	// FNV-1a, continued over the settings
+	uint64_t key = ThumbnailCache::HashContent(imageFileContent, byteSize);
+	for (const unsigned char byte : settingBytes) {
+		key ^= byte;
+		key *= 0x100000001b3ull;
+	}
+	return key;
+}
+
+bool ImportCache::TryRead(const uint64_t key, DecodedImage& out_image) {
+	if (!IsEnabled()) return false;
+	const std::filesystem::path path = GetEntryPath(key);
+	std::error_code error;
+	MappedFile file;
+	if (!std::filesystem::is_regular_file(path, error) || !file.Open(path)) {
+		++missCount;
+		return false;
+	}
+
+	Serialization::BinaryReader reader(file.GetData(), file.GetSize());
+	uint32_t magic = 0, levelCount = 0;
+	uint16_t version = 0, channelCount = 0, compression = 0;
+	int32_t width = 0, height = 0;
+	reader.Read(magic);
+	reader.Read(version);
+	reader.Read(channelCount);
+	reader.Read(compression);
+	reader.Read(width);
+	reader.Read(height);
+	reader.Read(levelCount);
+	// outdated or broken entries are written again after decoding
+	if (reader.HasFailed() || magic != entryMagic || version != entryVersion || channelCount != MipChain::ChannelCount || width <= 0 || height <= 0) {
+		++missCount;
+		return false;
+	}
+
+	if (compression != static_cast<uint16_t>(TextureCompression::None)) {
+		// encoded entries always hold the full chain
+		const auto textureCompression = static_cast<TextureCompression>(compression);
+		const size_t byteSize = reader.GetRemaining();
+		if (textureCompression != out_image.Compression || byteSize != TextureEncoder::GetMipChainSize(textureCompression, width, height)) {
+			++missCount;
+			return false;
+		}
+		const uint8_t* levels = reader.ReadBlock(byteSize);
+		out_image.EncodedLevels.assign(levels, levels + byteSize);
+		out_image.Properties.width = width;
+		out_image.Properties.height = height;
+		file.Close();
+		Touch(path);
+		++hitCount;
+		return true;
+	}
+
+	const size_t baseByteSize = static_cast<size_t>(width) * height * MipChain::ChannelCount;
+	const uint8_t* basePixels = reader.ReadBlock(baseByteSize);
+	const size_t mipByteSize = reader.GetRemaining();
+	if (basePixels == nullptr || out_image.Compression != TextureCompression::None ||
+	    (levelCount > 1 && !out_image.Mips.Load(reader.ReadBlock(mipByteSize), mipByteSize, width, height))) {
+		++missCount;
+		return false;
+	}
+
+	out_image.Data = static_cast<unsigned char*>(malloc(baseByteSize));
+	if (out_image.Data == nullptr) return false;
+	memcpy(out_image.Data, basePixels, baseByteSize);
+	out_image.Properties.width = width;
+	out_image.Properties.height = height;
+	file.Close();
+	Touch(path);
+	++hitCount;
+	return true;
+}
+
+void ImportCache::Write(const uint64_t key, const DecodedImage& image) {
+	if (!IsEnabled()) return;
+	using namespace Serialization;
+	const int width = image.Properties.width;
+	const int height = image.Properties.height;
+	const std::filesystem::path path = GetEntryPath(key);
+	// written to a temporary file first, so a partially written entry is never read
+	std::filesystem::path temporaryPath = path;
+	temporaryPath += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+	bool written;
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		WriteLittleEndian(file, entryMagic);
+		WriteLittleEndian(file, entryVersion);
+		WriteLittleEndian(file, static_cast<uint16_t>(MipChain::ChannelCount));
+		WriteLittleEndian(file, static_cast<uint16_t>(image.Compression));
+		WriteLittleEndian(file, static_cast<int32_t>(width));
+		WriteLittleEndian(file, static_cast<int32_t>(height));
+		if (image.Compression != TextureCompression::None) {
+			WriteLittleEndian(file, static_cast<uint32_t>(MipChain::GetLevelCount(width, height)));
+			WriteBlock(file, image.EncodedLevels.data(), image.EncodedLevels.size());
+		}
+		else {
+			WriteLittleEndian(file, static_cast<uint32_t>(image.Mips.GetGeneratedLevelCount() + 1));
+			WriteBlock(file, image.Data, static_cast<size_t>(width) * height * MipChain::ChannelCount);
+			WriteBlock(file, image.Mips.GetData(), image.Mips.GetByteSize());
+		}
+		written = file.good();
+	}
+
+	std::error_code error;
+	if (!written) {
+		std::cout << "Unable to write import cache entry " << path.string() << std::endl;
+		std::filesystem::remove(temporaryPath, error);
+		return;
+	}
+	std::filesystem::rename(temporaryPath, path, error);
+	// another thread may have written or mapped the same entry
+	if (error) std::filesystem::remove(temporaryPath, error);
+}
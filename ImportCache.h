@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+
+#include "TextureEncoder.h"
+
+namespace Rendering {
+	struct DecodedImage;
+
+	// Options that change the imported pixels, part of the cache key
+	struct ImportSettings {
+		bool FlipVertically = true;
+		bool GenerateMips = true;
+		TextureCompression Compression = TextureCompression::None;
+	};
+
+	// Decoded images stored on disk, so images that did not change are not decoded again on startup.
+	// Entries are keyed by a hash of the image file's content and the import settings, one file per entry.
+	// Entries of changed images are never read again, the least recently read entries are deleted once the directory exceeds its size cap.
+	// Entry layout, little-endian: uint32 magic "TXIC", uint16 version, uint16 channel count, uint16 compression, int32 width, int32 height,
+	// uint32 level count including level 0, then the rgba pixels or encoded blocks of every level back to back, largest first. Rows bottom first.
+	class ImportCache {
+		static constexpr uint32_t entryMagic = 0x43495854; // "TXIC"
+		static constexpr uint16_t entryVersion = 2;
+
+		inline static std::filesystem::path directory;
+		inline static std::atomic<size_t> hitCount = 0;
+		inline static std::atomic<size_t> missCount = 0;
+
+		static std::filesystem::path GetEntryPath(uint64_t key);
+		// Deletes the oldest entries by write time, which reads refresh, until the directory holds at most maxByteSize
+		static void Prune(uintmax_t maxByteSize);
+
+	public:
+		static constexpr uintmax_t DefaultMaxByteSize = 1ull << 30;
+
+		// Entries are read from and written to the directory, which has to exist
+		static void Initialize(const std::filesystem::path& absoluteDirectory, uintmax_t maxByteSize = DefaultMaxByteSize);
+		// Images are decoded without the cache afterwards
+		static void Close() { directory.clear(); }
+		static bool IsEnabled() { return !directory.empty(); }
+
+		static uint64_t GetKey(const unsigned char* imageFileContent, size_t byteSize, const ImportSettings& settings);
+		// Sets the size, compression and levels of out_image. The entry is mapped and its levels are copied, Data is allocated with malloc
+		// like stb does since the image is uploaded and freed later on the main thread. Safe to call from worker threads
+		static bool TryRead(uint64_t key, DecodedImage& out_image);
+		// Safe to call from worker threads
+		static void Write(uint64_t key, const DecodedImage& image);
+
+		static size_t GetHitCount() { return hitCount; }
+		static size_t GetMissCount() { return missCount; }
+	};
+}
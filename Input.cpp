@@ -1,5 +1,6 @@
 #include "Input.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "MainWindow.h"
@@ -8,47 +9,83 @@ Input::Input() = default;
 
 InputKeyBinding* Input::AddKeyBinding(const SDL_Keycode keycode, std::function<void(KeyEvent)> action) {
 	auto* newBinding = new InputKeyBinding(action, keycode);
-	keyBindings[keycode].insert(newBinding);
+	uint16_t keyIndex;
+	if (!TryGetKeyIndex(keycode, keyIndex)) {
+		std::cout << "Keycode " << keycode << " can not be bound." << std::endl;
+		return newBinding;
+	}
+	if (isDispatching) addedKeyBindings.push_back({ keyIndex, newBinding });
+	else InsertKeyBinding({ keyIndex, newBinding });
 	return newBinding;
 }
 
+void Input::InsertKeyBinding(const KeyBindingEntry& entry) {
+	const auto position = std::upper_bound(keyBindings.begin(), keyBindings.end(), entry.KeyIndex,
+		[](const uint16_t index, const KeyBindingEntry& other) { return index < other.KeyIndex; });
+	keyBindings.insert(position, entry);
+}
+
 void Input::RemoveKeyBinding(InputKeyBinding* binding) {
-	if (!keyBindings[binding->Keycode].erase(binding)) {
-		std::cout << "Failed to remove binding for keycode: " << binding->Keycode << std::endl;
+	const auto findBinding = [binding](const KeyBindingEntry& entry) { return entry.Binding == binding; };
+	const auto iterator = std::find_if(keyBindings.begin(), keyBindings.end(), findBinding);
+	const auto added = std::find_if(addedKeyBindings.begin(), addedKeyBindings.end(), findBinding);
+	if (added != addedKeyBindings.end()) addedKeyBindings.erase(added);
+	else if (iterator == keyBindings.end()) {
+		uint16_t keyIndex;
+		if (TryGetKeyIndex(binding->Keycode, keyIndex)) std::cout << "Failed to remove binding for keycode: " << binding->Keycode << std::endl;
 	}
-	delete binding;
+	else if (isDispatching) iterator->Binding = nullptr;
+	else keyBindings.erase(iterator);
+
+	// the binding's own action may be running
+	if (isDispatching) removedKeyBindings.push_back(binding);
+	else delete binding;
 }
 
 void Input::ReceiveKeyDownInput(const SDL_Keycode& keycode) {
-	if (keysHeldDown[keycode]) return; //don't care if its already held down
-	keysHeldDown[keycode] = true;
-	keysDownThisFrame.insert(keycode);
+	uint16_t keyIndex;
+	if (!TryGetKeyIndex(keycode, keyIndex)) return;
+	if (keysHeldDown.test(keyIndex)) return; //don't care if its already held down
+	keysHeldDown.set(keyIndex);
+	heldKeys.push_back(keyIndex);
+	keyTransitions.push_back({ keyIndex, KeyEvent::KeyDown });
 }
 
 void Input::ReceiveKeyUpInput(const SDL_Keycode& keycode) {
-	if (!keysHeldDown[keycode]) {
+	uint16_t keyIndex;
+	if (!TryGetKeyIndex(keycode, keyIndex)) return;
+	if (!keysHeldDown.test(keyIndex)) {
 		std::cout << "Key " << keycode << " release received, but was not held down?" << std::endl;
 		return;
 	}
-	keysHeldDown.erase(keycode);
-	keysUpThisFrame.insert(keycode);
+	keysHeldDown.reset(keyIndex);
+	// keeps the press order of the remaining keys
+	heldKeys.erase(std::find(heldKeys.begin(), heldKeys.end(), keyIndex));
+	keyTransitions.push_back({ keyIndex, KeyEvent::KeyUp });
 }
 
 InputMouseBinding* Input::AddMouseBinding(const std::function<void(const InputMouseEvent*)>& action) {
 	const auto binding = new InputMouseBinding(action);
 
-	mouseBindings.insert(binding);
+	if (isDispatching) addedMouseBindings.push_back(binding);
+	else mouseBindings.push_back(binding);
 
 	return binding;
 }
 
 void Input::RemoveMouseBinding(InputMouseBinding* binding) {
-	if (!mouseBindings.erase(binding)) {
+	const auto iterator = std::find(mouseBindings.begin(), mouseBindings.end(), binding);
+	const auto added = std::find(addedMouseBindings.begin(), addedMouseBindings.end(), binding);
+	if (added != addedMouseBindings.end()) addedMouseBindings.erase(added);
+	else if (iterator == mouseBindings.end()) {
 		std::cout << "Failed to remove mouseBinding" << std::endl;
 	}
+	else if (isDispatching) *iterator = nullptr;
+	else mouseBindings.erase(iterator);
 
-	delete binding;
-	binding = nullptr;
+	// the binding's own action may be running
+	if (isDispatching) removedMouseBindings.push_back(binding);
+	else delete binding;
 }
 
 void Input::ReceiveMouseMotion(const SDL_MouseMotionEvent& e) {
@@ -56,10 +93,12 @@ void Input::ReceiveMouseMotion(const SDL_MouseMotionEvent& e) {
 	// making sure to add to delta, as multiple updates may happen per frame
 	mouseMotion.deltaX += e.xrel;
 	mouseMotion.deltaY += e.yrel;
+	if (mousePositionOverridden) mousePositionOverride = std::make_pair(e.x, e.y);
 }
 
 void Input::ReceiveMouseButtonEvent(const SDL_MouseButtonEvent e) {
 	const bool pressed = e.state == SDL_PRESSED;
+	if (mousePositionOverridden) mousePositionOverride = std::make_pair(e.x, e.y);
 	MouseButton button;
 	switch (e.button) {
 	case SDL_BUTTON_LEFT:
@@ -73,29 +112,26 @@ void Input::ReceiveMouseButtonEvent(const SDL_MouseButtonEvent e) {
 		break;
 	case SDL_BUTTON_X1:
 		button = MouseButton::X1;
-		std::cout << "Mouse Button X1" << e.button << std::endl;
 		break;
 	case SDL_BUTTON_X2:
 		button = MouseButton::X2;
-		std::cout << "Mouse Button X2" << e.button << std::endl;
 		break;
 	default:
-		std::cout << "Unknown mouse button event: " << e.button << std::endl;
+		std::cout << "Unknown mouse button event: " << static_cast<int>(e.button) << std::endl;
+		return;
 	}
-	auto& keyEvents = mouseKeyEvents[button];
+	uint8_t& keyEvents = mouseKeyEvents[GetMouseButtonIndex(button)];
 	// key down
 	if (pressed) {
-		if (keyEvents.count(KeyEvent::KeyHold)) return; // if button is already held, we choose to ignore additional press events
+		if (keyEvents & static_cast<uint8_t>(KeyEvent::KeyHold)) return; // if button is already held, we choose to ignore additional press events
 
-		keyEvents.insert(KeyEvent::KeyHold);
-		keyEvents.insert(KeyEvent::KeyDown);
+		keyEvents |= static_cast<uint8_t>(KeyEvent::KeyHold) | static_cast<uint8_t>(KeyEvent::KeyDown);
 
 		return;
 	}
 
-	// key up
-	keyEvents.clear(); // remove hold and down events
-	keyEvents.insert(KeyEvent::KeyUp);
+	// key up, removes hold and down events
+	keyEvents = static_cast<uint8_t>(KeyEvent::KeyUp);
 }
 
 void Input::ReceiveMouseWheelEvent(const SDL_MouseWheelEvent e) {
@@ -106,47 +142,85 @@ void Input::ReceiveMouseWheelEvent(const SDL_MouseWheelEvent e) {
 	mouseWheel = wheel;
 }
 
+bool Input::ReceiveSDLEvent(const SDL_Event& sdlEvent) {
+	switch (sdlEvent.type) {
+	case SDL_KEYDOWN:
+		ReceiveKeyDownInput(sdlEvent.key.keysym.sym);
+		return true;
+	case SDL_KEYUP:
+		ReceiveKeyUpInput(sdlEvent.key.keysym.sym);
+		return true;
+	case SDL_MOUSEMOTION:
+		ReceiveMouseMotion(sdlEvent.motion);
+		return true;
+	case SDL_MOUSEBUTTONUP:
+	case SDL_MOUSEBUTTONDOWN:
+		ReceiveMouseButtonEvent(sdlEvent.button);
+		return true;
+	case SDL_MOUSEWHEEL:
+		ReceiveMouseWheelEvent(sdlEvent.wheel);
+		return true;
+	default:
+		return false;
+	}
+}
+
 void Input::DelegateMouseActions() {
 	// make sure total mouse pos is always accurate
 	GetMousePosition(mouseMotion.posX, mouseMotion.posY);
 	const auto mouseEvent = InputMouseEvent(&mouseKeyEvents, &mouseMotion, &mouseWheel);
-	for (auto const& mouse_binding : mouseBindings) {
-		mouse_binding->Action(&mouseEvent);
+	isDispatching = true;
+	for (const InputMouseBinding* binding : mouseBindings) {
+		if (binding != nullptr) binding->Action(&mouseEvent);
 	}
+	ApplyDeferredBindingChanges();
 	// clear mouse key events - remove all if keyup, remove only keydown if its present
-	for (auto& [key, e] : mouseKeyEvents) {
-		if (e.count(KeyEvent::KeyUp)) {
-			e.clear();
-			continue;
-		}
-
-		if (e.count(KeyEvent::KeyDown))
-			e.erase(KeyEvent::KeyDown);
+	for (auto& keyEvents : mouseKeyEvents) {
+		if (keyEvents & static_cast<uint8_t>(KeyEvent::KeyUp)) keyEvents = 0;
+		else keyEvents &= ~static_cast<uint8_t>(KeyEvent::KeyDown);
 	}
 	ClearMouseActions();
 }
 
+void Input::InvokeKeyBindings(const uint16_t keyIndex, const KeyEvent keyEvent) {
+	const auto first = std::lower_bound(keyBindings.begin(), keyBindings.end(), keyIndex,
+		[](const KeyBindingEntry& entry, const uint16_t index) { return entry.KeyIndex < index; });
+	for (auto entry = first; entry != keyBindings.end() && entry->KeyIndex == keyIndex; ++entry) {
+		if (entry->Binding != nullptr) entry->Binding->Action(keyEvent);
+	}
+}
+
+void Input::ApplyDeferredBindingChanges() {
+	isDispatching = false;
+	keyBindings.erase(std::remove_if(keyBindings.begin(), keyBindings.end(), [](const KeyBindingEntry& entry) { return entry.Binding == nullptr; }), keyBindings.end());
+	mouseBindings.erase(std::remove(mouseBindings.begin(), mouseBindings.end(), nullptr), mouseBindings.end());
+	for (const KeyBindingEntry& entry : addedKeyBindings) InsertKeyBinding(entry);
+	mouseBindings.insert(mouseBindings.end(), addedMouseBindings.begin(), addedMouseBindings.end());
+	for (const InputKeyBinding* binding : removedKeyBindings) delete binding;
+	for (const InputMouseBinding* binding : removedMouseBindings) delete binding;
+	addedKeyBindings.clear();
+	addedMouseBindings.clear();
+	removedKeyBindings.clear();
+	removedMouseBindings.clear();
+}
+
 void Input::DelegateKeyboardActions() {
+	isDispatching = true;
 	// Pressed Keys
-	for (auto const& key : keysDownThisFrame) {
-		for (auto const& binding : keyBindings[key]) {
-			binding->Action(KeyEvent::KeyDown);
-		}
+	for (const KeyTransition& transition : keyTransitions) {
+		if (transition.Event == KeyEvent::KeyDown) InvokeKeyBindings(transition.KeyIndex, KeyEvent::KeyDown);
 	}
 
 	// Held Keys
-	for (auto const& [keycode, beingHeld] : keysHeldDown) {
-		for (auto const& binding : keyBindings[keycode]) {
-			binding->Action(KeyEvent::KeyHold);
-		}
+	for (const uint16_t keyIndex : heldKeys) {
+		InvokeKeyBindings(keyIndex, KeyEvent::KeyHold);
 	}
 
 	// Released Keys
-	for (auto const& key : keysUpThisFrame) {
-		for (auto const& binding : keyBindings[key]) {
-			binding->Action(KeyEvent::KeyUp);
-		}
+	for (const KeyTransition& transition : keyTransitions) {
+		if (transition.Event == KeyEvent::KeyUp) InvokeKeyBindings(transition.KeyIndex, KeyEvent::KeyUp);
 	}
+	ApplyDeferredBindingChanges();
 
 	ClearKeyboardActions();
 }
@@ -158,8 +232,7 @@ void Input::ClearMouseActions() {
 }
 
 void Input::ClearKeyboardActions() {
-	keysDownThisFrame.clear();
-	keysUpThisFrame.clear();
+	keyTransitions.clear();
 }
 
 void Input::SetMouseCapture(bool set) {
@@ -177,22 +250,17 @@ void Input::SetMouseCapture(bool set) {
 }
 
 void Input::Cleanup() {
-	for (auto& [key, value] : keyBindings) {
-		Cleanup(value);
-	}
-
-	Cleanup(mouseBindings);
-}
-
-template <typename T>
-void Input::Cleanup(T collection) {
-	if (collection.size() > 0) {
-		std::cout << "Input wasn't properly unsubscribed - remaining entries: " << collection.size() << std::endl;
-
-		for (auto ptr : collection) {
-			delete ptr;
-		}
+	if (keyBindings.size() + mouseBindings.size() > 0) {
+		std::cout << "Input wasn't properly unsubscribed - remaining entries: " << keyBindings.size() + mouseBindings.size() << std::endl;
 	}
+	for (const auto& entry : keyBindings) delete entry.Binding;
+	keyBindings.clear();
+	for (const auto* binding : mouseBindings) delete binding;
+	mouseBindings.clear();
+	for (const auto& entry : addedKeyBindings) delete entry.Binding;
+	addedKeyBindings.clear();
+	for (const auto* binding : addedMouseBindings) delete binding;
+	addedMouseBindings.clear();
 }
 
 glm::vec2 Input::GetMousePosition() {
@@ -202,9 +270,21 @@ glm::vec2 Input::GetMousePosition() {
 }
 
 void Input::GetMousePosition(int &x, int &y) {
-	SDL_GetMouseState(&x, &y);
+	if (!TryGetMousePositionOverride(x, y)) SDL_GetMouseState(&x, &y);
 	int _, yScreen;
 	Rendering::MainWindow::GetSize(_, yScreen);
 	//Y is 0 at top in SDL, so set it to 0 at bottom by subtracting it from screen height in order to make it more intuitive
 	y = yScreen - y;
 }
+
+void Input::OverrideMousePosition(const int x, const int y) {
+	mousePositionOverridden = true;
+	mousePositionOverride = std::make_pair(x, y);
+}
+
+bool Input::TryGetMousePositionOverride(int& out_x, int& out_y) {
+	if (!mousePositionOverridden) return false;
+	out_x = mousePositionOverride.first;
+	out_y = mousePositionOverride.second;
+	return true;
+}
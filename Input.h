@@ -1,10 +1,11 @@
 #pragma once
+#include <array>
+#include <bitset>
+#include <cstdint>
 #include <functional>
-#include <map>
 #include <SDL.h>
-#include <unordered_set>
-#include <set>
 #include <utility>
+#include <vector>
 #include <glm/vec2.hpp>
 
 
@@ -21,6 +22,7 @@ enum class MouseButton {
 	X1 = 1 << 3,
 	X2 = 1 << 4
 };
+constexpr size_t MouseButtonCount = 5;
 
 struct InputKeyBinding {
 	std::function<void(KeyEvent)> Action;
@@ -40,16 +42,23 @@ struct MouseWheel {
 	float scrollDeltaPrecise;
 };
 
+// KeyEvent flags of each mouse button, indexed by GetMouseButtonIndex
+using MouseButtonEvents = std::array<uint8_t, MouseButtonCount>;
+
+inline size_t GetMouseButtonIndex(const MouseButton button) {
+	size_t index = 0;
+	for (auto flag = static_cast<unsigned int>(button); flag > 1; flag >>= 1) ++index;
+	return index;
+}
+
 class InputMouseEvent {
-	const std::map<MouseButton, std::unordered_set<KeyEvent>>* keyEvents = nullptr;
+	const MouseButtonEvents* keyEvents = nullptr;
 	const MouseWheel* wheel;
 public:
 	const MouseMotion* motion;
 
 	bool GetMouseKey(KeyEvent mouse_key_event, MouseButton button) const {
-		const auto iterator = keyEvents->find(button);
-		if (iterator == keyEvents->end()) return false;
-		return iterator->second.find(mouse_key_event) != iterator->second.end();
+		return ((*keyEvents)[GetMouseButtonIndex(button)] & static_cast<uint8_t>(mouse_key_event)) != 0;
 	}
 
 	bool GetMouseKeyDown(MouseButton button) const { return GetMouseKey(KeyEvent::KeyDown, button); }
@@ -62,7 +71,7 @@ public:
 
 	float GetMouseWheelDeltaPrecise() const { return wheel->scrollDeltaPrecise; }
 
-	InputMouseEvent(const std::map<MouseButton, std::unordered_set<KeyEvent>>* key_events, const MouseMotion* motion, const MouseWheel* wheel)
+	InputMouseEvent(const MouseButtonEvents* key_events, const MouseMotion* motion, const MouseWheel* wheel)
 		: keyEvents(key_events),
 		wheel(wheel),
 		motion(motion) {}
@@ -75,17 +84,71 @@ struct InputMouseBinding {
 	InputMouseBinding(std::function<void(const InputMouseEvent*)> action) : Action(std::move(action)) {}
 };
 
+// Key state lives in bitsets and buffers reserved up front, nothing is allocated while events are received or dispatched
+// unless a frame exceeds them. Bindings are only allocated when added.
 class Input {
 	Input();
-	inline static std::map<SDL_Keycode, std::unordered_set<InputKeyBinding*>> keyBindings;
-	inline static std::unordered_set<SDL_Keycode> keysDownThisFrame;
-	inline static std::unordered_set<SDL_Keycode> keysUpThisFrame;
-	inline static std::unordered_set<InputMouseBinding*> mouseBindings;
-	inline static std::map<SDL_Keycode, bool> keysHeldDown;
-	inline static std::map<MouseButton, std::unordered_set<KeyEvent>> mouseKeyEvents;
+	// character keycodes below this map onto themselves, scancode based keycodes (SDLK_SCANCODE_MASK) follow after
+	static constexpr size_t characterKeyCount = 1024;
+	static constexpr size_t keyCount = characterKeyCount + SDL_NUM_SCANCODES;
+	// reserved capacities, the buffers grow past them so no release is ever dropped
+	static constexpr size_t reservedKeyEventsPerFrame = 64;
+	static constexpr size_t reservedHeldKeys = 32;
+
+	struct KeyBindingEntry {
+		uint16_t KeyIndex;
+		InputKeyBinding* Binding;
+	};
+	struct KeyTransition {
+		uint16_t KeyIndex;
+		KeyEvent Event;
+	};
+
+	template<typename T>
+	static std::vector<T> CreateReserved(const size_t capacity) {
+		std::vector<T> buffer;
+		buffer.reserve(capacity);
+		return buffer;
+	}
+
+	// sorted by key index, the bindings of one key are adjacent
+	inline static std::vector<KeyBindingEntry> keyBindings;
+	inline static std::vector<InputMouseBinding*> mouseBindings;
+	// bindings added or removed by an action take effect once dispatching is done, removed entries are null until then
+	inline static bool isDispatching = false;
+	inline static std::vector<KeyBindingEntry> addedKeyBindings;
+	inline static std::vector<InputMouseBinding*> addedMouseBindings;
+	inline static std::vector<InputKeyBinding*> removedKeyBindings;
+	inline static std::vector<InputMouseBinding*> removedMouseBindings;
+
+	inline static std::bitset<keyCount> keysHeldDown;
+	// held keys in press order, dispatched as KeyHold every frame
+	inline static std::vector<uint16_t> heldKeys = CreateReserved<uint16_t>(reservedHeldKeys);
+	// downs and ups of this frame in arrival order
+	inline static std::vector<KeyTransition> keyTransitions = CreateReserved<KeyTransition>(reservedKeyEventsPerFrame);
+
+	inline static MouseButtonEvents mouseKeyEvents{};
 	inline static MouseMotion mouseMotion;
 	inline static MouseWheel mouseWheel;
 	inline static std::pair<int, int> savedMousePosition = std::make_pair<int, int>(0, 0);
+	// replayed input moves this instead of the cursor, in SDL window coordinates
+	inline static bool mousePositionOverridden = false;
+	inline static std::pair<int, int> mousePositionOverride = std::make_pair<int, int>(0, 0);
+
+	static bool TryGetKeyIndex(SDL_Keycode keycode, uint16_t& out_index) {
+		if (keycode & SDLK_SCANCODE_MASK) {
+			const SDL_Keycode scancode = keycode & ~SDLK_SCANCODE_MASK;
+			if (scancode < 0 || scancode >= SDL_NUM_SCANCODES) return false;
+			out_index = static_cast<uint16_t>(characterKeyCount + scancode);
+			return true;
+		}
+		if (keycode < 0 || keycode >= static_cast<SDL_Keycode>(characterKeyCount)) return false;
+		out_index = static_cast<uint16_t>(keycode);
+		return true;
+	}
+	static void InsertKeyBinding(const KeyBindingEntry& entry);
+	static void InvokeKeyBindings(uint16_t keyIndex, KeyEvent keyEvent);
+	static void ApplyDeferredBindingChanges();
 public:
 	static InputKeyBinding* AddKeyBinding(const SDL_Keycode keycode, std::function<void(KeyEvent)> action);
 
@@ -105,6 +168,9 @@ public:
 
 	static void ReceiveMouseWheelEvent(const SDL_MouseWheelEvent e);
 
+	// Forwards keyboard and mouse events to the matching Receive function, returns false for other events
+	static bool ReceiveSDLEvent(const SDL_Event& sdlEvent);
+
 	static void DelegateMouseActions();
 
 	static void DelegateKeyboardActions();
@@ -117,21 +183,20 @@ public:
 
 	//Is key currently pressed down?
 	static bool GetKeyDown(const SDL_Keycode& keycode) {
-		auto it = keysHeldDown.find(keycode);
-		if(it != keysHeldDown.end()) {
-			return it->second;
-		}
-		return false;
+		uint16_t index;
+		return TryGetKeyIndex(keycode, index) && keysHeldDown.test(index);
 	}
 
 	static glm::vec2 GetMousePosition();
 	static void GetMousePosition(int& x, int& y);
 
+	// From now on the mouse position follows received motion events instead of the cursor
+	static void OverrideMousePosition(int x, int y);
+	// Overridden position in SDL window coordinates (y down)
+	static bool TryGetMousePositionOverride(int& out_x, int& out_y);
 
-	static void Cleanup();
 
-	template<typename T>
-	static void Cleanup(T collection);
+	static void Cleanup();
 };
 
 
@@ -0,0 +1,291 @@
+#include "InputRecording.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "BinaryFormat.h"
+#include "MappedFile.h"
+
+using namespace Serialization;
+
+namespace {
+	uint32_t FloatBits(const float value) {
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	float BitsToFloat(const uint32_t bits) {
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	void WriteEvent(std::ostream& oStream, const SDL_Event& e, const RecordedEventKind kind) {
+		WriteLittleEndian(oStream, static_cast<uint8_t>(kind));
+		switch (kind) {
+		case RecordedEventKind::KeyDown:
+		case RecordedEventKind::KeyUp:
+			WriteLittleEndian(oStream, static_cast<int32_t>(e.key.keysym.sym));
+			WriteLittleEndian(oStream, static_cast<uint16_t>(e.key.keysym.scancode));
+			WriteLittleEndian(oStream, e.key.keysym.mod);
+			WriteLittleEndian(oStream, e.key.repeat);
+			break;
+		case RecordedEventKind::MouseMotion:
+			WriteLittleEndian(oStream, e.motion.x);
+			WriteLittleEndian(oStream, e.motion.y);
+			WriteLittleEndian(oStream, e.motion.xrel);
+			WriteLittleEndian(oStream, e.motion.yrel);
+			WriteLittleEndian(oStream, e.motion.state);
+			break;
+		case RecordedEventKind::MouseButtonDown:
+		case RecordedEventKind::MouseButtonUp:
+			WriteLittleEndian(oStream, e.button.button);
+			WriteLittleEndian(oStream, e.button.clicks);
+			WriteLittleEndian(oStream, e.button.x);
+			WriteLittleEndian(oStream, e.button.y);
+			break;
+		case RecordedEventKind::MouseWheel:
+			WriteLittleEndian(oStream, e.wheel.x);
+			WriteLittleEndian(oStream, e.wheel.y);
+			WriteLittleEndian(oStream, FloatBits(e.wheel.preciseX));
+			WriteLittleEndian(oStream, FloatBits(e.wheel.preciseY));
+			break;
+		case RecordedEventKind::TextInput: {
+			const auto length = static_cast<uint8_t>(strnlen(e.text.text, SDL_TEXTINPUTEVENT_TEXT_SIZE - 1));
+			WriteLittleEndian(oStream, length);
+			WriteBlock(oStream, e.text.text, length);
+			break;
+		}
+		case RecordedEventKind::WindowResized:
+			WriteLittleEndian(oStream, e.window.data1);
+			WriteLittleEndian(oStream, e.window.data2);
+			break;
+		}
+	}
+
+	bool ReadEvent(BinaryReader& reader, SDL_Event& out_event) {
+		uint8_t kindValue;
+		if (!reader.Read(kindValue)) return false;
+		out_event = {};
+		switch (static_cast<RecordedEventKind>(kindValue)) {
+		case RecordedEventKind::KeyDown:
+		case RecordedEventKind::KeyUp: {
+			const bool down = static_cast<RecordedEventKind>(kindValue) == RecordedEventKind::KeyDown;
+			out_event.type = down ? SDL_KEYDOWN : SDL_KEYUP;
+			out_event.key.state = down ? SDL_PRESSED : SDL_RELEASED;
+			int32_t sym;
+			uint16_t scancode;
+			reader.Read(sym);
+			reader.Read(scancode);
+			reader.Read(out_event.key.keysym.mod);
+			reader.Read(out_event.key.repeat);
+			out_event.key.keysym.sym = sym;
+			out_event.key.keysym.scancode = static_cast<SDL_Scancode>(scancode);
+			break;
+		}
+		case RecordedEventKind::MouseMotion:
+			out_event.type = SDL_MOUSEMOTION;
+			reader.Read(out_event.motion.x);
+			reader.Read(out_event.motion.y);
+			reader.Read(out_event.motion.xrel);
+			reader.Read(out_event.motion.yrel);
+			reader.Read(out_event.motion.state);
+			break;
+		case RecordedEventKind::MouseButtonDown:
+		case RecordedEventKind::MouseButtonUp: {
+			const bool down = static_cast<RecordedEventKind>(kindValue) == RecordedEventKind::MouseButtonDown;
+			out_event.type = down ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+			out_event.button.state = down ? SDL_PRESSED : SDL_RELEASED;
+			reader.Read(out_event.button.button);
+			reader.Read(out_event.button.clicks);
+			reader.Read(out_event.button.x);
+			reader.Read(out_event.button.y);
+			break;
+		}
+		case RecordedEventKind::MouseWheel: {
+			out_event.type = SDL_MOUSEWHEEL;
+			out_event.wheel.direction = SDL_MOUSEWHEEL_NORMAL;
+			uint32_t preciseX = 0, preciseY = 0;
+			reader.Read(out_event.wheel.x);
+			reader.Read(out_event.wheel.y);
+			reader.Read(preciseX);
+			reader.Read(preciseY);
+			out_event.wheel.preciseX = BitsToFloat(preciseX);
+			out_event.wheel.preciseY = BitsToFloat(preciseY);
+			break;
+		}
+		case RecordedEventKind::TextInput: {
+			out_event.type = SDL_TEXTINPUT;
+			uint8_t length = 0;
+			if (!reader.Read(length) || length >= SDL_TEXTINPUTEVENT_TEXT_SIZE) return false;
+			reader.ReadBlock(out_event.text.text, length);
+			break;
+		}
+		case RecordedEventKind::WindowResized:
+			out_event.type = SDL_WINDOWEVENT;
+			out_event.window.event = SDL_WINDOWEVENT_RESIZED;
+			reader.Read(out_event.window.data1);
+			reader.Read(out_event.window.data2);
+			break;
+		default:
+			return false;
+		}
+		return !reader.HasFailed();
+	}
+}
+
+bool InputRecording::TryGetKind(const SDL_Event& sdlEvent, RecordedEventKind& out_kind) {
+	switch (sdlEvent.type) {
+	case SDL_KEYDOWN: out_kind = RecordedEventKind::KeyDown; return true;
+	case SDL_KEYUP: out_kind = RecordedEventKind::KeyUp; return true;
+	case SDL_MOUSEMOTION: out_kind = RecordedEventKind::MouseMotion; return true;
+	case SDL_MOUSEBUTTONDOWN: out_kind = RecordedEventKind::MouseButtonDown; return true;
+	case SDL_MOUSEBUTTONUP: out_kind = RecordedEventKind::MouseButtonUp; return true;
+	case SDL_MOUSEWHEEL: out_kind = RecordedEventKind::MouseWheel; return true;
+	case SDL_TEXTINPUT: out_kind = RecordedEventKind::TextInput; return true;
+	case SDL_WINDOWEVENT:
+		if (sdlEvent.window.event != SDL_WINDOWEVENT_RESIZED) return false;
+		out_kind = RecordedEventKind::WindowResized;
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool InputRecording::TryLoad(const std::string& filePath, InputRecording& out_recording) {
+	MappedFile file;
+	if (!file.Open(filePath)) {
+		std::cout << "Unable to open input recording " << filePath << std::endl;
+		return false;
+	}
+
+	BinaryReader reader(file.GetData(), file.GetSize());
+	uint32_t magic = 0;
+	uint16_t version = 0;
+	reader.Read(magic);
+	reader.Read(version);
+	if (magic != Magic || version != Version) {
+		std::cout << filePath << " is not an input recording of version " << Version << std::endl;
+		return false;
+	}
+	reader.Read(out_recording.WindowWidth);
+	reader.Read(out_recording.WindowHeight);
+	reader.Read(out_recording.MouseX);
+	reader.Read(out_recording.MouseY);
+
+	out_recording.Events.clear();
+	out_recording.FrameEnds.clear();
+	out_recording.FrameDurations.clear();
+	while (!reader.HasFailed() && reader.GetRemaining() > 0) {
+		uint32_t duration = 0;
+		uint16_t eventCount = 0;
+		reader.Read(duration);
+		if (!reader.Read(eventCount)) break;
+		for (uint16_t i = 0; i < eventCount; ++i) {
+			SDL_Event sdlEvent;
+			if (!ReadEvent(reader, sdlEvent)) break;
+			out_recording.Events.push_back(sdlEvent);
+		}
+		if (reader.HasFailed()) break;
+		out_recording.FrameEnds.push_back(out_recording.Events.size());
+		out_recording.FrameDurations.push_back(duration);
+	}
+	if (reader.HasFailed()) {
+		std::cout << "Input recording " << filePath << " is corrupt after frame " << out_recording.GetFrameCount() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool InputRecorder::Start(const std::string& filePath, const int windowWidth, const int windowHeight, const int mouseX, const int mouseY) {
+	Stop();
+	stream.open(filePath, std::iostream::binary);
+	if (!stream) {
+		std::cout << "Unable to create input recording " << filePath << std::endl;
+		return false;
+	}
+	WriteLittleEndian(stream, InputRecording::Magic);
+	WriteLittleEndian(stream, InputRecording::Version);
+	WriteLittleEndian(stream, static_cast<int32_t>(windowWidth));
+	WriteLittleEndian(stream, static_cast<int32_t>(windowHeight));
+	WriteLittleEndian(stream, static_cast<int32_t>(mouseX));
+	WriteLittleEndian(stream, static_cast<int32_t>(mouseY));
+	frameEvents.clear();
+	frameCount = 0;
+	std::cout << "Recording input to " << filePath << std::endl;
+	return true;
+}
+
+void InputRecorder::Record(const SDL_Event& sdlEvent) {
+	RecordedEventKind kind;
+	if (!IsRecording() || !InputRecording::TryGetKind(sdlEvent, kind)) return;
+	frameEvents.push_back(sdlEvent);
+}
+
+void InputRecorder::EndFrame(const double frameTimeMS) {
+	if (!IsRecording()) return;
+	// a frame with more events than fit the count is split, the remainder lands in an empty-duration frame
+	size_t written = 0;
+	do {
+		const size_t count = std::min<size_t>(frameEvents.size() - written, UINT16_MAX);
+		WriteLittleEndian(stream, written == 0 ? static_cast<uint32_t>(frameTimeMS * 1000.0) : 0u);
+		WriteLittleEndian(stream, static_cast<uint16_t>(count));
+		for (size_t i = written; i < written + count; ++i) {
+			RecordedEventKind kind;
+			InputRecording::TryGetKind(frameEvents[i], kind);
+			WriteEvent(stream, frameEvents[i], kind);
+		}
+		written += count;
+		++frameCount;
+	} while (written < frameEvents.size());
+	frameEvents.clear();
+}
+
+void InputRecorder::Stop() {
+	if (!IsRecording()) return;
+	stream.close();
+	std::cout << "Input recording stopped after " << frameCount << " frames" << std::endl;
+}
+
+bool InputReplay::Load(const std::string& filePath) {
+	if (!InputRecording::TryLoad(filePath, recording)) return false;
+	nextFrame = 0;
+	frameTimesMS.clear();
+	frameTimesMS.reserve(recording.GetFrameCount());
+	std::cout << "Replaying " << recording.GetFrameCount() << " frames from " << filePath << std::endl;
+	return true;
+}
+
+std::pair<const SDL_Event*, size_t> InputReplay::NextFrame() {
+	if (IsFinished()) return { nullptr, 0 };
+	const size_t first = recording.GetFrameStart(nextFrame);
+	const size_t count = recording.FrameEnds[nextFrame] - first;
+	++nextFrame;
+	return { recording.Events.data() + first, count };
+}
+
+bool InputReplay::WriteFrameTimes(const std::string& filePath) const {
+	if (frameTimesMS.empty()) return false;
+	std::vector<double> sorted = frameTimesMS;
+	std::sort(sorted.begin(), sorted.end());
+	const auto percentile = [&sorted](const double p) { return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))]; };
+	double total = 0;
+	for (const double time : sorted) total += time;
+
+	std::cout << "Replayed " << sorted.size() << " frames, mean " << total / sorted.size() << " ms, p50 " << percentile(0.5)
+		<< " ms, p95 " << percentile(0.95) << " ms, p99 " << percentile(0.99) << " ms, max " << sorted.back() << " ms" << std::endl;
+
+	std::ofstream file(filePath);
+	if (!file) {
+		std::cout << "Unable to write frame times to " << filePath << std::endl;
+		return false;
+	}
+	file << "frame,recordedMs,replayedMs\n";
+	for (size_t i = 0; i < frameTimesMS.size(); ++i) {
+		file << i << ',' << recording.FrameDurations[i] / 1000.0 << ',' << frameTimesMS[i] << '\n';
+	}
+	std::cout << "Frame times written to " << filePath << std::endl;
+	return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <SDL_events.h>
+
+// Binary log of the input events the editor received, little-endian:
+//   header: magic "IREC", uint16 version, int32 window width and height, int32 mouse x and y
+//   frame:  uint32 frame duration in microseconds, uint16 event count, events
+//   event:  uint8 RecordedEventKind followed by the fields of that kind, see InputRecording.cpp
+enum class RecordedEventKind : uint8_t {
+	KeyDown = 0,
+	KeyUp = 1,
+	MouseMotion = 2,
+	MouseButtonDown = 3,
+	MouseButtonUp = 4,
+	MouseWheel = 5,
+	TextInput = 6,
+	WindowResized = 7,
+};
+
+struct InputRecording {
+	static constexpr uint32_t Magic = 0x43455249; // "IREC"
+	static constexpr uint16_t Version = 1;
+
+	int WindowWidth = 0;
+	int WindowHeight = 0;
+	int MouseX = 0;
+	int MouseY = 0;
+	std::vector<SDL_Event> Events;
+	// index one past the last event of each frame
+	std::vector<size_t> FrameEnds;
+	// as recorded, in microseconds
+	std::vector<uint32_t> FrameDurations;
+
+	size_t GetFrameCount() const { return FrameEnds.size(); }
+	size_t GetFrameStart(const size_t frame) const { return frame == 0 ? 0 : FrameEnds[frame - 1]; }
+
+	// Returns false for events that are not recorded
+	static bool TryGetKind(const SDL_Event& sdlEvent, RecordedEventKind& out_kind);
+	static bool TryLoad(const std::string& filePath, InputRecording& out_recording);
+};
+
+class InputRecorder {
+	std::ofstream stream;
+	std::vector<SDL_Event> frameEvents;
+	size_t frameCount = 0;
+
+public:
+	bool Start(const std::string& filePath, int windowWidth, int windowHeight, int mouseX, int mouseY);
+	// Keeps the event for the current frame if it is an input event
+	void Record(const SDL_Event& sdlEvent);
+	void EndFrame(double frameTimeMS);
+	void Stop();
+	bool IsRecording() const { return stream.is_open(); }
+};
+
+// Feeds a recording back one frame at a time and collects the time each replayed frame took
+class InputReplay {
+	InputRecording recording;
+	size_t nextFrame = 0;
+	std::vector<double> frameTimesMS;
+
+public:
+	bool Load(const std::string& filePath);
+	const InputRecording& GetRecording() const { return recording; }
+
+	bool IsFinished() const { return nextFrame >= recording.GetFrameCount(); }
+	// Events of the next frame, advances the replay
+	std::pair<const SDL_Event*, size_t> NextFrame();
+	void EndFrame(double frameTimeMS) { frameTimesMS.push_back(frameTimeMS); }
+
+	// Writes one line per frame as CSV and prints a summary
+	bool WriteFrameTimes(const std::string& filePath) const;
+};
@@ -0,0 +1,90 @@
+#include "InstanceBuffer.h"
+
+#include "glad.h"
+#include "Mesh.h"
+
+Rendering::InstanceBuffer::InstanceBuffer(const Mesh::StaticMesh* mesh) : mesh(mesh) {
+	glCreateVertexArrays(1, &vertexArrayObject);
+	glCreateBuffers(1, &instanceBufferObject);
+	glCreateBuffers(1, &indirectBufferObject);
+
+	mesh->BindToVertexArray(vertexArrayObject);
+
+	constexpr unsigned int bindingIndex = 1;
+	glVertexArrayVertexBuffer(vertexArrayObject, bindingIndex, instanceBufferObject, 0, sizeof(InstanceData));
+	glVertexArrayBindingDivisor(vertexArrayObject, bindingIndex, 1);
+
+	glEnableVertexArrayAttrib(vertexArrayObject, 2);
+	glVertexArrayAttribFormat(vertexArrayObject, 2, 2, GL_FLOAT, GL_FALSE, offsetof(InstanceData, Offset));
+	glVertexArrayAttribBinding(vertexArrayObject, 2, bindingIndex);
+
+	glEnableVertexArrayAttrib(vertexArrayObject, 3);
+	glVertexArrayAttribFormat(vertexArrayObject, 3, 2, GL_FLOAT, GL_FALSE, offsetof(InstanceData, Scale));
+	glVertexArrayAttribBinding(vertexArrayObject, 3, bindingIndex);
+
+	glEnableVertexArrayAttrib(vertexArrayObject, 4);
+	glVertexArrayAttribFormat(vertexArrayObject, 4, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, UvRect));
+	glVertexArrayAttribBinding(vertexArrayObject, 4, bindingIndex);
+
+	glEnableVertexArrayAttrib(vertexArrayObject, 5);
+	glVertexArrayAttribFormat(vertexArrayObject, 5, 1, GL_FLOAT, GL_FALSE, offsetof(InstanceData, Layer));
+	glVertexArrayAttribBinding(vertexArrayObject, 5, bindingIndex);
+}
+
+void Rendering::InstanceTexture::Bind() const {
+	glBindTextureUnit(IsArray ? 1 : 0, Id);
+}
+
+Rendering::InstanceBuffer::~InstanceBuffer() {
+	glDeleteBuffers(1, &instanceBufferObject);
+	glDeleteBuffers(1, &indirectBufferObject);
+	glDeleteVertexArrays(1, &vertexArrayObject);
+}
+
+void Rendering::InstanceBuffer::Upload(const std::vector<InstanceData>& instances) {
+	instanceCount = instances.size();
+	if (instanceCount == 0) return;
+
+	const auto byteSize = static_cast<GLsizeiptr>(instanceCount * sizeof(InstanceData));
+	if (instanceCount > capacity) {
+		// grow geometrically so painting does not reallocate every edit
+		capacity = instanceCount + instanceCount / 2;
+		glNamedBufferData(instanceBufferObject, static_cast<GLsizeiptr>(capacity * sizeof(InstanceData)), nullptr, GL_DYNAMIC_DRAW);
+	}
+	glNamedBufferSubData(instanceBufferObject, 0, byteSize, instances.data());
+}
+
+void Rendering::InstanceBuffer::Draw(const size_t firstInstance, const size_t count) const {
+	if (count == 0) return;
+	glBindVertexArray(vertexArrayObject);
+	glDrawElementsInstancedBaseInstance(GL_TRIANGLES, static_cast<GLsizei>(mesh->GetIndexCount()), GL_UNSIGNED_INT, nullptr,
+	                                    static_cast<GLsizei>(count), static_cast<GLuint>(firstInstance));
+	glBindVertexArray(0);
+}
+
+void Rendering::InstanceBuffer::Draw(const std::vector<InstanceRange>& ranges) const {
+	if (ranges.empty()) return;
+	if (ranges.size() == 1) {
+		Draw(ranges[0].FirstInstance, ranges[0].InstanceCount);
+		return;
+	}
+
+	const auto indexCount = static_cast<unsigned int>(mesh->GetIndexCount());
+	indirectCommands.clear();
+	for (const auto& range : ranges) {
+		indirectCommands.push_back({ indexCount, static_cast<unsigned int>(range.InstanceCount), 0, 0, static_cast<unsigned int>(range.FirstInstance) });
+	}
+
+	const auto byteSize = static_cast<GLsizeiptr>(indirectCommands.size() * sizeof(DrawElementsIndirectCommand));
+	if (indirectCommands.size() > indirectCapacity) {
+		indirectCapacity = indirectCommands.size() + indirectCommands.size() / 2;
+		glNamedBufferData(indirectBufferObject, static_cast<GLsizeiptr>(indirectCapacity * sizeof(DrawElementsIndirectCommand)), nullptr, GL_STREAM_DRAW);
+	}
+	glNamedBufferSubData(indirectBufferObject, 0, byteSize, indirectCommands.data());
+
+	glBindVertexArray(vertexArrayObject);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBufferObject);
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(indirectCommands.size()), 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace Mesh {
+	class StaticMesh;
+}
+
+namespace Rendering {
+	// Per instance attributes read by the defaultInstanced shader
+	struct InstanceData {
+		glm::vec2 Offset;
+		glm::vec2 Scale;
+		// xy = uv of bottom left corner, zw = uv size
+		glm::vec4 UvRect;
+		// layer of an array texture, negative for 2D textures
+		float Layer = -1.0f;
+	};
+
+	// GL texture a batch of instances is drawn with
+	struct InstanceTexture {
+		unsigned int Id = 0;
+		// textureSheets stored as array textures, sampled by the instance's layer
+		bool IsArray = false;
+
+		bool operator<(const InstanceTexture& other) const { return Id != other.Id ? Id < other.Id : IsArray < other.IsArray; }
+		// 2D textures are bound to unit 0, array textures to unit 1
+		void Bind() const;
+	};
+
+	struct InstanceRange {
+		size_t FirstInstance;
+		size_t InstanceCount;
+	};
+
+	// Vertex array combining a mesh with a buffer of per instance data, attributes 2-5 advance once per instance.
+	class InstanceBuffer {
+		const Mesh::StaticMesh* mesh;
+		unsigned int vertexArrayObject = 0;
+		unsigned int instanceBufferObject = 0;
+		unsigned int indirectBufferObject = 0;
+		size_t capacity = 0;
+		size_t instanceCount = 0;
+		mutable size_t indirectCapacity = 0;
+
+		// layout defined by glMultiDrawElementsIndirect
+		struct DrawElementsIndirectCommand {
+			unsigned int Count;
+			unsigned int InstanceCount;
+			unsigned int FirstIndex;
+			int BaseVertex;
+			unsigned int BaseInstance;
+		};
+		mutable std::vector<DrawElementsIndirectCommand> indirectCommands;
+
+	public:
+		InstanceBuffer(const InstanceBuffer& other) = delete;
+		InstanceBuffer(InstanceBuffer&& other) noexcept = delete;
+		InstanceBuffer& operator=(const InstanceBuffer& other) = delete;
+		InstanceBuffer& operator=(InstanceBuffer&& other) noexcept = delete;
+
+		explicit InstanceBuffer(const Mesh::StaticMesh* mesh);
+		~InstanceBuffer();
+
+		void Upload(const std::vector<InstanceData>& instances);
+		void Draw(size_t firstInstance, size_t count) const;
+		void Draw() const { Draw(0, instanceCount); }
+		// Draws all ranges with a single indirect multi draw
+		void Draw(const std::vector<InstanceRange>& ranges) const;
+
+		size_t GetInstanceCount() const { return instanceCount; }
+	};
+}
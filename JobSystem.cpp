@@ -0,0 +1,123 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+#include "Profiler.h"
+
+void JobSystem::Initialize(unsigned int threadCount) {
+	if (isRunning) return;
+	if (threadCount == 0) {
+		const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	queues.clear();
+	for (unsigned int i = 0; i < threadCount; ++i) queues.push_back(std::make_unique<WorkerQueue>());
+	isRunning = true;
+	workers.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; ++i) workers.emplace_back(WorkerLoop, static_cast<int>(i));
+}
+
+void JobSystem::Schedule(std::function<void()> job) {
+	if (!isRunning) {
+		job();
+		return;
+	}
+	{
+		// counted before it is queued so the count never drops below zero. Workers check it under this lock before sleeping,
+		// so the notification can not be missed
+		std::lock_guard lock(sleepMutex);
+		++queuedJobCount;
+	}
+	const size_t index = workerIndex >= 0 ? static_cast<size_t>(workerIndex) : nextQueue++ % queues.size();
+	{
+		std::lock_guard lock(queues[index]->Mutex);
+		queues[index]->Jobs.push_back(std::move(job));
+	}
+	jobAvailable.notify_one();
+}
+
+bool JobSystem::TryPopJob(std::function<void()>& out_job) {
+	if (queuedJobCount == 0) return false;
+	const size_t queueCount = queues.size();
+	const size_t first = workerIndex >= 0 ? static_cast<size_t>(workerIndex) : 0;
+	for (size_t i = 0; i < queueCount; ++i) {
+		WorkerQueue& queue = *queues[(first + i) % queueCount];
+		std::lock_guard lock(queue.Mutex);
+		if (queue.Jobs.empty()) continue;
+		// own jobs newest first, their data is most likely still in cache. Stolen jobs oldest first
+		const bool isOwnQueue = i == 0 && workerIndex >= 0;
+		if (isOwnQueue) {
+			out_job = std::move(queue.Jobs.back());
+			queue.Jobs.pop_back();
+		}
+		else {
+			out_job = std::move(queue.Jobs.front());
+			queue.Jobs.pop_front();
+		}
+		--queuedJobCount;
+		return true;
+	}
+	return false;
+}
+
+bool JobSystem::RunPendingJob() {
+	std::function<void()> job;
+	if (queues.empty() || !TryPopJob(job)) return false;
+	PROFILE_SCOPE("Job");
+	job();
+	return true;
+}
+
+void JobSystem::ParallelFor(const size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& body) {
+	if (count == 0) return;
+	grainSize = std::max<size_t>(grainSize, 1);
+	if (!isRunning || count <= grainSize) {
+		body(0, count);
+		return;
+	}
+
+	// the first block runs on the calling thread
+	std::atomic<size_t> remaining = (count - 1) / grainSize;
+	for (size_t begin = grainSize; begin < count; begin += grainSize) {
+		const size_t end = std::min(begin + grainSize, count);
+		Schedule([&body, &remaining, begin, end] {
+			body(begin, end);
+			--remaining;
+		});
+	}
+	body(0, grainSize);
+	while (remaining > 0) {
+		if (!RunPendingJob()) std::this_thread::yield();
+	}
+}
+
+void JobSystem::Shutdown() {
+	{
+		std::lock_guard lock(sleepMutex);
+		if (!isRunning) return;
+		isRunning = false;
+	}
+	jobAvailable.notify_all();
+	for (auto& worker : workers) worker.join();
+	workers.clear();
+	queues.clear();
+}
+
+void JobSystem::WorkerLoop(const int index) {
+	Profiling::Profiler::SetThreadName("Worker");
+	workerIndex = index;
+	std::function<void()> job;
+	while (true) {
+		if (TryPopJob(job)) {
+			PROFILE_SCOPE("Job");
+			job();
+			job = nullptr;
+			continue;
+		}
+		std::unique_lock lock(sleepMutex);
+		jobAvailable.wait(lock, [] { return queuedJobCount > 0 || !isRunning; });
+		// drain remaining jobs before exiting
+		if (queuedJobCount == 0 && !isRunning) return;
+	}
+}
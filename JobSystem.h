@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads with one job queue each. Workers run their own newest jobs first and steal the oldest
+// jobs of other workers when they run out, so jobs scheduled from inside a job stay on the same thread while idle
+// workers still pick them up.
+class JobSystem {
+	struct WorkerQueue {
+		std::mutex Mutex;
+		std::deque<std::function<void()>> Jobs;
+	};
+
+	inline static std::vector<std::thread> workers;
+	inline static std::vector<std::unique_ptr<WorkerQueue>> queues;
+	// index into queues, -1 on threads that are not workers
+	inline static thread_local int workerIndex = -1;
+	// round robin queue for jobs scheduled from other threads
+	inline static std::atomic<size_t> nextQueue = 0;
+	inline static std::atomic<size_t> queuedJobCount = 0;
+	inline static std::mutex sleepMutex;
+	inline static std::condition_variable jobAvailable;
+	inline static std::atomic<bool> isRunning = false;
+
+	static void WorkerLoop(int index);
+	static bool TryPopJob(std::function<void()>& out_job);
+
+public:
+	// threadCount 0 uses one thread less than the hardware supports, leaving a core for the main thread
+	static void Initialize(unsigned int threadCount = 0);
+	// Runs the job on a worker, or immediately on the calling thread if there are no workers
+	static void Schedule(std::function<void()> job);
+	// Runs one queued job on the calling thread, returns false if there was none
+	static bool RunPendingJob();
+	// Calls body(begin, end) for blocks of at most grainSize indices in parallel and returns once all are done.
+	// The calling thread runs queued jobs while waiting, so it can be called from inside jobs.
+	static void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& body);
+	// Finishes all scheduled jobs before joining the workers
+	static void Shutdown();
+
+	static size_t GetWorkerCount() { return workers.size(); }
+};
@@ -1,6 +1,8 @@
 #include "Level.h"
 
 #include <utility>
+#include "BinaryFormat.h"
+#include "MappedFile.h"
 #include "Serialization.h"
 #include "TileMapManager.h"
 #include "Strings.h"
@@ -9,14 +11,76 @@ Level::Level(std::string name) : PersistentAsset(AssetId::CreateNewAssetId(), As
 	TileMapManagerUPtr = std::make_unique<Tiles::TileMapManager>();
 }
 
-bool Level::Deserialize(std::istream& iStream, const AssetHeader& header, Level*& out_Level) {
+bool Level::LoadFromFile(const char* relativePathToFile, Level*& out_Level, std::vector<::AssetId>* out_missingTiles) {
+	MappedFile file;
+	if (!file.Open(Files::GetAbsolutePath(relativePathToFile))) return false;
+
+	Serialization::MemoryStreamBuffer buffer(file.GetData(), file.GetSize());
+	std::istream stream(&buffer);
+	AssetHeader header;
+	if (!AssetHeader::Read(stream, &header)) {
+		std::cout << "Unable to read header of file: " << relativePathToFile << std::endl;
+		return false;
+	}
+	header.relativeAssetPath = relativePathToFile;
+
+	const size_t payloadOffset = buffer.GetPosition();
+	Serialization::BinaryReader reader(file.GetData() + payloadOffset, file.GetSize() - payloadOffset);
+	uint32_t magic = 0;
+	if (reader.Read(magic) && magic == BinaryMagic) {
+		return DeserializeBinary(reader, out_Level, out_missingTiles);
+	}
+
+	return Deserialize(stream, header, out_Level, out_missingTiles) && out_Level != nullptr;
+}
+
+bool Level::Deserialize(std::istream& iStream, const AssetHeader& header, Level*& out_Level, std::vector<::AssetId>* out_missingTiles) {
+	// the old format starts with the level name's length, the magic is far larger than any name could be
+	uint32_t magic = 0; Serialization::readFromStream(iStream, magic);
+	if (magic != BinaryMagic) {
+		if (magic > 2048) return false;
+		std::string name(magic, '\0');
+		iStream.read(name.data(), magic);
+		return DeserializeLegacy(iStream, std::move(name), out_Level, out_missingTiles);
+	}
+
+	const std::vector<char> payload((std::istreambuf_iterator<char>(iStream)), std::istreambuf_iterator<char>());
+	Serialization::BinaryReader reader(payload.data(), payload.size());
+	return DeserializeBinary(reader, out_Level, out_missingTiles);
+}
+
+bool Level::DeserializeBinary(Serialization::BinaryReader& reader, Level*& out_Level, std::vector<::AssetId>* out_missingTiles) {
+	uint32_t version = 0;
+	if (!reader.Read(version) || version < MinBinaryVersion || version > BinaryVersion) {
+		std::cout << "Unsupported level format version: " << version << std::endl;
+		return false;
+	}
+
+	auto levelUPTR = std::make_unique<Level>("");
+	uint32_t tileMapCount = 0;
+	if (!reader.ReadString32(levelUPTR->Name) || !reader.Read(tileMapCount)) return false;
+	for (uint32_t i = 0; i < tileMapCount; ++i) {
+		Tiles::TileMap* tileMap = nullptr;
+		if (!Tiles::TileMap::DeserializeBinary(reader, tileMap, out_missingTiles)) {
+			std::cout << "Unable to deserialize tileMap index: " << i << " for level: " << levelUPTR->Name << std::endl;
+			return false;
+		}
+		levelUPTR->TileMapManagerUPtr->tileMaps.push_back(tileMap);
+	}
+	out_Level = levelUPTR.release();
+	return true;
+}
+
+bool Level::DeserializeLegacy(std::istream& iStream, std::string name, Level*& out_Level, std::vector<::AssetId>* out_missingTiles) {
+	std::cout << "Migrating level '" << name << "' from legacy format, save it to convert." << std::endl;
 	auto levelUPTR = std::make_unique<Level>("");
-	levelUPTR->Name = Serialization::DeserializeStdString(iStream);
+	levelUPTR->Name = std::move(name);
 	size_t tileMapCount = 0; Serialization::readFromStream(iStream, tileMapCount);
 	for (auto i = 0; i < tileMapCount; ++i) {
 		Tiles::TileMap* tileMap = nullptr;
-		if (!Tiles::TileMap::Deserialize(iStream, tileMap)) {
+		if (!Tiles::TileMap::Deserialize(iStream, tileMap, out_missingTiles)) {
 			std::cout << "Unable to deserialize tileMap index: " << i << " for level: " << levelUPTR->Name << std::endl;
+			return false;
 		}
 		levelUPTR->TileMapManagerUPtr->tileMaps.push_back(tileMap);
 	}
@@ -43,9 +107,11 @@ bool Level::CanSave(std::string& out_errorMsg, bool allowOverwrite) const {
 }
 
 void Level::Serialize(std::ostream& oStream) const {
-	Serialization::Serialize(oStream, Name);
-	size_t tileMapCount = TileMapManagerUPtr->tileMaps.size();
-	Serialization::writeToStream(oStream, tileMapCount);
+	using namespace Serialization;
+	WriteLittleEndian(oStream, BinaryMagic);
+	WriteLittleEndian(oStream, BinaryVersion);
+	WriteString32(oStream, Name);
+	WriteLittleEndian(oStream, static_cast<uint32_t>(TileMapManagerUPtr->tileMaps.size()));
 	for (const auto& tileMap : TileMapManagerUPtr->tileMaps) {
 		tileMap->Serialize(oStream);
 	}
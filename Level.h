@@ -1,12 +1,30 @@
 #pragma once
+#include <vector>
 #include "Assets.h"
 
 namespace Tiles {
 	class TileMapManager;
 }
-class Level : public PersistentAsset<Level> {
+namespace Serialization {
+	class BinaryReader;
+}
 
+// Binary level format (after the asset header), all values little-endian:
+//   u32 magic 'LEVL', u32 version, string name, u32 tileMapCount, then per tileMap:
+//   string name, i32 type, i32 gridDimensions x/y, i32 tileDimensions x/y,
+//   u32 paletteCount + paletteCount tile asset id strings (palette index 0 = empty),
+//   u32 chunkCount + chunk table of (i32 x, i32 y, i32 tileCount),
+//   then per chunk in table order: u16 tileIndices[32*32], u8 masks[32*32].
+// Strings are u32 length + chars. Files without the magic are migrated from the old per tile format.
+class Level : public PersistentAsset<Level> {
+	static bool DeserializeLegacy(std::istream& iStream, std::string name, Level*& out_Level, std::vector<::AssetId>* out_missingTiles);
+	static bool DeserializeBinary(Serialization::BinaryReader& reader, Level*& out_Level, std::vector<::AssetId>* out_missingTiles);
 public:
+	static constexpr uint32_t BinaryMagic = 0x4C56454C; // "LEVL"
+	static constexpr uint32_t BinaryVersion = 2;
+	// version 1 is the legacy per tile format, which is detected by its missing magic instead
+	static constexpr uint32_t MinBinaryVersion = 2;
+
 	explicit Level(std::string name);
 	std::unique_ptr<Tiles::TileMapManager> TileMapManagerUPtr;
 
@@ -16,6 +34,9 @@ public:
 
 	bool CanSave(std::string& out_errorMsg, bool allowOverwrite = true) const override;
 
-	static bool Deserialize(std::istream& iStream, const AssetHeader& header, Level*& out_Level);
+	// Memory maps the file, hides PersistentAsset::LoadFromFile.
+	// Fails on tiles missing from Resources, unless out_missingTiles is given: their ids are added to it and their cells stay empty.
+	static bool LoadFromFile(const char* relativePathToFile, Level*& out_Level, std::vector<::AssetId>* out_missingTiles = nullptr);
+	static bool Deserialize(std::istream& iStream, const AssetHeader& header, Level*& out_Level, std::vector<::AssetId>* out_missingTiles = nullptr);
 	void Serialize(std::ostream& oStream) const override;
 };
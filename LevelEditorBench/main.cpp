@@ -0,0 +1,1508 @@
+// Headless benchmarks of the tileMap, autotiling, serialization and Resources hot paths. Results are written as JSON.
+// Correctness checks of the optimized structures run first, a failed check makes the bench exit with 1.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <SDL.h>
+
+#include "AssetId.h"
+#include "AssetLoader.h"
+#include "Assets.h"
+#include "AtlasPacker.h"
+#include "BinaryFormat.h"
+#include "glad.h"
+#include "Input.h"
+#include "ImportCache.h"
+#include "InputRecording.h"
+#include "JobSystem.h"
+#include "Level.h"
+#include "Prefab.h"
+#include "Resources.h"
+#include "stb_image_write.h"
+#include "Texture.h"
+#include "TextureAtlas.h"
+#include "TextureEncoder.h"
+#include "TextureSheet.h"
+#include "ThumbnailCache.h"
+#include "Tile.h"
+#include "TileInstance.h"
+#include "TileMap.h"
+#include "TileMapManager.h"
+#include "TilePatterns.h"
+
+// Allocation tracking, every allocation carries its size in a header
+namespace {
+	// keeps the returned pointer aligned for any fundamental type
+	constexpr size_t allocationHeaderSize = 16;
+	std::atomic<size_t> allocationCount{ 0 };
+	std::atomic<size_t> allocatedBytes{ 0 };
+	std::atomic<size_t> currentBytes{ 0 };
+	std::atomic<size_t> peakBytes{ 0 };
+}
+
+void* operator new(const size_t size) {
+	void* block = std::malloc(size + allocationHeaderSize);
+	if (block == nullptr) throw std::bad_alloc();
+	*static_cast<size_t*>(block) = size;
+
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	const size_t current = currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	size_t peak = peakBytes.load(std::memory_order_relaxed);
+	while (current > peak && !peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) { }
+	return static_cast<char*>(block) + allocationHeaderSize;
+}
+
+void operator delete(void* memory) noexcept {
+	if (memory == nullptr) return;
+	char* block = static_cast<char*>(memory) - allocationHeaderSize;
+	currentBytes.fetch_sub(*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+	std::free(block);
+}
+
+void* operator new[](const size_t size) { return operator new(size); }
+void operator delete[](void* memory) noexcept { operator delete(memory); }
+void operator delete(void* memory, size_t) noexcept { operator delete(memory); }
+void operator delete[](void* memory, size_t) noexcept { operator delete(memory); }
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	struct Options {
+		size_t MaxTiles = 10000000;
+		uint32_t Seed = 1337;
+		std::string OutputPath;
+		// input recording of the editor, replayed next to the generated event streams
+		std::string ReplayPath;
+		bool ChecksOnly = false;
+	};
+
+	struct Measurement {
+		std::string Name;
+		std::string Generator;
+		size_t Tiles = 0;
+		size_t Operations = 0;
+		double Seconds = 0;
+		size_t Allocations = 0;
+		size_t AllocatedBytes = 0;
+		// heap high-water mark during the measurement, relative to its start
+		size_t PeakHeapBytes = 0;
+		// e.g. tileMap memory or file size, 0 if not applicable
+		size_t DataBytes = 0;
+		// DataBytes is computed instead of measured, like GPU memory which the headless bench has none of
+		bool DataBytesEstimated = false;
+	};
+
+	std::vector<Measurement> results;
+	// results feed into this so the optimizer can not drop the measured work
+	volatile size_t checksum = 0;
+
+	bool checksFailed = false;
+
+	void Check(const bool condition, const char* description) {
+		if (condition) return;
+		std::cerr << "  CHECK FAILED: " << description << std::endl;
+		checksFailed = true;
+	}
+
+	Measurement Measure(const char* name, const std::string& generator, const size_t tiles, const size_t operations, const std::function<void()>& func) {
+		std::cerr << "  " << name << " (" << generator << ", " << tiles << " tiles)" << std::endl;
+		Measurement measurement{ name, generator, tiles, operations };
+
+		const size_t startAllocations = allocationCount.load();
+		const size_t startAllocatedBytes = allocatedBytes.load();
+		const size_t startBytes = currentBytes.load();
+		peakBytes.store(startBytes);
+
+		const auto start = Clock::now();
+		func();
+		measurement.Seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		measurement.Allocations = allocationCount.load() - startAllocations;
+		measurement.AllocatedBytes = allocatedBytes.load() - startAllocatedBytes;
+		measurement.PeakHeapBytes = peakBytes.load() - startBytes;
+		return measurement;
+	}
+
+	// Deterministic per position, independent of the standard library's distributions
+	uint32_t Hash(const int x, const int y, const uint32_t seed) {
+		uint32_t hash = static_cast<uint32_t>(x) * 0x8da6b343u ^ static_cast<uint32_t>(y) * 0xd8163841u ^ seed * 0xcb1ab31fu;
+		hash ^= hash >> 16;
+		hash *= 0x7feb352du;
+		hash ^= hash >> 15;
+		hash *= 0x846ca68bu;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+	float ValueNoise(const float x, const float y, const uint32_t seed) {
+		const int x0 = static_cast<int>(std::floor(x));
+		const int y0 = static_cast<int>(std::floor(y));
+		const auto smooth = [](const float t) { return t * t * (3.0f - 2.0f * t); };
+		const float tx = smooth(x - x0);
+		const float ty = smooth(y - y0);
+		const auto lattice = [seed](const int lx, const int ly) { return static_cast<float>(Hash(lx, ly, seed) & 0xFFFF) / 65535.0f; };
+		const float bottom = lattice(x0, y0) + (lattice(x0 + 1, y0) - lattice(x0, y0)) * tx;
+		const float top = lattice(x0, y0 + 1) + (lattice(x0 + 1, y0 + 1) - lattice(x0, y0 + 1)) * tx;
+		return bottom + (top - bottom) * ty;
+	}
+
+	struct Generator {
+		const char* Name;
+		// share of cells the predicate fills, used to size the generated area
+		float Density;
+		std::function<bool(int x, int y, uint32_t seed)> IsFilled;
+		// random positions are placed in random order, the others row by row like painting
+		bool Shuffle;
+	};
+
+	const std::vector<Generator>& GetGenerators() {
+		static const std::vector<Generator> generators{
+			{ "random", 0.5f, [](int x, int y, uint32_t seed) { return (Hash(x, y, seed) & 1) != 0; }, true },
+			{ "caves", 0.45f, [](int x, int y, uint32_t seed) {
+				const float noise = ValueNoise(x / 24.0f, y / 24.0f, seed) * 0.65f + ValueNoise(x / 8.0f, y / 8.0f, seed + 1) * 0.35f;
+				return noise > 0.52f;
+			}, false },
+			{ "rooms", 0.8f, [](int x, int y, uint32_t) {
+				// 12x9 rooms separated by single cell walls, with a door in the middle of each wall
+				const int roomX = ((x % 13) + 13) % 13;
+				const int roomY = ((y % 10) + 10) % 10;
+				return (roomX != 12 || roomY == 4) && (roomY != 9 || roomX == 6);
+			}, false },
+		};
+		return generators;
+	}
+
+	std::vector<glm::ivec2> GeneratePositions(const Generator& generator, const size_t tileCount, const uint32_t seed) {
+		std::vector<glm::ivec2> positions;
+		positions.reserve(tileCount);
+		int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(tileCount) / generator.Density)));
+		while (positions.size() < tileCount) {
+			positions.clear();
+			for (int y = -side / 2; y < side - side / 2 && positions.size() < tileCount; ++y) {
+				for (int x = -side / 2; x < side - side / 2 && positions.size() < tileCount; ++x) {
+					if (generator.IsFilled(x, y, seed)) positions.emplace_back(x, y);
+				}
+			}
+			side += side / 10 + 1;
+		}
+
+		if (generator.Shuffle) std::shuffle(positions.begin(), positions.end(), std::mt19937(seed));
+		return positions;
+	}
+
+	Rendering::Texture* CreateSyntheticTexture(const int index) {
+		Rendering::DecodedImage image;
+		image.AssetId = AssetId::CreateNewAssetId();
+		image.ImageFilePath = "Bench\\texture_" + std::to_string(index) + ".png";
+		image.Properties.width = 16;
+		image.Properties.height = 16;
+		image.Properties.channelCount = 4;
+		image.Properties.SetColorProfile();
+		image.Data = static_cast<unsigned char*>(std::malloc(16 * 16 * 4));
+
+		Rendering::Texture* texture = nullptr;
+		Rendering::Texture::CreateFromDecodedImage(image, texture);
+		Resources::AssignOwnership(texture);
+		return texture;
+	}
+
+	// AutoTile with every slot filled, the center slot has variants to exercise variant selection
+	Tiles::Tile* CreateSyntheticAutoTile(const char* name, int& textureIndex) {
+		auto* tile = new Tiles::Tile(AssetId::CreateNewAssetId(), std::string("Bench\\") + name + ".tile");
+		tile->SetType(Tiles::TileType::AutoTile);
+		for (size_t flag = 1; flag < Tiles::AutoTilePatternSlotCount; ++flag) {
+			tile->GetPattern()->AddTextureVariant(static_cast<int>(flag), Tiles::TextureVariant(CreateSyntheticTexture(textureIndex++)->AssetId));
+		}
+		for (int i = 0; i < 3; ++i) {
+			tile->GetPattern()->AddTextureVariant(static_cast<int>(Tiles::AutoTilePatternFlag::CENTER), Tiles::TextureVariant(CreateSyntheticTexture(textureIndex++)->AssetId));
+		}
+		Resources::AssignOwnership(tile);
+		return tile;
+	}
+
+	void WriteLevelFile(const Level& level, const std::filesystem::path& path) {
+		std::ofstream stream(path, std::iostream::binary);
+		AssetHeader::Write(stream, &level);
+		level.Serialize(stream);
+	}
+
+	void RunTileMapBenchmarks(const Generator& generator, const size_t tileCount, const Tiles::Tile* tileA, const Tiles::Tile* tileB,
+	                          const std::filesystem::path& outputDirectory, const uint32_t seed) {
+		const std::vector<glm::ivec2> positions = GeneratePositions(generator, tileCount, seed);
+
+		{
+			Tiles::TileMap tileMap("bench", Tiles::TileMapType::Floor);
+			auto insert = Measure("insert", generator.Name, tileCount, tileCount, [&] {
+				for (const auto& position : positions) tileMap.SetTile(tileA, position);
+			});
+			insert.DataBytes = tileMap.GetMemoryUsage();
+			results.push_back(insert);
+
+			results.push_back(Measure("erase", generator.Name, tileCount, tileCount, [&] {
+				for (const auto& position : positions) tileMap.RemoveTile(position);
+			}));
+			checksum += tileMap.GetTileCount();
+		}
+
+		{
+			// storage of TileMap before chunks, one heap node per cell. Stores cells only without autotiling,
+			// so its memory and lookups compare to "insert" and "lookup"
+			std::unordered_map<glm::ivec2, Tiles::TileInstance> cells;
+			const size_t startBytes = currentBytes.load();
+			auto insert = Measure("insert_unordered_map", generator.Name, tileCount, tileCount, [&] {
+				for (const auto& position : positions) cells[position] = Tiles::TileInstance(tileA, nullptr, Tiles::SurroundingTileFlags::NONE);
+			});
+			insert.DataBytes = currentBytes.load() - startBytes;
+			results.push_back(insert);
+
+			results.push_back(Measure("lookup_unordered_map", generator.Name, tileCount, tileCount * 2, [&] {
+				size_t found = 0;
+				for (const auto& position : positions) {
+					found += cells.find(position) != cells.end();
+					found += cells.find(position + glm::ivec2(1 << 20, 0)) != cells.end();
+				}
+				checksum += found;
+			}));
+		}
+
+		Level level("bench_" + std::string(generator.Name) + "_" + std::to_string(tileCount));
+		auto* tileMap = new Tiles::TileMap("bench", Tiles::TileMapType::Floor);
+		level.TileMapManagerUPtr->tileMaps.push_back(tileMap);
+
+		auto insertBatched = Measure("insert_batched", generator.Name, tileCount, tileCount, [&] {
+			tileMap->BeginEdit();
+			for (const auto& position : positions) tileMap->SetTile(tileA, position);
+			tileMap->CommitEdit();
+		});
+		insertBatched.DataBytes = tileMap->GetMemoryUsage();
+		results.push_back(insertBatched);
+
+		// every position once as a hit and once offset far outside the generated area
+		results.push_back(Measure("lookup", generator.Name, tileCount, tileCount * 2, [&] {
+			Tiles::TileInstance instance;
+			size_t found = 0;
+			for (const auto& position : positions) {
+				found += tileMap->TryGetTile(position, instance);
+				found += tileMap->TryGetTile(position + glm::ivec2(1 << 20, 0), instance);
+			}
+			checksum += found;
+		}));
+
+		// replacing every tile refreshes each cell and its neighbours' masks and textures
+		results.push_back(Measure("autotile_refresh", generator.Name, tileCount, tileCount, [&] {
+			tileMap->BeginEdit();
+			for (const auto& position : positions) tileMap->SetTile(tileB, position);
+			tileMap->CommitEdit();
+		}));
+
+		const std::filesystem::path levelPath = outputDirectory / (level.Name + AssetHeader::GetFileExtension(AssetType::Level));
+		auto save = Measure("save", generator.Name, tileCount, tileCount, [&] { WriteLevelFile(level, levelPath); });
+		save.DataBytes = std::filesystem::file_size(levelPath);
+		results.push_back(save);
+
+		auto load = Measure("load", generator.Name, tileCount, tileCount, [&] {
+			Level* loadedLevel = nullptr;
+			if (!Level::LoadFromFile(levelPath.string().c_str(), loadedLevel)) {
+				std::cerr << "Unable to load " << levelPath << std::endl;
+				return;
+			}
+			checksum += loadedLevel->TileMapManagerUPtr->tileMaps.front()->GetTileCount();
+			delete loadedLevel;
+		});
+		load.DataBytes = save.DataBytes;
+		results.push_back(load);
+
+		std::filesystem::remove(levelPath);
+	}
+
+	void RunFloodFillBenchmark(const Tiles::Tile* tileA, const Tiles::Tile* tileB) {
+		constexpr int size = 1000;
+		const glm::ivec2 boundsMin(-1), boundsMax(size);
+		Tiles::TileMap tileMap("bench", Tiles::TileMapType::Floor);
+		// empty region enclosed by a wall of tileB
+		for (int i = -1; i <= size; ++i) {
+			tileMap.SetTile(tileB, glm::ivec2(i, -1));
+			tileMap.SetTile(tileB, glm::ivec2(i, size));
+			tileMap.SetTile(tileB, glm::ivec2(-1, i));
+			tileMap.SetTile(tileB, glm::ivec2(size, i));
+		}
+		constexpr size_t area = static_cast<size_t>(size) * size;
+		results.push_back(Measure("flood_fill", "empty", area, area, [&] {
+			checksum += tileMap.FloodFill(tileA, glm::ivec2(size / 2), boundsMin, boundsMax, area);
+		}));
+		results.push_back(Measure("flood_fill", "replace", area, area, [&] {
+			checksum += tileMap.FloodFill(tileB, glm::ivec2(size / 2), boundsMin, boundsMax, area);
+		}));
+	}
+
+	// Painting one contiguous square, every edit refreshes its neighbours unless the paint is batched
+	void RunPaintBenchmark(const Tiles::Tile* tileA, const Tiles::Tile* tileB) {
+		constexpr int size = 512;
+		constexpr size_t area = static_cast<size_t>(size) * size;
+		const auto paint = [](Tiles::TileMap& tileMap, const Tiles::Tile* tile) {
+			for (int y = 0; y < size; ++y) {
+				for (int x = 0; x < size; ++x) tileMap.SetTile(tile, glm::ivec2(x, y));
+			}
+		};
+
+		{
+			Tiles::TileMap tileMap("bench", Tiles::TileMapType::Floor);
+			results.push_back(Measure("paint_unbatched", "square_512", area, area, [&] { paint(tileMap, tileA); }));
+			results.push_back(Measure("repaint_unbatched", "square_512", area, area, [&] { paint(tileMap, tileB); }));
+			checksum += tileMap.GetTileCount();
+		}
+
+		Tiles::TileMap tileMap("bench", Tiles::TileMapType::Floor);
+		results.push_back(Measure("paint_batched", "square_512", area, area, [&] {
+			tileMap.BeginEdit();
+			paint(tileMap, tileA);
+			tileMap.CommitEdit();
+		}));
+		results.push_back(Measure("repaint_batched", "square_512", area, area, [&] {
+			tileMap.BeginEdit();
+			paint(tileMap, tileB);
+			tileMap.CommitEdit();
+		}));
+		checksum += tileMap.GetTileCount();
+	}
+
+	void RunPrefabBenchmark(const Tiles::Tile* tileA, const Tiles::Tile* tileB, const uint32_t seed) {
+		constexpr int size = 256;
+		constexpr size_t area = static_cast<size_t>(size) * size;
+		Tiles::TileMap tileMap("bench", Tiles::TileMapType::Floor);
+		std::mt19937 rng(seed);
+		tileMap.BeginEdit();
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {
+				const uint32_t value = rng() % 4;
+				if (value != 0) tileMap.SetTile(value == 1 ? tileB : tileA, glm::ivec2(x, y));
+			}
+		}
+		tileMap.CommitEdit();
+
+		Tiles::Prefab prefab("bench");
+		results.push_back(Measure("prefab_copy", "random", area, area, [&] {
+			tileMap.CopyRegion(glm::ivec2(0), glm::ivec2(size - 1), prefab);
+		}));
+		// into empty space, then over the pasted copy
+		for (const char* target : { "empty", "replace" }) {
+			results.push_back(Measure("prefab_paste", target, area, area, [&] {
+				tileMap.PasteRegion(prefab, glm::ivec2(size * 2, 0));
+			}));
+		}
+		checksum += tileMap.GetTileCount();
+	}
+
+	void RunPatternBenchmark() {
+		constexpr size_t operations = 100000000;
+		results.push_back(Measure("autotile_pattern_lookup", "masks", 0, operations, [] {
+			size_t sum = 0;
+			for (size_t i = 0; i < operations; ++i) {
+				sum += static_cast<size_t>(Tiles::AutoTilePattern::PatternFromSurroundingTiles(static_cast<Tiles::SurroundingTileFlags>(i & 0xFF)));
+				sum += static_cast<size_t>(Tiles::AutoWallPattern::PatternFromSurroundingTiles(static_cast<Tiles::SurroundingTileFlags>((i * 7) & 0xFF)));
+			}
+			checksum += sum;
+		}));
+	}
+
+	void RunResourcesBenchmark(const uint32_t seed, int& textureIndex) {
+		constexpr size_t operations = 10000000;
+		for (const size_t textureCount : { 1000, 10000, 100000 }) {
+			std::vector<AssetId> ids;
+			ids.reserve(textureCount);
+			for (size_t i = 0; i < textureCount; ++i) ids.push_back(CreateSyntheticTexture(textureIndex++)->AssetId);
+			// a quarter of the lookups miss
+			std::vector<AssetId> missingIds(256);
+			for (auto& id : missingIds) id = AssetId::CreateNewAssetId();
+
+			std::mt19937 rng(seed);
+			std::vector<uint32_t> order(operations);
+			for (auto& index : order) index = rng();
+
+			auto lookup = Measure("resources_lookup", "textures", textureCount, operations, [&] {
+				size_t found = 0;
+				Rendering::Texture* texture = nullptr;
+				for (const uint32_t index : order) {
+					const AssetId& id = (index & 3) == 0 ? missingIds[(index >> 2) % missingIds.size()] : ids[(index >> 2) % ids.size()];
+					found += Resources::TryGetTexture(id, texture);
+				}
+				checksum += found;
+			});
+			results.push_back(lookup);
+
+			// Resources before AssetTable, keyed by the id strings that assets stored
+			std::map<std::string, Rendering::Texture*> textureMap;
+			std::vector<std::string> idStrings;
+			std::vector<std::string> missingIdStrings;
+			for (const auto& id : ids) {
+				Rendering::Texture* texture = nullptr;
+				Resources::TryGetTexture(id, texture);
+				idStrings.push_back(id.ToString());
+				textureMap.emplace(idStrings.back(), texture);
+			}
+			for (const auto& id : missingIds) missingIdStrings.push_back(id.ToString());
+
+			results.push_back(Measure("resources_lookup_string_map", "textures", textureCount, operations, [&] {
+				size_t found = 0;
+				for (const uint32_t index : order) {
+					const std::string& id = (index & 3) == 0 ? missingIdStrings[(index >> 2) % missingIdStrings.size()] : idStrings[(index >> 2) % idStrings.size()];
+					found += textureMap.find(id) != textureMap.end();
+				}
+				checksum += found;
+			}));
+		}
+	}
+
+	// Thumbnail creation from encoded images the size of a texture sheet, as done by the workers for the file browser
+	void RunThumbnailBenchmark(const uint32_t seed) {
+		constexpr int side = 1024;
+		constexpr size_t operations = 20;
+		std::vector<unsigned char> pixels(static_cast<size_t>(side) * side * 4);
+		for (size_t i = 0; i < pixels.size(); ++i) pixels[i] = static_cast<unsigned char>(Hash(static_cast<int>(i / 4 / 16), static_cast<int>(i % 4), seed));
+		std::vector<unsigned char> png;
+		stbi_write_png_to_func([](void* context, void* data, const int size) {
+			auto* bytes = static_cast<unsigned char*>(data);
+			static_cast<std::vector<unsigned char>*>(context)->insert(static_cast<std::vector<unsigned char>*>(context)->end(), bytes, bytes + size);
+		}, &png, side, side, 4, pixels.data(), side * 4);
+
+		auto hash = Measure("thumbnail_hash", "png_1024", 0, operations, [&] {
+			for (size_t i = 0; i < operations; ++i) checksum += Rendering::ThumbnailCache::HashContent(png.data(), png.size());
+		});
+		hash.DataBytes = png.size();
+		results.push_back(hash);
+
+		auto create = Measure("thumbnail_create", "png_1024", 0, operations, [&] {
+			std::vector<unsigned char> thumbnail;
+			for (size_t i = 0; i < operations; ++i) {
+				Rendering::ThumbnailCache::CreateThumbnailPixels(png.data(), png.size(), thumbnail);
+				checksum += thumbnail[thumbnail.size() / 2];
+			}
+		});
+		create.DataBytes = png.size();
+		results.push_back(create);
+	}
+
+	// The same sizes always pack to the same rects, padded rects stay inside the page without overlapping,
+	// and ExtrudeImage repeats the edge texels into the padding
+	void CheckAtlasPacker(const uint32_t seed) {
+		std::cerr << "  check atlas_packer" << std::endl;
+		constexpr int pageSize = 512;
+		constexpr int padding = 2;
+		std::mt19937 rng(seed);
+		std::vector<glm::ivec2> sizes(300);
+		for (auto& size : sizes) size = glm::ivec2(1 + rng() % 64, 1 + rng() % 64);
+
+		const auto pack = [&sizes](std::vector<glm::ivec4>& out_rects) {
+			Rendering::AtlasPacker packer(pageSize, pageSize, padding);
+			for (const auto& size : sizes) {
+				glm::ivec2 position;
+				if (packer.TryPack(size.x, size.y, position)) out_rects.emplace_back(position, size);
+			}
+		};
+		std::vector<glm::ivec4> rects;
+		std::vector<glm::ivec4> repeatedRects;
+		pack(rects);
+		pack(repeatedRects);
+		Check(rects.size() > sizes.size() / 2, "atlas packer packs most rects into a page");
+		Check(rects == repeatedRects, "atlas packing is deterministic");
+
+		bool inside = true;
+		bool apart = true;
+		for (size_t i = 0; i < rects.size(); ++i) {
+			const glm::ivec4& a = rects[i];
+			inside &= a.x - padding >= 0 && a.y - padding >= 0 && a.x + a.z + padding <= pageSize && a.y + a.w + padding <= pageSize;
+			for (size_t j = i + 1; j < rects.size(); ++j) {
+				const glm::ivec4& b = rects[j];
+				const bool overlapX = a.x - padding < b.x + b.z + padding && b.x - padding < a.x + a.z + padding;
+				const bool overlapY = a.y - padding < b.y + b.w + padding && b.y - padding < a.y + a.w + padding;
+				apart &= !(overlapX && overlapY);
+			}
+		}
+		Check(inside, "padded atlas rects stay inside the page");
+		Check(apart, "padded atlas rects do not overlap");
+
+		Rendering::AtlasPacker reusedPacker(pageSize, pageSize, padding);
+		std::vector<glm::ivec4> reusedRects;
+		for (const auto& size : sizes) {
+			glm::ivec2 position;
+			if (reusedPacker.TryPack(size.x, size.y, position)) reusedRects.emplace_back(position, size);
+		}
+		const glm::ivec4 released = reusedRects[reusedRects.size() / 2];
+		reusedPacker.Release(glm::ivec2(released), released.z, released.w);
+		glm::ivec2 reusedPosition;
+		Check(reusedPacker.TryPack(released.z, released.w, reusedPosition) && reusedPosition == glm::ivec2(released), "released atlas rect is handed out again");
+		for (const auto& rect : reusedRects) reusedPacker.Release(glm::ivec2(rect), rect.z, rect.w);
+		Check(reusedPacker.GetOccupancy() == 0.0f, "releasing every atlas rect empties the page");
+
+		// a full first page, then freeing one of its regions makes room there again
+		constexpr int spriteSize = Rendering::TextureAtlas::MaxImageSize;
+		constexpr int spritesPerPage = (Rendering::TextureAtlas::PageSize / (spriteSize + Rendering::TextureAtlas::Padding * 2)) *
+			(Rendering::TextureAtlas::PageSize / (spriteSize + Rendering::TextureAtlas::Padding * 2));
+		const std::vector<unsigned char> spritePixels(static_cast<size_t>(spriteSize) * spriteSize * 4, 255);
+		std::vector<AssetId> spriteIds(spritesPerPage + 1);
+		for (auto& id : spriteIds) {
+			id = AssetId::CreateNewAssetId();
+			Rendering::TextureAtlas::Submit(id, spritePixels.data(), spriteSize, spriteSize);
+		}
+		Rendering::AtlasRegion region;
+		Check(Rendering::TextureAtlas::GetPageCount() == 2 && Rendering::TextureAtlas::TryGetRegion(spriteIds.back(), region) && region.Page == 1, "texture atlas adds a page once the others are full");
+		Rendering::TextureAtlas::Remove(spriteIds.front());
+		const AssetId refilledId = AssetId::CreateNewAssetId();
+		Rendering::TextureAtlas::Submit(refilledId, spritePixels.data(), spriteSize, spriteSize);
+		Check(Rendering::TextureAtlas::TryGetRegion(refilledId, region) && region.Page == 0, "texture atlas fills space freed on an earlier page");
+		Rendering::TextureAtlas::Remove(refilledId);
+		for (const auto& id : spriteIds) Rendering::TextureAtlas::Remove(id);
+		Check(Rendering::TextureAtlas::GetPageOccupancy(0) == 0.0f && Rendering::TextureAtlas::GetPageOccupancy(1) == 0.0f, "removing every region empties the texture atlas");
+		Rendering::TextureAtlas::Free();
+
+		// every pixel unique, so a wrong source pixel shows up
+		constexpr int width = 5;
+		constexpr int height = 3;
+		std::vector<unsigned char> pixels(width * height * 4);
+		for (size_t i = 0; i < pixels.size(); ++i) pixels[i] = static_cast<unsigned char>(i);
+		std::vector<unsigned char> extruded;
+		Rendering::AtlasPacker::ExtrudeImage(pixels.data(), width, height, padding, extruded);
+		constexpr int paddedWidth = width + padding * 2;
+		constexpr int paddedHeight = height + padding * 2;
+		bool extrudedEdges = extruded.size() == static_cast<size_t>(paddedWidth) * paddedHeight * 4;
+		for (int y = 0; extrudedEdges && y < paddedHeight; ++y) {
+			for (int x = 0; x < paddedWidth; ++x) {
+				const int sourceX = std::clamp(x - padding, 0, width - 1);
+				const int sourceY = std::clamp(y - padding, 0, height - 1);
+				extrudedEdges &= std::memcmp(&extruded[(static_cast<size_t>(y) * paddedWidth + x) * 4], &pixels[(static_cast<size_t>(sourceY) * width + sourceX) * 4], 4) == 0;
+			}
+		}
+		Check(extrudedEdges, "ExtrudeImage repeats the edge texels into the padding");
+	}
+
+	// Decodes a BC7 mode 6 block as the GPU does, the only mode EncodeBC7Block writes. False for other modes
+	bool DecodeBC7Mode6Block(const unsigned char* block, unsigned char (&out_pixels)[16][4]) {
+		int position = 0;
+		const auto read = [block, &position](const int bitCount) {
+			unsigned int value = 0;
+			for (int bit = 0; bit < bitCount; ++bit, ++position) value |= (block[position >> 3] >> (position & 7) & 1u) << bit;
+			return static_cast<int>(value);
+		};
+		if (read(7) != 1 << 6) return false;
+		int endpoints[2][4];
+		for (int c = 0; c < 4; ++c) {
+			endpoints[0][c] = read(7) << 1;
+			endpoints[1][c] = read(7) << 1;
+		}
+		for (auto& endpoint : endpoints) {
+			const int pBit = read(1);
+			for (int& channel : endpoint) channel |= pBit;
+		}
+		constexpr int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+		for (int pixel = 0; pixel < 16; ++pixel) {
+			// the first index has an implicit 0 as its highest bit
+			const int weight = weights[read(pixel == 0 ? 3 : 4)];
+			for (int c = 0; c < 4; ++c) out_pixels[pixel][c] = static_cast<unsigned char>(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+		}
+		return true;
+	}
+
+	// Largest difference of any channel after encoding and decoding the block
+	int GetBC7RoundTripError(const unsigned char (&pixels)[16][4], bool& out_decoded) {
+		unsigned char block[Rendering::TextureEncoder::BC7BlockByteSize];
+		Rendering::TextureEncoder::EncodeBC7Block(pixels, block);
+		unsigned char decoded[16][4];
+		out_decoded &= DecodeBC7Mode6Block(block, decoded);
+		int error = 0;
+		for (int pixel = 0; pixel < 16; ++pixel) {
+			for (int c = 0; c < 4; ++c) error = std::max(error, std::abs(pixels[pixel][c] - decoded[pixel][c]));
+		}
+		return error;
+	}
+
+	// Solid blocks decode within the one step the shared lowest endpoint bit costs, opaque blocks stay opaque
+	// and gradients stay within a few steps
+	void CheckBC7RoundTrip(const uint32_t seed) {
+		std::cerr << "  check bc7_round_trip" << std::endl;
+		std::mt19937 rng(seed);
+		bool decoded = true;
+		int solidError = 0;
+		int gradientError = 0;
+		bool opaque = true;
+		for (int blockIndex = 0; blockIndex < 1000; ++blockIndex) {
+			unsigned char from[4];
+			unsigned char to[4];
+			for (int c = 0; c < 4; ++c) {
+				from[c] = static_cast<unsigned char>(rng());
+				to[c] = static_cast<unsigned char>(rng());
+			}
+
+			unsigned char pixels[16][4];
+			for (auto& pixel : pixels) std::memcpy(pixel, from, 4);
+			solidError = std::max(solidError, GetBC7RoundTripError(pixels, decoded));
+
+			for (int pixel = 0; pixel < 16; ++pixel) {
+				for (int c = 0; c < 4; ++c) pixels[pixel][c] = static_cast<unsigned char>(from[c] + (to[c] - from[c]) * pixel / 15);
+			}
+			gradientError = std::max(gradientError, GetBC7RoundTripError(pixels, decoded));
+
+			for (auto& pixel : pixels) {
+				for (int c = 0; c < 3; ++c) pixel[c] = static_cast<unsigned char>(rng());
+				pixel[3] = 255;
+			}
+			unsigned char block[Rendering::TextureEncoder::BC7BlockByteSize];
+			Rendering::TextureEncoder::EncodeBC7Block(pixels, block);
+			unsigned char opaqueDecoded[16][4];
+			decoded &= DecodeBC7Mode6Block(block, opaqueDecoded);
+			for (const auto& pixel : opaqueDecoded) opaque &= pixel[3] == 255;
+		}
+		Check(decoded, "bc7 blocks are encoded in mode 6");
+		Check(solidError <= 1, "solid bc7 blocks decode within 1 step per channel");
+		Check(opaque, "opaque bc7 blocks decode with alpha 255");
+		Check(gradientError <= 4, "gradient bc7 blocks decode within 4 steps per channel");
+	}
+
+	// Copy of the branching rules the pattern lookup tables replaced, kept to check the tables against
+	namespace LegacyPatterns {
+		using Tiles::SurroundingTileFlags;
+		using Tiles::AutoTilePatternFlag;
+		using Tiles::AutoWallPatternFlag;
+
+		int hasFlag(const SurroundingTileFlags& mask, const SurroundingTileFlags& flag) {
+			const int iFlag = static_cast<int>(flag);
+			return (static_cast<int>(mask) & iFlag) == iFlag;
+		}
+
+		AutoWallPatternFlag WallPattern(const SurroundingTileFlags& mask) {
+			const bool hasLeft = hasFlag(mask, SurroundingTileFlags::LEFT);
+			const bool hasRight = hasFlag(mask, SurroundingTileFlags::RIGHT);
+
+			if (hasLeft && hasRight) return AutoWallPatternFlag::CENTER;
+			if (hasLeft && !hasRight) return AutoWallPatternFlag::RIGHT;
+			if (hasRight && !hasLeft) return AutoWallPatternFlag::LEFT;
+			return AutoWallPatternFlag::SOLO;
+		}
+
+		AutoTilePatternFlag AutoTilePattern(const SurroundingTileFlags& mask) {
+			const bool left = hasFlag(mask, SurroundingTileFlags::LEFT);
+			const bool right = hasFlag(mask, SurroundingTileFlags::RIGHT);
+			const bool up = hasFlag(mask, SurroundingTileFlags::UP);
+			const bool down = hasFlag(mask, SurroundingTileFlags::DOWN);
+			const int straightSum = left + right + up + down;
+			const int diagonalSum = hasFlag(mask, SurroundingTileFlags::UP_LEFT) +
+				hasFlag(mask, SurroundingTileFlags::UP_RIGHT) +
+				hasFlag(mask, SurroundingTileFlags::DOWN_LEFT) +
+				hasFlag(mask, SurroundingTileFlags::DOWN_RIGHT);
+
+			if (straightSum + diagonalSum == 0) return AutoTilePatternFlag::SOLO;
+
+			if (straightSum == 1) {
+				if (right) return AutoTilePatternFlag::SINGLE_LEFT;
+				if (left) return AutoTilePatternFlag::SINGLE_RIGHT;
+				if (down) return AutoTilePatternFlag::SINGLE_TOP;
+				if (up) return AutoTilePatternFlag::SINGLE_BOT;
+			}
+
+			if (straightSum == 2) {
+				if (left && right) return AutoTilePatternFlag::HORIZONTAL_MIDDLE;
+				if (up && down) return AutoTilePatternFlag::VERTICAL_MIDDLE;
+			}
+
+			if (right && down && !up && !left) return AutoTilePatternFlag::OUTER_TOP_LEFT;
+			if (!right && down && !up && left) return AutoTilePatternFlag::OUTER_TOP_RIGHT;
+			if (!right && down && up && left) return AutoTilePatternFlag::OUTER_MID_RIGHT;
+			if (right && down && up && !left) return AutoTilePatternFlag::OUTER_MID_LEFT;
+			if (right && down && !up && left) return AutoTilePatternFlag::OUTER_TOP_MID;
+			if (right && !down && up && !left) return AutoTilePatternFlag::OUTER_BOT_LEFT;
+			if (!right && !down && up && left) return AutoTilePatternFlag::OUTER_BOT_RIGHT;
+			if (right && !down && up && left) return AutoTilePatternFlag::OUTER_BOT_MID;
+			if (right && up && left && !hasFlag(mask, SurroundingTileFlags::UP_RIGHT) && diagonalSum >= 3) return AutoTilePatternFlag::INNER_BOT_LEFT;
+			if (right && up && left && !hasFlag(mask, SurroundingTileFlags::UP_LEFT) && diagonalSum >= 3) return AutoTilePatternFlag::INNER_BOT_RIGHT;
+			if (right && up && left && !hasFlag(mask, SurroundingTileFlags::DOWN_RIGHT) && diagonalSum >= 3) return AutoTilePatternFlag::INNER_TOP_LEFT;
+			if (right && up && left && !hasFlag(mask, SurroundingTileFlags::DOWN_LEFT) && diagonalSum >= 3) return AutoTilePatternFlag::INNER_TOP_RIGHT;
+
+			return AutoTilePatternFlag::CENTER;
+		}
+	}
+
+	// Every one of the 256 neighbour masks maps to the same pattern as the old branching rules
+	void CheckTilePatterns() {
+		std::cerr << "  check tile_patterns" << std::endl;
+		bool autoTileMatches = true;
+		bool wallMatches = true;
+		for (int i = 0; i < 256; ++i) {
+			const auto mask = static_cast<Tiles::SurroundingTileFlags>(i);
+			autoTileMatches &= Tiles::AutoTilePattern::PatternFromSurroundingTiles(mask) == LegacyPatterns::AutoTilePattern(mask);
+			wallMatches &= Tiles::AutoWallPattern::PatternFromSurroundingTiles(mask) == LegacyPatterns::WallPattern(mask);
+		}
+		Check(autoTileMatches, "auto tile pattern table matches the branching rules for all 256 masks");
+		Check(wallMatches, "wall pattern table matches the branching rules for all 256 masks");
+	}
+
+	// A level referencing a tile that is not loaded fails to load, or loads without its cells when the missing ids are collected
+	void CheckLevelMissingTiles(const Tiles::Tile* tile, const std::filesystem::path& outputDirectory, int& textureIndex) {
+		std::cerr << "  check level_missing_tiles" << std::endl;
+		// never handed to Resources
+		const std::unique_ptr<Tiles::Tile> missingTile(new Tiles::Tile(AssetId::CreateNewAssetId(), "Bench\\missing.tile"));
+		missingTile->GetPattern()->AddTextureVariant(0, Tiles::TextureVariant(CreateSyntheticTexture(textureIndex++)->AssetId));
+
+		Level level("bench_missing_tiles");
+		auto* tileMap = new Tiles::TileMap("bench", Tiles::TileMapType::Floor);
+		level.TileMapManagerUPtr->tileMaps.push_back(tileMap);
+		tileMap->BeginEdit();
+		for (int x = 0; x < 8; ++x) {
+			tileMap->SetTile(tile, glm::ivec2(x, 0));
+			tileMap->SetTile(missingTile.get(), glm::ivec2(x, 1));
+		}
+		tileMap->CommitEdit();
+		const std::filesystem::path levelPath = outputDirectory / (level.Name + AssetHeader::GetFileExtension(AssetType::Level));
+		WriteLevelFile(level, levelPath);
+
+		Level* loadedLevel = nullptr;
+		Check(!Level::LoadFromFile(levelPath.string().c_str(), loadedLevel), "level with a missing tile fails to load");
+
+		std::vector<AssetId> missingTiles;
+		loadedLevel = nullptr;
+		const bool loaded = Level::LoadFromFile(levelPath.string().c_str(), loadedLevel, &missingTiles);
+		const std::unique_ptr<Level> loadedLevelUPTR(loaded ? loadedLevel : nullptr);
+		Check(loaded, "level with a missing tile loads when missing tiles are collected");
+		Check(missingTiles.size() == 1 && missingTiles.front() == missingTile->AssetId, "the missing tile id is reported");
+		Check(loaded && loadedLevel->TileMapManagerUPtr->tileMaps.front()->GetTileCount() == 8, "cells of the missing tile are left empty");
+
+		std::filesystem::remove(levelPath);
+	}
+
+	// Corrupt chunk tables fail to load instead of allocating for them or corrupting the chunk and palette counts,
+	// and chunks whose tiles are all missing are not created
+	void CheckTileMapCorruptInput(const Tiles::Tile* tile) {
+		std::cerr << "  check tilemap_corrupt_input" << std::endl;
+		Tiles::TileMap tileMap("bench", Tiles::TileMapType::Floor);
+		tileMap.BeginEdit();
+		for (int x = 0; x < 4; ++x) tileMap.SetTile(tile, glm::ivec2(x * Tiles::TileChunk::Size, 0));
+		tileMap.CommitEdit();
+		std::ostringstream stream;
+		tileMap.Serialize(stream);
+		const std::string bytes = stream.str();
+
+		// the chunk table and tile blocks end the tileMap
+		const size_t chunkCount = tileMap.GetChunkCount();
+		constexpr size_t entryByteSize = sizeof(int32_t) * 3;
+		constexpr size_t blockByteSize = sizeof(Tiles::TileChunk::TileIndices) + sizeof(Tiles::TileChunk::Masks);
+		const size_t chunkCountOffset = bytes.size() - chunkCount * (entryByteSize + blockByteSize) - sizeof(uint32_t);
+		const size_t firstEntryOffset = chunkCountOffset + sizeof(uint32_t);
+		const size_t firstBlockOffset = firstEntryOffset + chunkCount * entryByteSize;
+		const auto load = [](const std::string& data, std::unique_ptr<Tiles::TileMap>& out_tileMap) {
+			Serialization::BinaryReader reader(data.data(), data.size());
+			Tiles::TileMap* loaded = nullptr;
+			const bool success = Tiles::TileMap::DeserializeBinary(reader, loaded);
+			out_tileMap.reset(success ? loaded : nullptr);
+			return success;
+		};
+		const auto writeInt = [](std::string& data, const size_t offset, const uint32_t value) {
+			for (size_t i = 0; i < sizeof(value); ++i) data[offset + i] = static_cast<char>(value >> i * 8 & 0xFF);
+		};
+
+		std::unique_ptr<Tiles::TileMap> loaded;
+		Check(load(bytes, loaded) && loaded->GetChunkCount() == chunkCount && loaded->GetTileCount() == 4, "tileMap round trips through its binary format");
+
+		std::string corrupt = bytes;
+		writeInt(corrupt, chunkCountOffset, UINT32_MAX);
+		Check(!load(corrupt, loaded), "chunk count larger than the file fails to load");
+
+		corrupt = bytes;
+		corrupt.replace(firstEntryOffset + entryByteSize, sizeof(int32_t) * 2, bytes, firstEntryOffset, sizeof(int32_t) * 2);
+		Check(!load(corrupt, loaded), "duplicate chunk coordinates fail to load");
+
+		corrupt = bytes;
+		writeInt(corrupt, firstEntryOffset + sizeof(int32_t) * 2, 2);
+		Check(!load(corrupt, loaded), "chunk tile count that differs from its block fails to load");
+
+		corrupt = bytes;
+		writeInt(corrupt, firstEntryOffset + sizeof(int32_t) * 2, 0);
+		std::fill(corrupt.begin() + static_cast<std::ptrdiff_t>(firstBlockOffset), corrupt.begin() + static_cast<std::ptrdiff_t>(firstBlockOffset + sizeof(Tiles::TileChunk::TileIndices)), '\0');
+		Check(load(corrupt, loaded) && loaded->GetChunkCount() == chunkCount - 1 && loaded->GetTileCount() == 3, "chunks without tiles are not created");
+	}
+
+	// The array layers of a sheet read back from the GPU hold its slices and compressed textures keep only complete, block aligned levels.
+	// Needs a GL 4.5 context, which the rest of the bench does without
+	void CheckTextureSheetArrayLayers(const std::filesystem::path& outputDirectory) {
+		std::cerr << "  check texture_sheet_array_layers" << std::endl;
+		SDL_Init(SDL_INIT_VIDEO);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
+		SDL_Window* window = SDL_CreateWindow("LevelEditorBench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 1, 1, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+		const SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+		if (!context || !gladLoadGLLoader((GLADloadproc)SDL_GL_GetProcAddress)) {
+			std::cerr << "    skipped, unable to create a gl context " << SDL_GetError() << std::endl;
+			if (context) SDL_GL_DeleteContext(context);
+			if (window) SDL_DestroyWindow(window);
+			SDL_Quit();
+			return;
+		}
+
+		// two rows of slices, so a layer copied from the wrong row or unflipped differs
+		constexpr int sliceSide = 16;
+		constexpr int columns = 3;
+		constexpr int rows = 2;
+		constexpr int width = columns * sliceSide;
+		constexpr int height = rows * sliceSide;
+		std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 4);
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				unsigned char* pixel = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+				pixel[0] = static_cast<unsigned char>(x * 5);
+				pixel[1] = static_cast<unsigned char>(y * 7);
+				pixel[2] = static_cast<unsigned char>((y / sliceSide * columns + x / sliceSide) * 40);
+				pixel[3] = 255;
+			}
+		}
+		const std::filesystem::path imagePath = outputDirectory / "array_layers.png";
+		stbi_write_png(imagePath.string().c_str(), width, height, 4, pixels.data(), width * 4);
+
+		Rendering::Texture::SetHeadless(false);
+		Rendering::TextureSheet* sheet = nullptr;
+		AssetHeader header;
+		const bool created = Rendering::TextureSheet::CreateNew(imagePath, sheet, header);
+		Check(created, "textureSheet is created from a png");
+		if (created) {
+			sheet->SetStorage(Rendering::TextureSheetStorage::ArrayLayers);
+			Check(sheet->SubTextures.size() == columns * rows, "textureSheet is sliced into 16x16 subTextures");
+
+			bool hasLayers = true;
+			bool layersMatch = true;
+			std::vector<unsigned char> layerPixels(sliceSide * sliceSide * 4);
+			for (size_t i = 0; i < sheet->SubTextures.size(); ++i) {
+				unsigned int arrayTextureId = 0;
+				int layer = -1;
+				if (!sheet->SubTextures[i]->TryGetArrayLayer(arrayTextureId, layer)) {
+					hasLayers = false;
+					continue;
+				}
+				glGetTextureSubImage(arrayTextureId, 0, 0, 0, layer, sliceSide, sliceSide, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+				                     static_cast<GLsizei>(layerPixels.size()), layerPixels.data());
+				// layers are bottom row first, the png is top row first
+				const auto& data = sheet->SubTextureData[i];
+				for (int row = 0; row < sliceSide; ++row) {
+					const size_t source = (static_cast<size_t>(data.yOffset + sliceSide - 1 - row) * width + data.xOffset) * 4;
+					layersMatch &= std::memcmp(layerPixels.data() + static_cast<size_t>(row) * sliceSide * 4, pixels.data() + source, sliceSide * 4) == 0;
+				}
+			}
+			Check(hasLayers, "every subTexture of the sheet has an array layer");
+			Check(layersMatch, "array layers read back as the sheet's slices");
+
+			// 16x16 slices keep 2 levels of 4x4 blocks
+			sheet->SetCompression(Rendering::TextureCompression::BC7);
+			GLint maxLevel = 0;
+			glGetTextureParameteriv(sheet->GetMainTexture()->GetTextureID(), GL_TEXTURE_MAX_LEVEL, &maxLevel);
+			Check(maxLevel == 2, "compressed sheet keeps the mip levels whose slices stay block aligned");
+
+			for (const Rendering::Texture* subTexture : sheet->SubTextures) Resources::ReleaseOwnership(subTexture, true);
+			Resources::ReleaseOwnership(sheet->GetMainTexture(), true);
+			std::filesystem::remove(sheet->GetRelativeAssetPath());
+			delete sheet;
+		}
+
+		// only levels 0 and 1 of a 16x16 image
+		Rendering::DecodedImage truncated;
+		truncated.AssetId = AssetId::CreateNewAssetId();
+		truncated.Properties.width = truncated.Properties.height = 16;
+		truncated.Properties.channelCount = 4;
+		truncated.Properties.SetColorProfile();
+		truncated.Compression = Rendering::TextureCompression::BC7;
+		truncated.EncodedLevels.resize(Rendering::TextureEncoder::GetEncodedSize(Rendering::TextureCompression::BC7, 16, 16) +
+		                               Rendering::TextureEncoder::GetEncodedSize(Rendering::TextureCompression::BC7, 8, 8));
+		Rendering::Texture* truncatedTexture = nullptr;
+		if (Rendering::Texture::CreateFromDecodedImage(truncated, truncatedTexture)) {
+			GLint maxLevel = 0;
+			glGetTextureParameteriv(truncatedTexture->GetTextureID(), GL_TEXTURE_MAX_LEVEL, &maxLevel);
+			Check(maxLevel == 1, "texture with a truncated encoded chain is sampled up to its last level");
+			Resources::ReleaseOwnership(truncatedTexture, true);
+		}
+		else Check(false, "texture with a truncated encoded chain is created");
+
+		Rendering::Texture::SetHeadless(true);
+		std::filesystem::remove(imagePath);
+
+		SDL_GL_DeleteContext(context);
+		SDL_DestroyWindow(window);
+		SDL_Quit();
+	}
+
+	// Initialize deletes the least recently read entries beyond the size cap
+	void CheckImportCachePrune(const std::filesystem::path& outputDirectory) {
+		std::cerr << "  check import_cache_prune" << std::endl;
+		const std::filesystem::path cacheDirectory = outputDirectory / "import_cache_prune";
+		std::filesystem::remove_all(cacheDirectory);
+		std::filesystem::create_directories(cacheDirectory);
+		Rendering::ImportCache::Initialize(cacheDirectory);
+
+		constexpr int side = 16;
+		constexpr uint64_t entryCount = 4;
+		for (uint64_t key = 0; key < entryCount; ++key) {
+			Rendering::DecodedImage image;
+			image.Properties.width = image.Properties.height = side;
+			image.Data = static_cast<unsigned char*>(calloc(side * side * 4, 1));
+			Rendering::ImportCache::Write(key, image);
+			free(image.Data);
+		}
+		// entry names are their zero padded keys, written an hour apart in key order
+		std::vector<std::filesystem::path> entryPaths;
+		for (const auto& entry : std::filesystem::directory_iterator(cacheDirectory)) entryPaths.push_back(entry.path());
+		std::sort(entryPaths.begin(), entryPaths.end());
+		const auto now = std::filesystem::file_time_type::clock::now();
+		for (size_t i = 0; i < entryPaths.size(); ++i) std::filesystem::last_write_time(entryPaths[i], now - std::chrono::hours(entryPaths.size() - i));
+		Check(entryPaths.size() == entryCount, "import cache writes one file per entry");
+
+		Rendering::DecodedImage firstImage;
+		Check(Rendering::ImportCache::TryRead(0, firstImage), "import cache entry is read");
+		free(firstImage.Data);
+
+		Rendering::ImportCache::Initialize(cacheDirectory, std::filesystem::file_size(entryPaths.back()) * 2);
+		bool keptRecentlyRead = true;
+		for (uint64_t key = 0; key < entryCount; ++key) {
+			Rendering::DecodedImage image;
+			keptRecentlyRead &= Rendering::ImportCache::TryRead(key, image) == (key == 0 || key == entryCount - 1);
+			free(image.Data);
+		}
+		Check(keptRecentlyRead, "import cache keeps the most recently read entries within its size cap");
+
+		Rendering::ImportCache::Close();
+		std::filesystem::remove_all(cacheDirectory);
+	}
+
+	// More thumbnails finished in one frame than the atlas has slots are uploaded once slots free up, without being decoded again,
+	// and the pack file stays within its thumbnail count
+	void CheckThumbnailCache(const std::filesystem::path& outputDirectory) {
+		std::cerr << "  check thumbnail_cache" << std::endl;
+		const std::filesystem::path imageDirectory = outputDirectory / "thumbnail_cache";
+		std::filesystem::remove_all(imageDirectory);
+		std::filesystem::create_directories(imageDirectory);
+		constexpr size_t maxPackThumbnails = 8;
+		const std::filesystem::path packPath = imageDirectory / "thumbnails.pack";
+		Rendering::ThumbnailCache::Initialize(packPath, maxPackThumbnails);
+
+		constexpr size_t slotCount = static_cast<size_t>(Rendering::ThumbnailCache::SlotsPerRow) * Rendering::ThumbnailCache::SlotsPerRow;
+		std::vector<std::string> imagePaths(slotCount + 1);
+		for (size_t i = 0; i < imagePaths.size(); ++i) {
+			// unique content, so every image gets its own pack record
+			const uint32_t pixel = static_cast<uint32_t>(i) | 0xFF000000u;
+			imagePaths[i] = (imageDirectory / (std::to_string(i) + ".png")).string();
+			stbi_write_png(imagePaths[i].c_str(), 1, 1, 4, &pixel, 4);
+		}
+
+		const auto runFrame = [](const std::vector<std::string>& drawnPaths) {
+			JobSystem::Initialize();
+			Rendering::Thumbnail thumbnail;
+			for (const auto& path : drawnPaths) Rendering::ThumbnailCache::TryGetThumbnail(path, thumbnail);
+			// drains the queues
+			JobSystem::Shutdown();
+			Rendering::ThumbnailCache::Update();
+		};
+		runFrame(imagePaths);
+		// decoding any image again fails from here on
+		for (const auto& path : imagePaths) std::filesystem::remove(path);
+		// workers finish in any order, so which one waits differs
+		std::vector<std::string> waitingPaths;
+		Rendering::Thumbnail thumbnail;
+		for (const auto& path : imagePaths) {
+			if (!Rendering::ThumbnailCache::TryGetThumbnail(path, thumbnail)) waitingPaths.push_back(path);
+		}
+		Check(waitingPaths.size() == 1, "thumbnail cache fills every atlas slot in one frame");
+
+		// the waiting one is not requested again, it has to take a slot drawn last frame
+		runFrame({});
+		Check(!waitingPaths.empty() && Rendering::ThumbnailCache::TryGetThumbnail(waitingPaths.front(), thumbnail), "thumbnail waiting for an atlas slot is uploaded once one frees up");
+
+		constexpr uint64_t packRecordSize = sizeof(uint64_t) + static_cast<uint64_t>(Rendering::ThumbnailCache::ThumbnailSize) * Rendering::ThumbnailCache::ThumbnailSize * 4;
+		Check(std::filesystem::file_size(packPath) <= 8 + maxPackThumbnails * packRecordSize, "thumbnail pack file is compacted to its thumbnail count");
+
+		Rendering::ThumbnailCache::Free();
+		std::filesystem::remove_all(imageDirectory);
+	}
+
+	// GPU bytes of an rgba texture with a full mip chain
+	size_t GetMipChainBytes(int width, int height) {
+		size_t bytes = 0;
+		while (true) {
+			bytes += static_cast<size_t>(width) * height * 4;
+			if (width == 1 && height == 1) return bytes;
+			width = std::max(width / 2, 1);
+			height = std::max(height / 2, 1);
+		}
+	}
+
+	// Import of a 4096x4096 sheet sliced into 16x16 subTextures. "per_slice_copies_cpu" repeats the CPU work of the previous import,
+	// which decoded the image three times and copied, flipped and uploaded every slice as its own texture. The bench has no GL context,
+	// so neither case times GPU uploads, and their VRAM is estimated from the textures each import creates.
+	void RunTextureSheetBenchmark(const std::filesystem::path& outputDirectory, const uint32_t seed) {
+		constexpr int side = 4096;
+		constexpr int sliceSide = 16;
+		constexpr int slicesPerRow = side / sliceSide;
+		constexpr size_t sliceCount = static_cast<size_t>(slicesPerRow) * slicesPerRow;
+
+		std::vector<unsigned char> pixels(static_cast<size_t>(side) * side * 4);
+		for (size_t i = 0; i < pixels.size(); ++i) {
+			const int x = static_cast<int>(i / 4 % side);
+			const int y = static_cast<int>(i / 4 / side);
+			pixels[i] = static_cast<unsigned char>(Hash(x / sliceSide, y / sliceSide, seed + static_cast<uint32_t>(i % 4)));
+		}
+		const std::string imagePath = (outputDirectory / "sheet_4096.png").string();
+		stbi_write_png(imagePath.c_str(), side, side, 4, pixels.data(), side * 4);
+		pixels = {};
+
+		std::vector<Rendering::SubTextureData> subTextureData(sliceCount);
+		for (size_t i = 0; i < sliceCount; ++i) {
+			auto& data = subTextureData[i];
+			data.xOffset = static_cast<int>(i % slicesPerRow) * sliceSide;
+			data.yOffset = static_cast<int>(i / slicesPerRow) * sliceSide;
+			data.width = data.height = sliceSide;
+			data.assetId = AssetId::CreateNewAssetId();
+		}
+
+		auto copies = Measure("sheet_import", "per_slice_copies_cpu", 0, sliceCount, [&] {
+			for (int decode = 0; decode < 3; ++decode) {
+				Rendering::DecodedImage image;
+				if (!Rendering::Texture::DecodeImage(imagePath, image)) return;
+				if (decode == 1) {
+					std::vector<unsigned char> slice(sliceSide * sliceSide * 4);
+					const size_t rowBytes = sliceSide * 4;
+					for (const auto& data : subTextureData) {
+						// rows copied in reverse, which is the copy and flip of the previous import
+						for (int row = 0; row < sliceSide; ++row) {
+							const size_t source = (static_cast<size_t>(data.yOffset + row) * side + data.xOffset) * 4;
+							std::memcpy(slice.data() + (sliceSide - 1 - row) * rowBytes, image.Data + source, rowBytes);
+						}
+						checksum += slice[0];
+					}
+				}
+				free(image.Data);
+			}
+		});
+		copies.DataBytes = GetMipChainBytes(side, side) + sliceCount * GetMipChainBytes(sliceSide, sliceSide);
+		copies.DataBytesEstimated = true;
+		results.push_back(copies);
+
+		auto views = Measure("sheet_import", "views", 0, sliceCount, [&] {
+			Rendering::DecodedImage image;
+			if (!Rendering::Texture::DecodeImage(imagePath, image)) return;
+			image.AssetId = AssetId::CreateNewAssetId();
+			Rendering::Texture* sheetTexture = nullptr;
+			Rendering::Texture::CreateFromDecodedImage(image, sheetTexture);
+			std::vector<Rendering::Texture*> subTextures;
+			sheetTexture->CreateSubTextures(subTextureData, subTextures);
+			checksum += subTextures.size();
+			for (const Rendering::Texture* subTexture : subTextures) Resources::ReleaseOwnership(subTexture, true);
+			Resources::ReleaseOwnership(sheetTexture, true);
+		});
+		views.DataBytes = GetMipChainBytes(side, side);
+		views.DataBytesEstimated = true;
+		results.push_back(views);
+
+		std::filesystem::remove(imagePath);
+	}
+
+	// 512x512 noise PNGs, returns their total file size
+	size_t WriteDecodeImages(const std::filesystem::path& outputDirectory, const uint32_t seed, std::vector<std::string>& out_imagePaths) {
+		constexpr int side = 512;
+		constexpr size_t imageCount = 64;
+		std::vector<unsigned char> pixels(static_cast<size_t>(side) * side * 4);
+		size_t fileBytes = 0;
+		for (size_t image = 0; image < imageCount; ++image) {
+			for (size_t i = 0; i < pixels.size(); ++i) {
+				pixels[i] = static_cast<unsigned char>(Hash(static_cast<int>(i / 4 % side / 8), static_cast<int>(i / 4 / side / 8), seed + static_cast<uint32_t>(image * 4 + i % 4)));
+			}
+			out_imagePaths.push_back((outputDirectory / ("decode_" + std::to_string(image) + ".png")).string());
+			stbi_write_png(out_imagePaths.back().c_str(), side, side, 4, pixels.data(), side * 4);
+			fileBytes += std::filesystem::file_size(out_imagePaths.back());
+		}
+		return fileBytes;
+	}
+
+	// Decodes all images on the job system as AssetLoader schedules them
+	void DecodeImages(const std::vector<std::string>& imagePaths, const unsigned int threads,
+	                  const Rendering::TextureCompression compression = Rendering::TextureCompression::None) {
+		JobSystem::Initialize(threads);
+		std::atomic<size_t> decodedBytes = 0;
+		for (const auto& path : imagePaths) {
+			JobSystem::Schedule([&path, &decodedBytes, compression] {
+				Rendering::DecodedImage image;
+				if (!Rendering::Texture::DecodeImage(path, image, compression)) return;
+				decodedBytes += image.Mips.GetByteSize() + image.EncodedLevels.size();
+				free(image.Data);
+			});
+		}
+		// drains the queues
+		JobSystem::Shutdown();
+		checksum += decodedBytes;
+	}
+
+	// Decoding and mip generation of a directory of sprites, for 1 worker up to one per core
+	void RunDecodeBenchmark(const std::filesystem::path& outputDirectory, const uint32_t seed) {
+		std::vector<std::string> imagePaths;
+		const size_t fileBytes = WriteDecodeImages(outputDirectory, seed, imagePaths);
+
+		const unsigned int coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+		for (unsigned int threads = 1;; threads = std::min(threads * 2, coreCount)) {
+			auto decode = Measure("image_decode", "png_512_threads_" + std::to_string(threads), 0, imagePaths.size(), [&] {
+				DecodeImages(imagePaths, threads);
+			});
+			decode.DataBytes = fileBytes;
+			results.push_back(decode);
+			if (threads == coreCount) break;
+		}
+
+		for (const auto& path : imagePaths) std::filesystem::remove(path);
+	}
+
+	// Startup decoding with an empty import cache, which also fills it, and again with the filled cache.
+	// BC7 cold includes encoding, cache bytes are what is uploaded to the GPU
+	void RunImportCacheBenchmark(const std::filesystem::path& outputDirectory, const uint32_t seed) {
+		std::vector<std::string> imagePaths;
+		WriteDecodeImages(outputDirectory, seed, imagePaths);
+		const std::filesystem::path cacheDirectory = outputDirectory / "import_cache";
+
+		const auto getCacheBytes = [&cacheDirectory] {
+			size_t bytes = 0;
+			for (const auto& entry : std::filesystem::directory_iterator(cacheDirectory)) bytes += entry.file_size();
+			return bytes;
+		};
+		for (const auto compression : { Rendering::TextureCompression::None, Rendering::TextureCompression::BC7 }) {
+			std::filesystem::remove_all(cacheDirectory);
+			std::filesystem::create_directories(cacheDirectory);
+			Rendering::ImportCache::Initialize(cacheDirectory);
+			const std::string suffix = compression == Rendering::TextureCompression::None ? "" : "_bc7";
+
+			auto cold = Measure("texture_import", "cold_cache" + suffix, 0, imagePaths.size(), [&] { DecodeImages(imagePaths, 0, compression); });
+			cold.DataBytes = getCacheBytes();
+			results.push_back(cold);
+			auto warm = Measure("texture_import", "warm_cache" + suffix, 0, imagePaths.size(), [&] { DecodeImages(imagePaths, 0, compression); });
+			warm.DataBytes = getCacheBytes();
+			results.push_back(warm);
+			if (Rendering::ImportCache::GetHitCount() != imagePaths.size()) std::cerr << "  import cache missed warm reads" << std::endl;
+		}
+
+		Rendering::ImportCache::Close();
+		std::filesystem::remove_all(cacheDirectory);
+		for (const auto& path : imagePaths) std::filesystem::remove(path);
+	}
+
+	// A texture meta file as Texture::SaveToFile writes it, without loading the texture
+	void WriteTextureAssetFile(const std::string& imagePath) {
+		std::ofstream stream(imagePath + AssetHeader::FileExtension, std::iostream::binary);
+		Serialization::writeToStream(stream, AssetHeader::Header);
+		Serialization::writeToStream(stream, static_cast<uint8_t>(AssetType::Texture));
+		Serialization::Serialize(stream, AssetId::CreateNewAssetId());
+		Serialization::writeToStream(stream, false);
+		Serialization::Serialize(stream, imagePath);
+		Serialization::writeToStream(stream, Rendering::TextureCompression::None);
+	}
+
+	// Startup loading of a sprite library, decoded by the job system and uploaded on the calling thread
+	void RunAssetLoaderBenchmark(const std::filesystem::path& outputDirectory, const uint32_t seed) {
+		constexpr int side = 32;
+		constexpr size_t textureCount = 4096;
+		const std::filesystem::path libraryDirectory = outputDirectory / "asset_library";
+		std::filesystem::remove_all(libraryDirectory);
+		std::filesystem::create_directories(libraryDirectory);
+
+		std::vector<unsigned char> pixels(static_cast<size_t>(side) * side * 4);
+		size_t fileBytes = 0;
+		for (size_t texture = 0; texture < textureCount; ++texture) {
+			for (size_t i = 0; i < pixels.size(); ++i) {
+				pixels[i] = static_cast<unsigned char>(Hash(static_cast<int>(i / 4 % side / 4), static_cast<int>(i / 4 / side / 4), seed + static_cast<uint32_t>(texture * 4 + i % 4)));
+			}
+			const std::string imagePath = (libraryDirectory / ("sprite_" + std::to_string(texture) + ".png")).string();
+			stbi_write_png(imagePath.c_str(), side, side, 4, pixels.data(), side * 4);
+			WriteTextureAssetFile(imagePath);
+			fileBytes += std::filesystem::file_size(imagePath) + std::filesystem::file_size(imagePath + AssetHeader::FileExtension);
+		}
+
+		const size_t startTextures = Resources::GetTextures().Size();
+		auto load = Measure("asset_loader", "png_32_x" + std::to_string(textureCount), 0, textureCount, [&] {
+			JobSystem::Initialize();
+			AssetLoader::QueueDirectory(libraryDirectory.string().c_str(), false);
+			AssetLoader::Finish();
+			JobSystem::Shutdown();
+		});
+		load.DataBytes = fileBytes;
+		results.push_back(load);
+		const size_t loadedTextures = Resources::GetTextures().Size() - startTextures;
+		if (loadedTextures != textureCount) std::cerr << "  asset loader loaded " << loadedTextures << " of " << textureCount << " textures" << std::endl;
+		checksum += loadedTextures;
+
+		std::filesystem::remove_all(libraryDirectory);
+	}
+
+	// SDL events as the editor receives them, grouped into frames
+	struct EventStream {
+		const char* Name;
+		std::vector<SDL_Event> Events;
+		// index one past the last event of each frame
+		std::vector<size_t> FrameEnds;
+	};
+
+	SDL_Event MakeKeyEvent(const Uint32 type, const SDL_Keycode keycode, const bool repeat) {
+		SDL_Event sdlEvent{};
+		sdlEvent.type = type;
+		sdlEvent.key.state = type == SDL_KEYDOWN ? SDL_PRESSED : SDL_RELEASED;
+		sdlEvent.key.repeat = repeat;
+		sdlEvent.key.keysym.sym = keycode;
+		return sdlEvent;
+	}
+
+	SDL_Event MakeMouseButtonEvent(const Uint32 type, const Uint8 button) {
+		SDL_Event sdlEvent{};
+		sdlEvent.type = type;
+		sdlEvent.button.button = button;
+		sdlEvent.button.state = type == SDL_MOUSEBUTTONDOWN ? SDL_PRESSED : SDL_RELEASED;
+		return sdlEvent;
+	}
+
+	SDL_Event MakeMouseMotionEvent(const int deltaX, const int deltaY) {
+		SDL_Event sdlEvent{};
+		sdlEvent.type = SDL_MOUSEMOTION;
+		sdlEvent.motion.xrel = deltaX;
+		sdlEvent.motion.yrel = deltaY;
+		return sdlEvent;
+	}
+
+	// Painting strokes, camera panning with key repeat and undo shortcut bursts, modelled on editing sessions
+	std::vector<EventStream> GenerateEventStreams(const size_t frameCount, const uint32_t seed) {
+		std::vector<EventStream> streams{ { "painting" }, { "camera" }, { "shortcuts" } };
+		std::mt19937 rng(seed);
+
+		EventStream& painting = streams[0];
+		for (size_t frame = 0; frame < frameCount; ++frame) {
+			if (frame % 60 == 0) painting.Events.push_back(MakeMouseButtonEvent(SDL_MOUSEBUTTONDOWN, SDL_BUTTON_LEFT));
+			const uint32_t motionCount = 1 + rng() % 4;
+			for (uint32_t i = 0; i < motionCount; ++i) painting.Events.push_back(MakeMouseMotionEvent(static_cast<int>(rng() % 9) - 4, static_cast<int>(rng() % 9) - 4));
+			if (frame % 60 == 40) painting.Events.push_back(MakeMouseButtonEvent(SDL_MOUSEBUTTONUP, SDL_BUTTON_LEFT));
+			painting.FrameEnds.push_back(painting.Events.size());
+		}
+
+		EventStream& camera = streams[1];
+		constexpr SDL_Keycode moveKeys[] = { SDLK_w, SDLK_a, SDLK_s, SDLK_d };
+		SDL_Keycode heldKey = 0;
+		for (size_t frame = 0; frame < frameCount; ++frame) {
+			if (frame % 45 == 0) {
+				if (heldKey != 0) camera.Events.push_back(MakeKeyEvent(SDL_KEYUP, heldKey, false));
+				heldKey = moveKeys[rng() % 4];
+				camera.Events.push_back(MakeKeyEvent(SDL_KEYDOWN, heldKey, false));
+			}
+			else if (frame % 2 == 0) camera.Events.push_back(MakeKeyEvent(SDL_KEYDOWN, heldKey, true));
+			if (frame % 10 == 0) {
+				SDL_Event wheel{};
+				wheel.type = SDL_MOUSEWHEEL;
+				wheel.wheel.y = rng() % 2 == 0 ? 1 : -1;
+				wheel.wheel.preciseY = static_cast<float>(wheel.wheel.y);
+				camera.Events.push_back(wheel);
+			}
+			camera.Events.push_back(MakeMouseMotionEvent(1, 0));
+			camera.FrameEnds.push_back(camera.Events.size());
+		}
+
+		EventStream& shortcuts = streams[2];
+		for (size_t frame = 0; frame < frameCount; ++frame) {
+			switch (frame % 8) {
+			case 0: shortcuts.Events.push_back(MakeKeyEvent(SDL_KEYDOWN, SDLK_LCTRL, false)); break;
+			case 2: shortcuts.Events.push_back(MakeKeyEvent(SDL_KEYDOWN, SDLK_z, false)); break;
+			case 3: shortcuts.Events.push_back(MakeKeyEvent(SDL_KEYUP, SDLK_z, false)); break;
+			case 5: shortcuts.Events.push_back(MakeKeyEvent(SDL_KEYUP, SDLK_LCTRL, false)); break;
+			default: break;
+			}
+			shortcuts.FrameEnds.push_back(shortcuts.Events.size());
+		}
+		return streams;
+	}
+
+	// Feeds the streams through Input with bindings like the editor's camera and main window, should not allocate
+	// Every release is dispatched however many keys change in a frame, and bindings changed by an action apply after dispatching
+	void CheckInputDispatch() {
+		std::cerr << "  check input_dispatch" << std::endl;
+		constexpr int keyCount = 200;
+		constexpr SDL_Keycode firstKeycode = 256;
+		size_t downCount = 0;
+		size_t upCount = 0;
+		std::vector<InputKeyBinding*> keyBindings;
+		for (int key = 0; key < keyCount; ++key) {
+			keyBindings.push_back(Input::AddKeyBinding(firstKeycode + key, [&downCount, &upCount](const KeyEvent e) {
+				downCount += e == KeyEvent::KeyDown;
+				upCount += e == KeyEvent::KeyUp;
+			}));
+		}
+		for (int key = 0; key < keyCount; ++key) Input::ReceiveSDLEvent(MakeKeyEvent(SDL_KEYDOWN, firstKeycode + key, false));
+		for (int key = 0; key < keyCount; ++key) Input::ReceiveSDLEvent(MakeKeyEvent(SDL_KEYUP, firstKeycode + key, false));
+		Input::DelegateKeyboardActions();
+		bool released = true;
+		for (int key = 0; key < keyCount; ++key) released &= !Input::GetKeyDown(firstKeycode + key);
+		Check(downCount == keyCount && upCount == keyCount, "all key downs and ups of a frame are dispatched");
+		Check(released, "no key stays held after its release");
+		for (auto* binding : keyBindings) Input::RemoveKeyBinding(binding);
+
+		// replaces itself with another binding of the same key on its first press
+		size_t replacedCount = 0;
+		size_t replacementCount = 0;
+		InputKeyBinding* binding = nullptr;
+		InputKeyBinding* replacement = nullptr;
+		binding = Input::AddKeyBinding(firstKeycode, [&](const KeyEvent) {
+			++replacedCount;
+			Input::RemoveKeyBinding(binding);
+			replacement = Input::AddKeyBinding(firstKeycode, [&replacementCount](const KeyEvent) { ++replacementCount; });
+		});
+		Input::ReceiveSDLEvent(MakeKeyEvent(SDL_KEYDOWN, firstKeycode, false));
+		Input::DelegateKeyboardActions();
+		Check(replacedCount == 1 && replacementCount == 0, "bindings added by an action are not dispatched in the same frame");
+		Input::DelegateKeyboardActions();
+		Check(replacedCount == 1 && replacementCount == 1, "bindings removed by an action stop and added ones start the next frame");
+		Input::ReceiveSDLEvent(MakeKeyEvent(SDL_KEYUP, firstKeycode, false));
+		Input::DelegateKeyboardActions();
+		Input::RemoveKeyBinding(replacement);
+	}
+
+	void RunInputBenchmark(const uint32_t seed, const std::string& replayPath) {
+		constexpr size_t frameCount = 1000000;
+		std::vector<EventStream> streams = GenerateEventStreams(frameCount, seed);
+		InputRecording recording;
+		if (!replayPath.empty() && InputRecording::TryLoad(replayPath, recording)) {
+			streams.push_back({ "recording", std::move(recording.Events), std::move(recording.FrameEnds) });
+		}
+
+		size_t invocations = 0;
+		std::vector<InputKeyBinding*> keyBindings;
+		for (const SDL_Keycode keycode : { SDLK_w, SDLK_s, SDLK_a, SDLK_d, SDLK_SPACE, SDLK_x, SDLK_LCTRL, SDLK_z }) {
+			keyBindings.push_back(Input::AddKeyBinding(keycode, [&invocations](KeyEvent e) { invocations += static_cast<size_t>(e); }));
+		}
+		std::vector<InputMouseBinding*> mouseBindings;
+		for (int i = 0; i < 2; ++i) {
+			mouseBindings.push_back(Input::AddMouseBinding([&invocations](const InputMouseEvent* e) {
+				invocations += e->GetMouseKeyHold(MouseButton::Left) + e->GetMouseKeyDown(MouseButton::Right) + e->motion->deltaX + e->GetMouseWheelDelta();
+			}));
+		}
+
+		for (const auto& stream : streams) {
+			results.push_back(Measure("input_replay", stream.Name, 0, stream.Events.size(), [&] {
+				size_t eventIndex = 0;
+				for (const size_t frameEnd : stream.FrameEnds) {
+					for (; eventIndex < frameEnd; ++eventIndex) Input::ReceiveSDLEvent(stream.Events[eventIndex]);
+					Input::DelegateMouseActions();
+					Input::DelegateKeyboardActions();
+				}
+			}));
+		}
+		checksum += invocations;
+
+		for (auto* binding : keyBindings) Input::RemoveKeyBinding(binding);
+		for (auto* binding : mouseBindings) Input::RemoveMouseBinding(binding);
+	}
+
+	void WriteJson(std::ostream& oStream, const Options& options) {
+		oStream << "{\n  \"benchmark\": \"LevelEditorBench\",\n  \"seed\": " << options.Seed << ",\n  \"results\": [";
+		for (size_t i = 0; i < results.size(); ++i) {
+			const Measurement& m = results[i];
+			const double opsPerSecond = m.Seconds > 0 ? static_cast<double>(m.Operations) / m.Seconds : 0.0;
+			const double nsPerOp = m.Operations > 0 ? m.Seconds * 1e9 / static_cast<double>(m.Operations) : 0.0;
+			oStream << (i == 0 ? "\n" : ",\n")
+				<< "    {\"name\": \"" << m.Name << "\", \"generator\": \"" << m.Generator << "\", \"tiles\": " << m.Tiles
+				<< ", \"operations\": " << m.Operations << ", \"seconds\": " << m.Seconds << ", \"opsPerSecond\": " << opsPerSecond
+				<< ", \"nsPerOp\": " << nsPerOp << ", \"allocations\": " << m.Allocations << ", \"allocatedBytes\": " << m.AllocatedBytes
+				<< ", \"peakHeapBytes\": " << m.PeakHeapBytes << ", \"dataBytes\": " << m.DataBytes
+				<< ", \"dataBytesEstimated\": " << (m.DataBytesEstimated ? "true" : "false") << "}";
+		}
+		oStream << "\n  ],\n  \"processPeakHeapBytes\": " << peakBytes.load() << "\n}\n";
+	}
+
+	void PrintUsage() {
+		std::cout << "usage: LevelEditorBench [--max-tiles <count>] [--seed <seed>] [--out <file.json>] [--replay <input recording>] [--checks]\n"
+			"  Runs tileMap benchmarks at 10k to --max-tiles tiles (default 10M) on random, cave and room layouts.\n"
+			"  --replay also feeds an input recording of the editor (LevelEditor --record) through Input.\n"
+			"  Writes JSON to --out or stdout, progress goes to stderr.\n"
+			"  --checks only runs the correctness checks. Exits with 1 if a check failed.\n";
+	}
+}
+
+int main(const int argc, char** argv) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		const std::string argument = argv[i];
+		if (argument == "--max-tiles" && i + 1 < argc) options.MaxTiles = std::stoull(argv[++i]);
+		else if (argument == "--seed" && i + 1 < argc) options.Seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (argument == "--out" && i + 1 < argc) options.OutputPath = argv[++i];
+		else if (argument == "--replay" && i + 1 < argc) options.ReplayPath = argv[++i];
+		else if (argument == "--checks") options.ChecksOnly = true;
+		else {
+			PrintUsage();
+			return argument == "--help" || argument == "-h" ? 0 : 2;
+		}
+	}
+
+	// the editor code logs to std::cout, which is kept free for the results
+	std::ostream resultsOutput(std::cout.rdbuf());
+	std::cout.rdbuf(std::cerr.rdbuf());
+
+	Rendering::Texture::SetHeadless(true);
+	Rendering::Texture::Empty();
+
+	const std::filesystem::path outputDirectory = std::filesystem::temp_directory_path() / "LevelEditorBench";
+	std::filesystem::create_directories(outputDirectory);
+
+	int textureIndex = 0;
+	const Tiles::Tile* tileA = CreateSyntheticAutoTile("autotile_a", textureIndex);
+	const Tiles::Tile* tileB = CreateSyntheticAutoTile("autotile_b", textureIndex);
+
+	std::cerr << "checks" << std::endl;
+	CheckAtlasPacker(options.Seed);
+	CheckBC7RoundTrip(options.Seed);
+	CheckTilePatterns();
+	CheckLevelMissingTiles(tileA, outputDirectory, textureIndex);
+	CheckTileMapCorruptInput(tileA);
+	CheckInputDispatch();
+	CheckTextureSheetArrayLayers(outputDirectory);
+	CheckImportCachePrune(outputDirectory);
+	CheckThumbnailCache(outputDirectory);
+	if (options.ChecksOnly) {
+		Resources::FreeAll();
+		return checksFailed ? 1 : 0;
+	}
+
+	for (size_t tileCount = 10000; tileCount <= options.MaxTiles; tileCount *= 10) {
+		for (const auto& generator : GetGenerators()) {
+			std::cerr << generator.Name << " " << tileCount << std::endl;
+			RunTileMapBenchmarks(generator, tileCount, tileA, tileB, outputDirectory, options.Seed);
+		}
+	}
+	RunFloodFillBenchmark(tileA, tileB);
+	RunPaintBenchmark(tileA, tileB);
+	RunPrefabBenchmark(tileA, tileB, options.Seed);
+	RunPatternBenchmark();
+	RunResourcesBenchmark(options.Seed, textureIndex);
+	RunThumbnailBenchmark(options.Seed);
+	RunTextureSheetBenchmark(outputDirectory, options.Seed);
+	RunDecodeBenchmark(outputDirectory, options.Seed);
+	RunImportCacheBenchmark(outputDirectory, options.Seed);
+	RunAssetLoaderBenchmark(outputDirectory, options.Seed);
+	RunInputBenchmark(options.Seed, options.ReplayPath);
+
+	if (options.OutputPath.empty()) WriteJson(resultsOutput, options);
+	else {
+		std::ofstream file(options.OutputPath);
+		WriteJson(file, options);
+		std::cerr << "Results written to " << options.OutputPath << std::endl;
+	}
+
+	Resources::FreeAll();
+	return checksFailed ? 1 : 0;
+}
@@ -0,0 +1,256 @@
+// Headless batch processing of levels, tiles and asset files. Needs no window or GL context.
+#include <charconv>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Assets.h"
+#include "Files.h"
+#include "JobSystem.h"
+#include "Level.h"
+#include "Resources.h"
+#include "Strings.h"
+#include "Texture.h"
+#include "TextureSheet.h"
+#include "Tile.h"
+#include "TileMap.h"
+#include "TileMapManager.h"
+
+namespace {
+	struct Options {
+		std::filesystem::path Root;
+		bool Resave = false;
+		unsigned int Jobs = 0;
+		std::vector<std::string> Inputs;
+	};
+
+	struct FileReport {
+		std::string RelativePath;
+		bool Success = true;
+		size_t MissingAssets = 0;
+		size_t TileCount = 0;
+		std::ostringstream Output;
+	};
+
+	void PrintUsage() {
+		std::cout << "usage: LevelEditorCli [--root <project directory>] [--resave] [--jobs <count>] <file or directory>...\n"
+			"  Loads .level, .tile and .asset files, validates their references and prints stats.\n"
+			"  --root    directory containing Sprites, TextureSheets and Tiles, defaults to the working directory\n"
+			"  --resave  writes every file that loaded successfully back in the current format\n"
+			"  --jobs    worker threads for levels and tiles, defaults to hardware threads - 1\n";
+	}
+
+	bool ParseArguments(const int argc, char** argv, Options& out_options) {
+		for (int i = 1; i < argc; ++i) {
+			const std::string argument = argv[i];
+			if (argument == "--resave") out_options.Resave = true;
+			else if (argument == "--root" && i + 1 < argc) out_options.Root = argv[++i];
+			else if (argument == "--jobs" && i + 1 < argc) {
+				const std::string_view count = argv[++i];
+				const auto [end, error] = std::from_chars(count.data(), count.data() + count.size(), out_options.Jobs);
+				if (error != std::errc() || end != count.data() + count.size() || out_options.Jobs == 0) {
+					std::cout << "Invalid job count: " << count << std::endl;
+					return false;
+				}
+			}
+			else if (argument == "--help" || argument == "-h") return false;
+			else if (argument.rfind("--", 0) == 0) {
+				std::cout << "Unknown option: " << argument << std::endl;
+				return false;
+			}
+			else out_options.Inputs.push_back(argument);
+		}
+		return !out_options.Inputs.empty();
+	}
+
+	void CollectFiles(const std::string& input, std::vector<std::string>& out_files) {
+		const std::filesystem::path path = std::filesystem::absolute(input);
+		const auto addFile = [&out_files](const std::filesystem::path& filePath) {
+			if (AssetHeader::IsAssetFileExtension(filePath.extension().string())) out_files.push_back(Files::GetRelativePath(filePath));
+		};
+
+		if (std::filesystem::is_directory(path)) {
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+				if (entry.is_regular_file()) addFile(entry.path());
+			}
+			return;
+		}
+		if (!std::filesystem::exists(path)) {
+			std::cout << "File not found: " << input << std::endl;
+			return;
+		}
+		addFile(path);
+	}
+
+	void ValidateTileReferences(const Tiles::Tile* tile, FileReport& report) {
+		std::set<AssetId> missing;
+		Rendering::Texture* _;
+		if (!tile->DisplayTexture.IsEmpty() && !Resources::TryGetTexture(tile->DisplayTexture, _)) missing.insert(tile->DisplayTexture);
+		tile->GetPattern()->ForEachTileSlot([&missing](const Tiles::TileSlot& slot) {
+			Rendering::Texture* texture;
+			for (const auto& variant : slot.TileSprites) {
+				if (!Resources::TryGetTexture(variant.TextureId, texture)) missing.insert(variant.TextureId);
+			}
+		});
+
+		for (const auto& id : missing) {
+			report.Output << "  missing texture " << id.ToString() << " referenced by tile " << tile->Name << "\n";
+		}
+		report.MissingAssets += missing.size();
+	}
+
+	void ProcessTile(const Options& options, FileReport& report) {
+		Tiles::Tile* tile = nullptr;
+		if (!Tiles::Tile::LoadFromFile(report.RelativePath.c_str(), tile)) {
+			report.Output << "  unable to load tile\n";
+			report.Success = false;
+			return;
+		}
+		const std::unique_ptr<Tiles::Tile> tileUPTR(tile);
+		report.Output << "  tile '" << tile->Name << "' " << tile->AssetId.ToString() << "\n";
+		ValidateTileReferences(tile, report);
+		if (options.Resave && report.MissingAssets == 0) tile->SaveToFile(report.RelativePath);
+	}
+
+	void ProcessLevel(const Options& options, FileReport& report) {
+		Level* level = nullptr;
+		std::vector<AssetId> missingTileIds;
+		if (!Level::LoadFromFile(report.RelativePath.c_str(), level, &missingTileIds)) {
+			report.Output << "  unable to load level\n";
+			report.Success = false;
+			return;
+		}
+		const std::unique_ptr<Level> levelUPTR(level);
+
+		// the level loaded without the cells of missing tiles, so it is not resaved
+		const std::set<AssetId> missingTiles(missingTileIds.begin(), missingTileIds.end());
+		for (const auto& id : missingTiles) {
+			report.Output << "  missing tile " << id.ToString() << "\n";
+		}
+		report.MissingAssets += missingTiles.size();
+
+		std::set<const Tiles::Tile*> referencedTiles;
+		report.Output << "  level '" << level->Name << "', " << level->TileMapManagerUPtr->tileMaps.size() << " tileMaps\n";
+		for (const auto& tileMap : level->TileMapManagerUPtr->tileMaps) {
+			size_t tileTypes = 0;
+			tileMap->ForEachReferencedTile([&](const Tiles::Tile* tile, int) {
+				referencedTiles.insert(tile);
+				++tileTypes;
+			});
+			report.TileCount += tileMap->GetTileCount();
+			report.Output << "    '" << tileMap->Name << "': " << tileMap->GetTileCount() << " tiles, " << tileMap->GetChunkCount() << " chunks, " << tileTypes << " tile types\n";
+		}
+		report.Output << "  " << referencedTiles.size() << " referenced tiles\n";
+		for (const Tiles::Tile* tile : referencedTiles) ValidateTileReferences(tile, report);
+
+		if (options.Resave && missingTiles.empty()) level->SaveToFile(report.RelativePath);
+	}
+
+	// Textures and sheets register themselves in Resources, so these run on the main thread
+	void ProcessAsset(const Options& options, FileReport& report) {
+		AssetHeader header;
+		if (!AssetHeader::TryReadHeaderFromFile(Files::GetAbsolutePath(report.RelativePath), &header)) {
+			report.Success = false;
+			return;
+		}
+
+		switch (header.aType) {
+			case AssetType::Texture:
+			case AssetType::TextureInternal: {
+				Rendering::Texture* texture = nullptr;
+				const bool loaded = Resources::AssetIsLoaded(header.aId)
+					? Resources::TryGetTexture(header.aId, texture) || header.aType == AssetType::TextureInternal
+					: Rendering::Texture::LoadFromFile(report.RelativePath.c_str(), texture);
+				if (!loaded) {
+					report.Output << "  unable to load image of texture " << header.aId.ToString() << "\n";
+					report.Success = false;
+					++report.MissingAssets;
+					return;
+				}
+				if (texture == nullptr) return;
+				const auto properties = texture->GetImageProperties();
+				report.Output << "  texture " << texture->GetImageFilePath() << " " << properties.width << "x" << properties.height << "\n";
+				if (options.Resave) texture->SaveToFile(report.RelativePath);
+				return;
+			}
+			case AssetType::TextureSheet: {
+				Rendering::TextureSheet* sheet = nullptr;
+				if (!Resources::TryGetTextureSheet(header.aId, sheet)) {
+					if (!Rendering::TextureSheet::LoadFromFile(report.RelativePath.c_str(), sheet)) {
+						report.Output << "  unable to load textureSheet\n";
+						report.Success = false;
+						return;
+					}
+					Resources::AssignOwnership(sheet);
+				}
+				report.Output << "  textureSheet '" << sheet->Name << "', " << sheet->SubTextures.size() << " subTextures\n";
+				if (options.Resave) sheet->SaveToFile(report.RelativePath);
+				return;
+			}
+			default:
+				report.Output << "  unexpected asset type " << static_cast<int>(header.aType) << "\n";
+				report.Success = false;
+		}
+	}
+}
+
+int main(const int argc, char** argv) {
+	Options options;
+	if (!ParseArguments(argc, argv, options)) {
+		PrintUsage();
+		return 2;
+	}
+	if (!options.Root.empty()) std::filesystem::current_path(options.Root);
+
+	Rendering::Texture::SetHeadless(true);
+	// created up front, workers only read from Resources
+	Rendering::Texture::Empty();
+
+	for (const char* directory : { Strings::Directory_Sprites, Strings::Directory_TextureSheets, Strings::Directory_Tiles }) {
+		if (std::filesystem::is_directory(Files::GetAbsolutePath(directory))) Resources::LoadDirectory(directory, false, true);
+	}
+
+	std::vector<std::string> files;
+	for (const auto& input : options.Inputs) CollectFiles(input, files);
+
+	std::vector<std::unique_ptr<FileReport>> reports;
+	reports.reserve(files.size());
+	for (const auto& file : files) {
+		auto report = std::make_unique<FileReport>();
+		report->RelativePath = file;
+		reports.push_back(std::move(report));
+	}
+
+	for (auto& report : reports) {
+		if (std::filesystem::path(report->RelativePath).extension() == AssetHeader::FileExtension) ProcessAsset(options, *report);
+	}
+
+	JobSystem::Initialize(options.Jobs);
+	for (auto& report : reports) {
+		const std::string extension = std::filesystem::path(report->RelativePath).extension().string();
+		FileReport* reportPtr = report.get();
+		if (extension == AssetHeader::GetFileExtension(AssetType::Level)) JobSystem::Schedule([&options, reportPtr] { ProcessLevel(options, *reportPtr); });
+		else if (extension == AssetHeader::GetFileExtension(AssetType::Tile)) JobSystem::Schedule([&options, reportPtr] { ProcessTile(options, *reportPtr); });
+	}
+	// waits for all scheduled files
+	JobSystem::Shutdown();
+
+	size_t failed = 0;
+	size_t missingAssets = 0;
+	size_t tileCount = 0;
+	for (const auto& report : reports) {
+		std::cout << (report->Success && report->MissingAssets == 0 ? "[ok]   " : "[fail] ") << report->RelativePath << "\n" << report->Output.str();
+		if (!report->Success || report->MissingAssets > 0) ++failed;
+		missingAssets += report->MissingAssets;
+		tileCount += report->TileCount;
+	}
+	std::cout << reports.size() << " files, " << failed << " failed, " << missingAssets << " missing assets, " << tileCount << " tiles in levels" << std::endl;
+
+	Resources::FreeAll();
+	return failed > 0 ? 1 : 0;
+}
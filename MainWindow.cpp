@@ -9,9 +9,12 @@
 #include <imgui_impl_sdl.h>
 #include <imgui_impl_opengl3.h>
 #include <filesystem>
+#include <unordered_set>
 
 
 #include "AssetId.h"
+#include "AssetLoader.h"
+#include "AssetWatcher.h"
 #include "Files.h"
 
 #include "Camera.h"
@@ -19,15 +22,23 @@
 #include "FileEditWindow.h"
 #include "GridToolBar.h"
 #include "ImGuiHelper.h"
+#include "ImportCache.h"
+#include "Input.h"
+#include "JobSystem.h"
+#include "Profiler.h"
 #include "Renderer.h"
 #include "Resources.h"
 #include "TextureSheet.h"
 #include "Strings.h"
 #include "Texture.h"
+#include "TextureAtlas.h"
+#include "ThumbnailCache.h"
 #include "TileMap.h"
 #include "TileMapManager.h"
+#include "TileEditHistory.h"
 #include "Tile.h"
 #include "Level.h"
+#include "Prefab.h"
 #include "DPIScale.h"
 
 using namespace Rendering;
@@ -61,10 +72,104 @@ int WindowResizeEvent(void* data, SDL_Event* event) {
 	return 0;
 }
 
+// Video memory of loaded textures, textureSheets with their array layers and atlas pages.
+// Changing the compression saves it to the asset file
+void RenderTextureMemoryTable() {
+	using namespace ImGui;
+	struct Row {
+		std::string Name;
+		// null for array layers and atlas pages, which are always rgba8
+		Rendering::Texture* Texture;
+		TextureSheet* Sheet;
+		size_t Bytes;
+		size_t UncompressedBytes;
+	};
+	std::vector<Row> rows;
+	std::unordered_set<const Texture*> sheetTextures;
+	Resources::GetTextureSheets().ForEach([&rows, &sheetTextures](const AssetId&, TextureSheet* const& sheet) {
+		Texture* texture = sheet->GetMainTexture();
+		rows.push_back({ sheet->Name, texture, sheet, texture->GetGpuByteSize(), texture->GetUncompressedGpuByteSize() });
+		sheetTextures.insert(texture);
+		const size_t arrayBytes = sheet->GetArrayTextureByteSize();
+		if (arrayBytes != 0) rows.push_back({ sheet->Name + " array layers", nullptr, nullptr, arrayBytes, arrayBytes });
+	});
+	// subTextures share their sheet's texture and report 0 bytes
+	Resources::GetTextures().ForEach([&rows, &sheetTextures](const AssetId&, Texture* const& texture) {
+		if (texture->GetGpuByteSize() == 0 || sheetTextures.count(texture) != 0) return;
+		rows.push_back({ texture->Name, texture, nullptr, texture->GetGpuByteSize(), texture->GetUncompressedGpuByteSize() });
+	});
+	for (size_t page = 0; page < TextureAtlas::GetPageCount(); ++page) {
+		if (TextureAtlas::GetPageTextureId(page) == 0) continue;
+		const size_t pageBytes = TextureAtlas::GetPageGpuByteSize();
+		rows.push_back({ "Atlas page " + std::to_string(page), nullptr, nullptr, pageBytes, pageBytes });
+	}
+
+	if (!BeginTable("TextureMemory", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) return;
+	TableSetupColumn("Asset");
+	TableSetupColumn("Format");
+	TableSetupColumn("VRAM");
+	TableSetupColumn("As RGBA8");
+	TableSetupColumn("Saved");
+	TableHeadersRow();
+
+	const char* compressionNames[] = { TextureEncoder::GetName(TextureCompression::None), TextureEncoder::GetName(TextureCompression::BC7) };
+	size_t totalBytes = 0;
+	size_t totalUncompressedBytes = 0;
+	for (const Row& row : rows) {
+		const size_t bytes = row.Bytes;
+		const size_t uncompressedBytes = row.UncompressedBytes;
+		totalBytes += bytes;
+		totalUncompressedBytes += uncompressedBytes;
+
+		TableNextRow();
+		TableNextColumn();
+		TextUnformatted(row.Name.c_str());
+		TableNextColumn();
+		if (row.Texture == nullptr) TextUnformatted(TextureEncoder::GetName(TextureCompression::None));
+		else {
+			PushID(row.Texture);
+			int compressionIndex = static_cast<int>(row.Texture->GetCompression());
+			SetNextItemWidth(GetFontSize() * 6);
+			if (Combo("##Compression", &compressionIndex, compressionNames, 2)) {
+				const auto compression = static_cast<TextureCompression>(compressionIndex);
+				if (row.Sheet != nullptr) {
+					row.Sheet->SetCompression(compression);
+					row.Sheet->SaveToFile();
+				}
+				else {
+					row.Texture->SetCompression(compression);
+					row.Texture->Refresh();
+					row.Texture->SaveToFile();
+				}
+			}
+			PopID();
+		}
+		TableNextColumn();
+		Text("%.1f KB", bytes / 1024.0f);
+		TableNextColumn();
+		Text("%.1f KB", uncompressedBytes / 1024.0f);
+		TableNextColumn();
+		Text("%.1f KB", (uncompressedBytes - bytes) / 1024.0f);
+	}
+
+	TableNextRow();
+	TableNextColumn();
+	TextUnformatted("Total");
+	TableNextColumn();
+	TableNextColumn();
+	Text("%.1f MB", totalBytes / (1024.0f * 1024.0f));
+	TableNextColumn();
+	Text("%.1f MB", totalUncompressedBytes / (1024.0f * 1024.0f));
+	TableNextColumn();
+	Text("%.1f MB", (totalUncompressedBytes - totalBytes) / (1024.0f * 1024.0f));
+	EndTable();
+}
+
 bool MainWindow::Initialize() {
 	if (!InitSDL()) return false;
 	if (!Renderer::Init()) return false;
 	if (!InitDearImGui()) return false;
+	Profiling::Profiler::InitializeGpu();
 
 	gridToolBar = new GridTools::GridToolBar();
 
@@ -75,18 +180,39 @@ bool MainWindow::Initialize() {
 	Level* level = Level::CreateDefaultLevel();
 	LoadLevel(level);
 
-	// Load Resources
+	// Load Resources in the background, file browsers are created once loading is done
 	Files::VerifyDirectory(Strings::Directory_Resources);
+	JobSystem::Initialize();
+	if (Files::VerifyDirectory(Strings::Directory_Cache)) {
+		ThumbnailCache::Initialize(Files::GetAbsolutePath(Strings::File_ThumbnailCache));
+		if (Files::VerifyDirectory(Strings::Directory_ImportCache))
+			ImportCache::Initialize(Files::GetAbsolutePath(Strings::Directory_ImportCache));
+	}
 
 	if (Files::VerifyDirectory(Strings::Directory_Resources_Icons))
-		Resources::LoadDirectory(Strings::Directory_Resources_Icons, false, true);
+		AssetLoader::QueueDirectory(Strings::Directory_Resources_Icons, true);
 	if (Files::VerifyDirectory(Strings::Directory_Sprites))
-		Resources::LoadDirectory(Strings::Directory_Sprites, false, true);
+		AssetLoader::QueueDirectory(Strings::Directory_Sprites, true);
 	if (Files::VerifyDirectory(Strings::Directory_TextureSheets))
-		Resources::LoadDirectory(Strings::Directory_TextureSheets, false, true);
+		AssetLoader::QueueDirectory(Strings::Directory_TextureSheets, true);
 	if (Files::VerifyDirectory(Strings::Directory_Tiles))
-		Resources::LoadDirectory(Strings::Directory_Tiles, false, true);
+		AssetLoader::QueueDirectory(Strings::Directory_Tiles, true);
+	// prefabs reference tiles, so they are loaded after them
+	if (Files::VerifyDirectory(Strings::Directory_Prefabs))
+		AssetLoader::QueueDirectory(Strings::Directory_Prefabs, true);
+
+	if (!AssetLoader::IsLoading()) OnAssetsLoaded();
+
+	return true;
+}
+
+void MainWindow::OnAssetsLoaded() {
+	CreateFileBrowsers();
+	AssetWatcher::Start({ Strings::Directory_Resources_Icons, Strings::Directory_Sprites, Strings::Directory_TextureSheets,
+	                      Strings::Directory_Tiles, Strings::Directory_Prefabs });
+}
 
+void MainWindow::CreateFileBrowsers() {
 
 	auto onTileEdit = [](FileBrowserFile& file) {
 		if (file.AssetHeader.aType == AssetType::Tile) {
@@ -122,9 +248,11 @@ bool MainWindow::Initialize() {
 	});
 
 	auto textureSheetFileBrowser = new FileBrowser(Strings::Directory_TextureSheets, "TextureSheets", onTexSheetEdit, nullptr, onTexSheetEdit);
-	fileBrowsers = { tileFileBrowser, spriteFileBrowser, textureSheetFileBrowser };
-
-	return true;
+	auto prefabFileBrowser = new FileBrowser(Strings::Directory_Prefabs, "Prefabs", [this](const FileBrowserFile& file) {
+		if (file.AssetHeader.aType != AssetType::Prefab) return;
+		gridToolBar->Paste(*static_cast<Tiles::Prefab*>(file.Data));
+	});
+	fileBrowsers = { tileFileBrowser, spriteFileBrowser, textureSheetFileBrowser, prefabFileBrowser };
 }
 
 bool MainWindow::InitSDL() {
@@ -163,6 +291,7 @@ void Rendering::MainWindow::LoadLevel(Level* level) {
 	if (loadedLevel != nullptr) UnloadLevel();
 	loadedLevel = level;
 	level->TileMapManagerUPtr->gridToolBar = gridToolBar;
+	gridToolBar->editHistory = &level->TileMapManagerUPtr->EditHistory;
 	Renderer::RenderObjects.push_back(level->TileMapManagerUPtr.get());
 
 	if (level->TileMapManagerUPtr->tileMaps.size() > 0) {
@@ -176,7 +305,7 @@ void Rendering::MainWindow::UnloadLevel() {
 	Rendering::Renderable* tileMapManager = static_cast<Rendering::Renderable*>(loadedLevel->TileMapManagerUPtr.get());
 	auto removeIt = std::remove(Renderer::RenderObjects.begin(), Renderer::RenderObjects.end(), tileMapManager);
 	Renderer::RenderObjects.erase(removeIt);
-
+	gridToolBar->editHistory = nullptr;
 
 	delete loadedLevel;
 }
@@ -195,10 +324,21 @@ void MainWindow::Render() {
 	// clear color, depth and stencil buffers
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
+	if (AssetLoader::IsLoading()) {
+		PROFILE_SCOPE("AssetLoader::Update");
+		if (!AssetLoader::Update(assetUploadBudgetMS)) OnAssetsLoaded();
+	}
+	else if (AssetWatcher::Update()) {
+		// reloaded tiles and textureSheets may have changed which textures are used
+		loadedLevel->TileMapManagerUPtr->RefreshAllTiles();
+		RefreshFileBrowserDirectories();
+	}
+
 	// Order of Render OpenGL and ImGui does not seem to matter?
 	Renderer::Render();
 	RenderImGui();
 
+	PROFILE_SCOPE("SDL_GL_SwapWindow");
 	SDL_GL_SwapWindow(SDLWindow);
 }
 
@@ -219,9 +359,13 @@ void Rendering::MainWindow::SetWindowTitle(std::string title) {
 }
 
 void MainWindow::RenderImGui() {
+	PROFILE_FUNCTION();
 	// Required before ImGui logic
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplSDL2_NewFrame(SDLWindow);
+	// the backend reads the real cursor while focused, replayed input has to win
+	int mouseX, mouseY;
+	if (Input::TryGetMousePositionOverride(mouseX, mouseY)) ImGui::GetIO().AddMousePosEvent(static_cast<float>(mouseX), static_cast<float>(mouseY));
 	using namespace ImGui;
 	ImGui::NewFrame();
 
@@ -233,10 +377,17 @@ void MainWindow::RenderImGui() {
 		ImGui::ShowDemoWindow();
 	}
 
+	if (AssetLoader::IsLoading()) {
+		RenderLoadingProgress();
+		RenderImGuiDrawData();
+		return;
+	}
+
 	// Main Cam Controls
 	Camera::Main->DearImGuiWindow();
 
 	static bool saveLevelDialogue = false;
+	static bool savePrefabDialogue = false;
 
 	if (ImGui::IsKeyDown(ImGuiKey_LeftCtrl) && ImGui::IsKeyPressed(ImGuiKey_S)) {
 		if (!loadedLevel->Name.empty() && loadedLevel->Name != "untitled") SaveCurrentLevel();
@@ -247,6 +398,21 @@ void MainWindow::RenderImGui() {
 		RefreshFileBrowserDirectories();
 	}
 
+	if (ImGui::IsKeyDown(ImGuiKey_LeftCtrl) && !ImGui::GetIO().WantTextInput) {
+		Tiles::TileEditHistory& editHistory = loadedLevel->TileMapManagerUPtr->EditHistory;
+		const bool redoPressed = ImGui::IsKeyPressed(ImGuiKey_Y) || (ImGui::IsKeyDown(ImGuiKey_LeftShift) && ImGui::IsKeyPressed(ImGuiKey_Z));
+		if (redoPressed) {
+			if (editHistory.Redo()) SetWindowDirtyFlag(true);
+		}
+		else if (ImGui::IsKeyPressed(ImGuiKey_Z)) {
+			if (editHistory.Undo()) SetWindowDirtyFlag(true);
+		}
+
+		if (ImGui::IsKeyPressed(ImGuiKey_C)) gridToolBar->CopySelection();
+		if (ImGui::IsKeyPressed(ImGuiKey_X) && gridToolBar->CutSelection()) SetWindowDirtyFlag(true);
+		if (ImGui::IsKeyPressed(ImGuiKey_V)) gridToolBar->Paste();
+	}
+
 	// Menu Bar
 	if (ImGui::BeginMainMenuBar()) {
 		if (ImGui::BeginMenu("File")) {
@@ -306,10 +472,92 @@ void MainWindow::RenderImGui() {
 			}
 			End();
 		}
+		if (ImGui::BeginMenu("Edit")) {
+			// fetched here, the File menu may have replaced the level
+			Tiles::TileEditHistory& editHistory = loadedLevel->TileMapManagerUPtr->EditHistory;
+			if (ImGui::MenuItem("Undo", "CTRL + Z", false, editHistory.CanUndo())) {
+				if (editHistory.Undo()) SetWindowDirtyFlag(true);
+			}
+			if (ImGui::MenuItem("Redo", "CTRL + Y", false, editHistory.CanRedo())) {
+				if (editHistory.Redo()) SetWindowDirtyFlag(true);
+			}
+			Separator();
+			glm::ivec2 selectionMin, selectionMax;
+			const bool hasSelection = gridToolBar->TryGetSelection(selectionMin, selectionMax);
+			if (ImGui::MenuItem("Cut", "CTRL + X", false, hasSelection)) {
+				if (gridToolBar->CutSelection()) SetWindowDirtyFlag(true);
+			}
+			if (ImGui::MenuItem("Copy", "CTRL + C", false, hasSelection)) {
+				gridToolBar->CopySelection();
+			}
+			if (ImGui::MenuItem("Paste", "CTRL + V", false, !gridToolBar->Clipboard.IsEmpty())) {
+				gridToolBar->Paste();
+			}
+			if (ImGui::MenuItem("Save Clipboard as Prefab...", nullptr, false, !gridToolBar->Clipboard.IsEmpty())) {
+				savePrefabDialogue = true;
+			}
+			Separator();
+			Text("History: %zu/%zu steps, %.2f MB", editHistory.GetUndoCount(), editHistory.GetEntryCount(), editHistory.GetMemoryUsage() / (1024.0f * 1024.0f));
+			int budgetMB = static_cast<int>(editHistory.GetMemoryBudget() / (1024 * 1024));
+			if (SliderInt("Budget (MB)", &budgetMB, 1, 256)) {
+				editHistory.SetMemoryBudget(static_cast<size_t>(budgetMB) * 1024 * 1024);
+			}
+			if (MenuItem("Clear History")) {
+				editHistory.Clear();
+			}
+			ImGui::EndMenu();
+		}
+
+		if (savePrefabDialogue) {
+			ImGuiHelper::CenterNextWindow(ImVec2(0, 0), ImGuiCond_Appearing);
+			if (Begin("Saving - Enter a name for the Prefab:", &savePrefabDialogue, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoCollapse)) {
+				static std::string prefabName;
+				InputTextWithHint("Name", "room_small", &prefabName);
+
+				// the name is checked every frame, the prefab and its id are only created when saving
+				std::filesystem::path prefabPath = Strings::Directory_Prefabs;
+				prefabPath.append(prefabName + AssetHeader::GetFileExtension(AssetType::Prefab));
+				std::string errorMessage;
+				std::error_code error;
+				if (prefabName.empty()) errorMessage = "Name is missing.";
+				else if (std::filesystem::exists(prefabPath, error)) errorMessage = "A file with that name already exists.";
+				else if (error.value() != 0) errorMessage = error.message();
+				bool hasError = !errorMessage.empty();
+				if (hasError) {
+					ImGui::TextUnformatted(errorMessage.c_str());
+				}
+
+				if (hasError) BeginDisabled();
+				bool savePressed = Button("Save");
+				if (hasError) EndDisabled();
+				SameLine();
+				bool quitPressed = Button("Cancel");
+
+				if (savePressed || quitPressed) {
+					if (savePressed) {
+						const Tiles::Prefab target(prefabName);
+						Tiles::Prefab prefab = gridToolBar->Clipboard;
+						prefab.AssetId = target.AssetId;
+						prefab.Name = target.Name;
+						prefab.ParentPath = target.ParentPath;
+						prefab.SaveToFile();
+						RefreshFileBrowserDirectories();
+					}
+					prefabName.clear();
+					savePrefabDialogue = false;
+				}
+			}
+			End();
+		}
+
 		static bool showTextureDebugViewer = false;
+		static bool showProfiler = false;
 
-#ifdef _DEBUG
 		if (ImGui::BeginMenu("Debug")) {
+			if (ImGui::MenuItem("Profiler", nullptr, showProfiler)) {
+				showProfiler = !showProfiler;
+			}
+#ifdef _DEBUG
 			if (ImGui::MenuItem("Show Demo Window", 0, showDebugWindow)) {
 				showDebugWindow = !showDebugWindow;
 			}
@@ -343,9 +591,11 @@ void MainWindow::RenderImGui() {
 				else
 					printf("Parse failed.");
 			}
+#endif
 			ImGui::EndMenu();
 		}
-#endif
+
+		if (showProfiler) Profiling::Profiler::RenderImGuiWindow(&showProfiler);
 
 		if (showTextureDebugViewer) {
 			if (ImGui::Begin("TextureDebugViewer", &showTextureDebugViewer, ImGuiWindowFlags_AlwaysAutoResize)) {
@@ -353,6 +603,18 @@ void MainWindow::RenderImGui() {
 				constexpr unsigned int step = 1;
 				InputScalar("Texture ID", ImGuiDataType_U32, &textureId, &step);
 				ImGuiHelper::Image(textureId, ImVec2(64, 64));
+				if (TreeNode("Texture Atlas")) {
+					Text("Regions: %zu", TextureAtlas::GetRegionCount());
+					for (size_t page = 0; page < TextureAtlas::GetPageCount(); ++page) {
+						Text("Page %zu: %.1f%% used", page, TextureAtlas::GetPageOccupancy(page) * 100.0f);
+						ImGuiHelper::Image(TextureAtlas::GetPageTextureId(page), ImVec2(256, 256));
+					}
+					TreePop();
+				}
+				if (TreeNode("VRAM")) {
+					RenderTextureMemoryTable();
+					TreePop();
+				}
 			}
 			End();
 		}
@@ -387,29 +649,53 @@ void MainWindow::RenderImGui() {
 
 	}
 
+	// Selection outline
+	if (glm::ivec2 selectionMin, selectionMax; gridToolBar->TryGetSelection(selectionMin, selectionMax)) {
+		const auto* tileMap = gridToolBar->activeTileMap;
+		const glm::vec2 gridMin = tileMap->ConvertToTileMapGridPosition(selectionMin);
+		const glm::vec2 gridMax = tileMap->ConvertToTileMapGridPosition(selectionMax) + tileMap->GridDimensions;
+		// screen positions start at the bottom, ImGui's at the top
+		const glm::vec2 screenMin = Camera::Main->GridToScreenPosition(gridMin);
+		const glm::vec2 screenMax = Camera::Main->GridToScreenPosition(gridMax);
+		const float screenHeight = main_viewport->Size.y;
+		GetBackgroundDrawList()->AddRect(ImVec2(screenMin.x, screenHeight - screenMax.y), ImVec2(screenMax.x, screenHeight - screenMin.y), IM_COL32(255, 255, 255, 255), 0, 0, 2.0f);
+	}
+
 	// Grid Tool Window
 	static bool toolWindowOpen = true;
 	constexpr ImGuiWindowFlags toolFlags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove;
 	if (Begin("Tools", &toolWindowOpen, toolFlags)) {
-		int toolCount = 3;
+		struct ToolButton {
+			GridTools::GridToolType Type;
+			const char* Icon;
+		};
+		constexpr ToolButton toolButtons[] = {
+			{ GridTools::GridToolType::Place, Strings::Icon_Tool_Place },
+			{ GridTools::GridToolType::Erase, Strings::Icon_Tool_Erase },
+			{ GridTools::GridToolType::Select, Strings::Icon_Tool_Select },
+			{ GridTools::GridToolType::Fill, Strings::Icon_Tool_Fill },
+			{ GridTools::GridToolType::Rectangle, Strings::Icon_Tool_Rectangle },
+			{ GridTools::GridToolType::RectangleOutline, Strings::Icon_Tool_Rectangle_Outline },
+			{ GridTools::GridToolType::Line, Strings::Icon_Tool_Line },
+			{ GridTools::GridToolType::Stamp, Strings::Icon_Tool_Stamp },
+		};
 		auto buttonSize = ImVec2(32, 32);
-		const char* iconStrings[] = { Strings::Icon_Tool_Place, Strings::Icon_Tool_Erase, Strings::Icon_Tool_Select };
-		for (int i = 0; i < toolCount; ++i) {
+		for (int i = 0; i < static_cast<int>(std::size(toolButtons)); ++i) {
+			const auto toolType = toolButtons[i].Type;
 			std::string buttonName = "ToolButton" + std::to_string(i);
 			ImGui::PushID(buttonName.c_str());
-			bool isSelected = i == static_cast<int>(gridToolBar->GetActiveTool());
+			bool isSelected = toolType == gridToolBar->GetActiveTool();
 
 			if (isSelected) {
 				PushStyleColor(ImGuiCol_Button, (ImVec4)ImColor(255, 255, 255));
 			}
 			int framePadding = 2;
 			int textureID = 0;
-			if (Rendering::Texture* tex = nullptr; Resources::TryGetInternalTexture(iconStrings[i], tex))
+			if (Rendering::Texture* tex = nullptr; Resources::TryGetInternalTexture(toolButtons[i].Icon, tex))
 				textureID = tex->GetTextureID();
 
 			if (ImageButton(reinterpret_cast<ImTextureID*>(textureID), buttonSize, ImVec2(0, 1), ImVec2(1, 0), framePadding)) {
-				auto toolType = static_cast<GridTools::GridToolType>(i);
-				std::cout << "Selected: " << i << std::endl;
+				std::cout << "Selected: " << static_cast<int>(toolType) << std::endl;
 				gridToolBar->SelectTool(toolType);
 			}
 			PopID();
@@ -418,6 +704,13 @@ void MainWindow::RenderImGui() {
 			SameLine();
 		}
 
+		if (gridToolBar->GetActiveTool() == GridTools::GridToolType::Fill) {
+			NewLine();
+			int maxFillArea = static_cast<int>(gridToolBar->MaxFillArea);
+			SetNextItemWidth(120);
+			if (InputInt("Max fill area", &maxFillArea, 1000, 100000)) gridToolBar->MaxFillArea = static_cast<size_t>(std::max(maxFillArea, 1));
+		}
+
 		float yPos = main_viewport->Size.y - main_viewport->WorkSize.y;
 		ImGui::SetWindowPos(ImVec2(0, yPos));
 	}
@@ -429,11 +722,28 @@ void MainWindow::RenderImGui() {
 	FileEditWindow::RenderAll();
 
 	// ############################### ImGui logic above this line #################################
+	RenderImGuiDrawData();
+}
+
+void MainWindow::RenderImGuiDrawData() {
 	// Required to render ImGuI
 	ImGui::Render();
+	PROFILE_GPU_SCOPE("ImGui_ImplOpenGL3_RenderDrawData");
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+void MainWindow::RenderLoadingProgress() {
+	using namespace ImGui;
+	const ImGuiViewport* main_viewport = GetMainViewport();
+	SetNextWindowPos(ImVec2(main_viewport->Size.x * 0.5f, main_viewport->Size.y * 0.5f), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+	SetNextWindowSize(ImVec2(400, 0));
+	if (Begin("Loading", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove)) {
+		ImGuiHelper::TextCentered("Loading Assets");
+		const std::string overlay = std::to_string(AssetLoader::GetCompletedSteps()) + " / " + std::to_string(AssetLoader::GetTotalSteps());
+		ProgressBar(AssetLoader::GetProgress(), ImVec2(-FLT_MIN, 0), overlay.c_str());
+	}
+	End();
+}
 
 void MainWindow::OnResized(int width, int height) {
 	MainWindow::height = height;
@@ -444,6 +754,10 @@ void MainWindow::OnResized(int width, int height) {
 	}
 }
 void MainWindow::Close() {
+	// workers may still be decoding if the window closes while loading
+	JobSystem::Shutdown();
+	AssetWatcher::Stop();
+	Profiling::Profiler::Shutdown();
 	Input::RemoveMouseBinding(binding);
 	for (auto& fBrowser : fileBrowsers) delete fBrowser;
 	Renderer::Exit();
@@ -29,7 +29,14 @@ class MainWindow {
 	GridTools::GridToolBar* gridToolBar = nullptr;
 	std::vector<FileBrowser*> fileBrowsers;
 
+	// time per frame spent uploading textures while assets are loading
+	static constexpr double assetUploadBudgetMS = 8.0;
+
 	void RenderImGui();
+	void RenderImGuiDrawData();
+	void RenderLoadingProgress();
+	void CreateFileBrowsers();
+	void OnAssetsLoaded();
 	bool InitSDL();
 	bool InitDearImGui();
 
@@ -0,0 +1,49 @@
+#include "MappedFile.h"
+
+#include <iostream>
+#include <Windows.h>
+
+bool MappedFile::Open(const std::filesystem::path& absolutePath) {
+	Close();
+
+	HANDLE file = CreateFileW(absolutePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		std::cout << "Unable to open file for mapping: " << absolutePath.string() << std::endl;
+		return false;
+	}
+	fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		// empty files can not be mapped
+		Close();
+		return false;
+	}
+	size = static_cast<size_t>(fileSize.QuadPart);
+
+	mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr) {
+		std::cout << "Unable to create file mapping: " << absolutePath.string() << " error: " << GetLastError() << std::endl;
+		Close();
+		return false;
+	}
+
+	data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (data == nullptr) {
+		std::cout << "Unable to map view of file: " << absolutePath.string() << " error: " << GetLastError() << std::endl;
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data != nullptr) UnmapViewOfFile(data);
+	if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+	if (fileHandle != nullptr) CloseHandle(fileHandle);
+	data = nullptr;
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+	size = 0;
+}
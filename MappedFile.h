@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+
+// Read-only memory mapping of a whole file, unmapped on destruction.
+class MappedFile {
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile& other) = delete;
+	MappedFile& operator=(const MappedFile& other) = delete;
+	~MappedFile() { Close(); }
+
+	bool Open(const std::filesystem::path& absolutePath);
+	void Close();
+
+	bool IsOpen() const { return data != nullptr; }
+	const uint8_t* GetData() const { return data; }
+	size_t GetSize() const { return size; }
+};
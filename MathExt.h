@@ -1,6 +1,9 @@
 #pragma once
 
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/geometric.hpp>
 
 struct Ray {
 	Ray(const glm::vec3& origin, const glm::vec3& direction)
@@ -10,3 +13,41 @@ struct Ray {
 	glm::vec3 Origin;
 	glm::vec3 Direction;
 };
+
+struct AABB {
+	AABB(const glm::vec3& min, const glm::vec3& max)
+		: Min(min),
+		  Max(max) {}
+
+	glm::vec3 Min;
+	glm::vec3 Max;
+};
+
+// Six clip planes extracted from a projection * view matrix, normals point inwards.
+struct Frustum {
+	glm::vec4 Planes[6];
+
+	explicit Frustum(const glm::mat4& viewProjection) {
+		// glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+		const auto row = [&viewProjection](const int i) { return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+		const glm::vec4 x = row(0), y = row(1), z = row(2), w = row(3);
+		Planes[0] = w + x; //left
+		Planes[1] = w - x; //right
+		Planes[2] = w + y; //bottom
+		Planes[3] = w - y; //top
+		Planes[4] = w + z; //near, clip space depth is -1 to 1
+		Planes[5] = w - z; //far
+	}
+
+	// Conservative test, boxes near the corners of the frustum may be reported as intersecting
+	bool Intersects(const AABB& box) const {
+		for (const auto& plane : Planes) {
+			// corner furthest along the plane normal
+			const glm::vec3 corner(plane.x >= 0 ? box.Max.x : box.Min.x,
+			                       plane.y >= 0 ? box.Max.y : box.Min.y,
+			                       plane.z >= 0 ? box.Max.z : box.Min.z);
+			if (glm::dot(glm::vec3(plane), corner) + plane.w < 0) return false;
+		}
+		return true;
+	}
+};
@@ -82,6 +82,8 @@ Mesh::StaticMesh* Mesh::StaticMesh::CreateDefaultCube() {
 }
 void Mesh::StaticMesh::UnloadFromGPU() {
 	glDeleteVertexArrays(1, &vertexArrayObject);
+	glDeleteBuffers(1, &vertexBufferObject);
+	glDeleteBuffers(1, &elementBufferObject);
 }
 Mesh::StaticMesh::StaticMesh(const float* vertPos, const float* texCoords, int vertCount) {
 	std::vector<Vertex> temp_verts;
@@ -111,11 +113,10 @@ void Mesh::StaticMesh::BindMeshDataToGPU() {
 	glBindVertexArray(vertexArrayObject);
 
 	//Create Buffers to store vertex data in
-	GLuint VBO;
-	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &vertexBufferObject);
 	glGenBuffers(1, &elementBufferObject);
 
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBufferObject);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), &vertices[0], GL_STATIC_DRAW);
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBufferObject);
@@ -136,6 +137,18 @@ void Mesh::StaticMesh::Draw() const {
 	glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
 	glBindVertexArray(0);
 }
+void Mesh::StaticMesh::BindToVertexArray(const unsigned int otherVertexArrayObject) const {
+	glVertexArrayVertexBuffer(otherVertexArrayObject, 0, vertexBufferObject, 0, sizeof(Vertex));
+	glVertexArrayElementBuffer(otherVertexArrayObject, elementBufferObject);
+
+	glEnableVertexArrayAttrib(otherVertexArrayObject, 0);
+	glVertexArrayAttribFormat(otherVertexArrayObject, 0, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Position));
+	glVertexArrayAttribBinding(otherVertexArrayObject, 0, 0);
+
+	glEnableVertexArrayAttrib(otherVertexArrayObject, 1);
+	glVertexArrayAttribFormat(otherVertexArrayObject, 1, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, TexCoords));
+	glVertexArrayAttribBinding(otherVertexArrayObject, 1, 0);
+}
 Mesh::StaticMesh* Mesh::StaticMesh::GetDefaultQuad() {
 	if (defaultQuad == nullptr) {
 		auto quad = CreateDefaultQuad();
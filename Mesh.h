@@ -87,6 +87,7 @@ namespace Mesh {
 		std::vector<Vertex> vertices;
 		std::vector<unsigned int> indices;
 		unsigned int vertexArrayObject = -1;
+		unsigned int vertexBufferObject = -1;
 		unsigned int elementBufferObject = -1;
 
 		inline static StaticMesh* defaultQuad = nullptr;
@@ -113,6 +114,10 @@ namespace Mesh {
 
 		void Draw() const;
 
+		// Binds this mesh's vertex and index buffers to another vertex array, attributes 0 and 1 like the default layout
+		void BindToVertexArray(unsigned int otherVertexArrayObject) const;
+		size_t GetIndexCount() const { return indices.size(); }
+
 		static StaticMesh* GetDefaultQuad();
 
 		static StaticMesh* GetDefaultQuadDoubleSided();
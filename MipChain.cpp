@@ -0,0 +1,92 @@
+#include "MipChain.h"
+
+#include <algorithm>
+
+#include "JobSystem.h"
+
+using namespace Rendering;
+
+namespace {
+	// rows per job, small levels are not worth splitting
+	constexpr size_t rowsPerJob = 64;
+
+	void Downsample(const unsigned char* source, const int sourceWidth, const int sourceHeight, unsigned char* destination, const int width,
+	                const size_t firstRow, const size_t endRow) {
+		constexpr int channels = MipChain::ChannelCount;
+		for (size_t y = firstRow; y < endRow; ++y) {
+			// odd sizes repeat the last row and column
+			const int y0 = std::min(static_cast<int>(y) * 2, sourceHeight - 1);
+			const int y1 = std::min(y0 + 1, sourceHeight - 1);
+			const unsigned char* row0 = source + static_cast<size_t>(y0) * sourceWidth * channels;
+			const unsigned char* row1 = source + static_cast<size_t>(y1) * sourceWidth * channels;
+			unsigned char* out = destination + y * width * channels;
+			for (int x = 0; x < width; ++x) {
+				const int x0 = std::min(x * 2, sourceWidth - 1) * channels;
+				const int x1 = std::min(x * 2 + 1, sourceWidth - 1) * channels;
+				for (int c = 0; c < channels; ++c) {
+					out[x * channels + c] = static_cast<unsigned char>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+				}
+			}
+		}
+	}
+}
+
+int MipChain::GetLevelCount(const int width, const int height) {
+	int levels = 1;
+	while (std::max(width, height) >> levels > 0) ++levels;
+	return levels;
+}
+
+void MipChain::Allocate(const int width, const int height) {
+	Clear();
+	baseWidth = width;
+	baseHeight = height;
+
+	const int levelCount = GetLevelCount(width, height);
+	size_t byteSize = 0;
+	for (int level = 1; level < levelCount; ++level) {
+		levelOffsets.push_back(byteSize);
+		byteSize += static_cast<size_t>(GetLevelWidth(level)) * GetLevelHeight(level) * ChannelCount;
+	}
+	pixels.resize(byteSize);
+}
+
+void MipChain::Generate(const unsigned char* basePixels, const int width, const int height) {
+	if (basePixels == nullptr || width <= 0 || height <= 0) {
+		Clear();
+		return;
+	}
+	Allocate(width, height);
+
+	const int levelCount = GetGeneratedLevelCount() + 1;
+	for (int level = 1; level < levelCount; ++level) {
+		const unsigned char* source = level == 1 ? basePixels : GetLevel(level - 1);
+		const int sourceWidth = GetLevelWidth(level - 1);
+		const int sourceHeight = GetLevelHeight(level - 1);
+		unsigned char* destination = pixels.data() + levelOffsets[level - 1];
+		const int levelWidth = GetLevelWidth(level);
+		JobSystem::ParallelFor(GetLevelHeight(level), rowsPerJob, [=](const size_t begin, const size_t end) {
+			Downsample(source, sourceWidth, sourceHeight, destination, levelWidth, begin, end);
+		});
+	}
+}
+
+bool MipChain::Load(const unsigned char* levelPixels, const size_t byteSize, const int width, const int height) {
+	if (levelPixels == nullptr || width <= 0 || height <= 0) {
+		Clear();
+		return false;
+	}
+	Allocate(width, height);
+	if (pixels.size() != byteSize) {
+		Clear();
+		return false;
+	}
+	std::copy_n(levelPixels, byteSize, pixels.data());
+	return true;
+}
+
+void MipChain::Clear() {
+	pixels.clear();
+	levelOffsets.clear();
+	baseWidth = baseHeight = 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace Rendering {
+	// Mip levels of an rgba image below level 0, built on the CPU so uploading only copies prebuilt levels.
+	// Every level is half the size of the previous one rounded down, down to 1x1. Levels are stored back to back.
+	class MipChain {
+		std::vector<unsigned char> pixels;
+		// per level starting at level 1
+		std::vector<size_t> levelOffsets;
+		int baseWidth = 0;
+		int baseHeight = 0;
+
+		void Allocate(int width, int height);
+
+	public:
+		static constexpr int ChannelCount = 4;
+
+		// Box filters every level from the previous one, the same filter glGenerateMipmap uses.
+		// Large levels are split across JobSystem workers, safe to call from worker threads
+		void Generate(const unsigned char* basePixels, int width, int height);
+		// Copies levels stored back to back, e.g. by the ImportCache. False if byteSize does not match the chain of the size
+		bool Load(const unsigned char* levelPixels, size_t byteSize, int width, int height);
+		void Clear();
+
+		// Including level 0
+		static int GetLevelCount(int width, int height);
+		static int GetLevelSize(const int baseSize, const int level) { return baseSize >> level > 0 ? baseSize >> level : 1; }
+		// Levels below 0, empty if not generated
+		int GetGeneratedLevelCount() const { return static_cast<int>(levelOffsets.size()); }
+		// level starts at 1
+		const unsigned char* GetLevel(const int level) const { return pixels.data() + levelOffsets[level - 1]; }
+		int GetLevelWidth(const int level) const { return GetLevelSize(baseWidth, level); }
+		int GetLevelHeight(const int level) const { return GetLevelSize(baseHeight, level); }
+		// All levels back to back, starting at level 1
+		const unsigned char* GetData() const { return pixels.data(); }
+		size_t GetByteSize() const { return pixels.size(); }
+	};
+}
@@ -0,0 +1,78 @@
+#include "Prefab.h"
+
+#include <iterator>
+
+#include "BinaryFormat.h"
+#include "Resources.h"
+#include "Strings.h"
+#include "Tile.h"
+
+Tiles::Prefab::Prefab(std::string name) : PersistentAsset(AssetId::CreateNewAssetId(), AssetType::Prefab, Strings::Directory_Prefabs, std::move(name)) {
+}
+
+Tiles::Prefab::Prefab(::AssetId assetId, const std::filesystem::path& relativeFilePath) :
+	PersistentAsset(assetId, AssetType::Prefab, relativeFilePath.parent_path(), relativeFilePath.filename().replace_extension().string()) {
+}
+
+void Tiles::Prefab::Reset(const glm::ivec2 size, const glm::ivec2 gridDimensions) {
+	Size = size;
+	GridDimensions = gridDimensions;
+	Palette.assign(1, nullptr);
+	const size_t cellCount = static_cast<size_t>(size.x) * size.y;
+	TileIndices.assign(cellCount, 0);
+	Masks.assign(cellCount, 0);
+}
+
+bool Tiles::Prefab::Deserialize(std::istream& iStream, const AssetHeader& header, Prefab*& out_prefab) {
+	const std::vector<char> payload((std::istreambuf_iterator<char>(iStream)), std::istreambuf_iterator<char>());
+	Serialization::BinaryReader reader(payload.data(), payload.size());
+
+	uint32_t magic = 0, version = 0;
+	if (!reader.Read(magic) || magic != BinaryMagic || !reader.Read(version) || version > BinaryVersion) {
+		std::cout << "Unsupported prefab format: " << header.relativeAssetPath.string() << std::endl;
+		return false;
+	}
+
+	auto prefabUPTR = std::make_unique<Prefab>(header.aId, header.relativeAssetPath);
+	glm::ivec2 size, gridDimensions;
+	uint32_t paletteCount = 0;
+	if (!reader.Read(size.x) || !reader.Read(size.y) || !reader.Read(gridDimensions.x) || !reader.Read(gridDimensions.y) || !reader.Read(paletteCount)) return false;
+	if (size.x < 0 || size.y < 0 || gridDimensions.x < 1 || gridDimensions.y < 1 || paletteCount > UINT16_MAX) return false;
+	prefabUPTR->Reset(size, gridDimensions);
+
+	for (uint32_t i = 0; i < paletteCount; ++i) {
+		std::string tileIdString;
+		::AssetId tileId;
+		Tile* tile = nullptr;
+		if (!reader.ReadString32(tileIdString) || !AssetId::TryParse(tileIdString, tileId)) return false;
+		if (!Resources::TryGetTile(tileId, tile)) {
+			std::cout << "unable to load tile " << tileIdString << " for prefab " << header.relativeAssetPath.string() << std::endl;
+			return false;
+		}
+		prefabUPTR->Palette.push_back(tile);
+	}
+
+	auto& indices = prefabUPTR->TileIndices;
+	auto& masks = prefabUPTR->Masks;
+	if (!reader.ReadBlock(indices.data(), indices.size() * sizeof(uint16_t)) || !reader.ReadBlock(masks.data(), masks.size())) return false;
+	for (const uint16_t index : indices) {
+		if (index > paletteCount) return false;
+	}
+
+	out_prefab = prefabUPTR.release();
+	return true;
+}
+
+void Tiles::Prefab::Serialize(std::ostream& oStream) const {
+	using namespace Serialization;
+	WriteLittleEndian(oStream, BinaryMagic);
+	WriteLittleEndian(oStream, BinaryVersion);
+	WriteLittleEndian(oStream, static_cast<int32_t>(Size.x));
+	WriteLittleEndian(oStream, static_cast<int32_t>(Size.y));
+	WriteLittleEndian(oStream, static_cast<int32_t>(GridDimensions.x));
+	WriteLittleEndian(oStream, static_cast<int32_t>(GridDimensions.y));
+	WriteLittleEndian(oStream, static_cast<uint32_t>(Palette.size() - 1));
+	for (size_t i = 1; i < Palette.size(); ++i) WriteString32(oStream, Palette[i]->GetAssetId().ToString());
+	WriteBlock(oStream, TileIndices.data(), TileIndices.size() * sizeof(uint16_t));
+	WriteBlock(oStream, Masks.data(), Masks.size());
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+
+#include "Assets.h"
+
+namespace Tiles {
+	class Tile;
+
+	// Rectangular block of cells copied from a tileMap: a local palette plus dense index and mask arrays.
+	// Sizes are in cells of GridDimensions, cells are stored row by row starting at the bottom left.
+	//
+	// Binary prefab format (after the asset header), all values little-endian:
+	//   u32 magic 'PRFB', u32 version, i32 size x/y, i32 gridDimensions x/y,
+	//   u32 paletteCount + paletteCount tile asset id strings (palette index 0 = empty),
+	//   u16 tileIndices[size x * size y], u8 masks[size x * size y].
+	class Prefab : public PersistentAsset<Prefab> {
+	public:
+		static constexpr uint32_t BinaryMagic = 0x42465250; // "PRFB"
+		static constexpr uint32_t BinaryVersion = 1;
+
+		glm::ivec2 Size = glm::ivec2(0, 0);
+		glm::ivec2 GridDimensions = glm::ivec2(1, 1);
+		std::vector<const Tile*> Palette{ nullptr };
+		std::vector<uint16_t> TileIndices;
+		std::vector<uint8_t> Masks;
+
+		explicit Prefab(std::string name = "");
+		Prefab(::AssetId assetId, const std::filesystem::path& relativeFilePath);
+
+		// Clears the palette and sizes the arrays to empty cells
+		void Reset(glm::ivec2 size, glm::ivec2 gridDimensions);
+		bool IsEmpty() const { return TileIndices.empty(); }
+		size_t GetCellIndex(const glm::ivec2 cell) const { return static_cast<size_t>(cell.y) * Size.x + cell.x; }
+		// First tile of the palette, used as thumbnail
+		const Tile* GetDisplayTile() const { return Palette.size() > 1 ? Palette[1] : nullptr; }
+
+		static bool Deserialize(std::istream& iStream, const AssetHeader& header, Prefab*& out_prefab);
+		void Serialize(std::ostream& oStream) const override;
+	};
+}
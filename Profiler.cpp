@@ -0,0 +1,395 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <unordered_map>
+#include <glad/glad.h>
+#include <imgui.h>
+
+using namespace Profiling;
+
+namespace {
+	constexpr unsigned int noGpuQuery = ~0u;
+	constexpr unsigned int queryAllocationCount = 32;
+
+	double ToMS(const uint64_t nanoseconds) { return static_cast<double>(nanoseconds) / 1000000.0; }
+
+	ImU32 GetScopeColor(const char* name) {
+		// same name, same color
+		const size_t hash = std::hash<std::string_view>()(name);
+		const float hue = static_cast<float>(hash % 360) / 360.0f;
+		float r, g, b;
+		ImGui::ColorConvertHSVtoRGB(hue, 0.55f, 0.8f, r, g, b);
+		return ImGui::ColorConvertFloat4ToU32(ImVec4(r, g, b, 1.0f));
+	}
+
+	void WriteJsonString(std::ostream& oStream, const std::string& text) {
+		oStream << '"';
+		for (const char c : text) {
+			if (c == '"' || c == '\\') oStream << '\\';
+			oStream << c;
+		}
+		oStream << '"';
+	}
+}
+
+void ThreadEventBuffer::Push(const ProfileEvent& event) {
+	const size_t write = writeIndex.load(std::memory_order_relaxed);
+	if (write - readIndex.load(std::memory_order_acquire) >= capacity) {
+		++DroppedEvents;
+		return;
+	}
+	events[write % capacity] = event;
+	writeIndex.store(write + 1, std::memory_order_release);
+}
+
+void ThreadEventBuffer::Drain(std::vector<ProfileEvent>& out_events) {
+	const size_t read = readIndex.load(std::memory_order_relaxed);
+	const size_t write = writeIndex.load(std::memory_order_acquire);
+	for (size_t i = read; i < write; ++i) out_events.push_back(events[i % capacity]);
+	readIndex.store(write, std::memory_order_release);
+}
+
+uint64_t Profiler::Now() {
+	static const auto startTime = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+ThreadEventBuffer& Profiler::GetThreadBuffer() {
+	thread_local ThreadEventBuffer* buffer = nullptr;
+	if (buffer != nullptr) return *buffer;
+
+	// Buffers are never freed, workers may exit while their events are still queued
+	std::lock_guard lock(threadBufferMutex);
+	auto newBuffer = std::make_unique<ThreadEventBuffer>();
+	newBuffer->ThreadIndex = static_cast<uint32_t>(threadBuffers.size());
+	newBuffer->ThreadName = "Thread " + std::to_string(threadBuffers.size());
+	buffer = newBuffer.get();
+	threadBuffers.push_back(std::move(newBuffer));
+	return *buffer;
+}
+
+void Profiler::SetThreadName(const char* name) {
+	ThreadEventBuffer& buffer = GetThreadBuffer();
+	std::lock_guard lock(threadBufferMutex);
+	buffer.ThreadName = name;
+}
+
+uint32_t Profiler::BeginScope() {
+	return GetThreadBuffer().Depth++;
+}
+
+void Profiler::EndScope(const char* name, const uint64_t start, const uint32_t depth) {
+	const uint64_t end = Now();
+	ThreadEventBuffer& buffer = GetThreadBuffer();
+	--buffer.Depth;
+	buffer.Push({ name, start, end, buffer.ThreadIndex, depth });
+}
+
+void Profiler::NewFrame() {
+	const uint64_t now = Now();
+
+	ProfileFrame& frame = GetFrame(frameNumber);
+	frame.End = now;
+	{
+		std::lock_guard lock(threadBufferMutex);
+		for (const auto& buffer : threadBuffers) buffer->Drain(frame.CpuEvents);
+	}
+
+	++frameNumber;
+	if (gpuEnabled) {
+		// slot was last used gpuFrameLatency frames ago, its results are ready by now
+		GpuFrame& gpuFrame = gpuFrames[frameNumber % gpuFrameLatency];
+		ResolveGpuFrame(gpuFrame);
+		gpuFrame.FrameNumber = frameNumber;
+		GLint64 gpuNow = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+		gpuFrame.CpuOffset = static_cast<int64_t>(Now()) - gpuNow;
+		gpuDepth = 0;
+	}
+
+	ProfileFrame& next = GetFrame(frameNumber);
+	next.FrameNumber = frameNumber;
+	next.Start = now;
+	next.End = 0;
+	next.CpuEvents.clear();
+	next.GpuEvents.clear();
+}
+
+void Profiler::InitializeGpu() {
+	gpuEnabled = GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query;
+	if (!gpuEnabled) {
+		std::cout << "GL timer queries not supported, profiler only records cpu timings." << std::endl;
+		return;
+	}
+	GpuFrame& gpuFrame = gpuFrames[frameNumber % gpuFrameLatency];
+	gpuFrame.FrameNumber = frameNumber;
+	GLint64 gpuNow = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+	gpuFrame.CpuOffset = static_cast<int64_t>(Now()) - gpuNow;
+}
+
+void Profiler::Shutdown() {
+	if (!gpuEnabled) return;
+	for (auto& gpuFrame : gpuFrames) {
+		for (const auto& query : gpuFrame.Queries) {
+			freeQueries.push_back(query.BeginQuery);
+			freeQueries.push_back(query.EndQuery);
+		}
+		gpuFrame.Queries.clear();
+	}
+	glDeleteQueries(static_cast<GLsizei>(freeQueries.size()), freeQueries.data());
+	freeQueries.clear();
+	gpuEnabled = false;
+}
+
+unsigned int Profiler::AcquireQuery() {
+	if (freeQueries.empty()) {
+		freeQueries.resize(queryAllocationCount);
+		glGenQueries(queryAllocationCount, freeQueries.data());
+	}
+	const unsigned int query = freeQueries.back();
+	freeQueries.pop_back();
+	return query;
+}
+
+unsigned int Profiler::BeginGpuScope(const char* name) {
+	if (!gpuEnabled) return noGpuQuery;
+	GpuFrame& gpuFrame = gpuFrames[frameNumber % gpuFrameLatency];
+	const GpuQuery query{ name, AcquireQuery(), AcquireQuery(), gpuDepth++ };
+	glQueryCounter(query.BeginQuery, GL_TIMESTAMP);
+	gpuFrame.Queries.push_back(query);
+	return static_cast<unsigned int>(gpuFrame.Queries.size() - 1);
+}
+
+void Profiler::EndGpuScope(const unsigned int query) {
+	if (query == noGpuQuery || !gpuEnabled) return;
+	--gpuDepth;
+	glQueryCounter(gpuFrames[frameNumber % gpuFrameLatency].Queries[query].EndQuery, GL_TIMESTAMP);
+}
+
+void Profiler::ResolveGpuFrame(GpuFrame& gpuFrame) {
+	if (gpuFrame.Queries.empty()) return;
+
+	// frames older than the history have been overwritten already
+	ProfileFrame* frame = frameNumber - gpuFrame.FrameNumber < frameHistoryCount ? &GetFrame(gpuFrame.FrameNumber) : nullptr;
+	for (const auto& query : gpuFrame.Queries) {
+		if (frame != nullptr) {
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(query.BeginQuery, GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(query.EndQuery, GL_QUERY_RESULT, &end);
+			frame->GpuEvents.push_back({ query.Name, begin + gpuFrame.CpuOffset, end + gpuFrame.CpuOffset, 0, query.Depth });
+		}
+		freeQueries.push_back(query.BeginQuery);
+		freeQueries.push_back(query.EndQuery);
+	}
+	gpuFrame.Queries.clear();
+}
+
+std::vector<const ProfileFrame*> Profiler::GetRetainedFrames() {
+	std::vector<const ProfileFrame*> result;
+	if (paused) {
+		result.reserve(pausedFrames.size());
+		for (const auto& frame : pausedFrames) result.push_back(&frame);
+		return result;
+	}
+
+	// the current frame is still being recorded
+	const uint64_t count = std::min<uint64_t>(frameNumber, frameHistoryCount - 1);
+	result.reserve(count);
+	for (uint64_t number = frameNumber - count; number < frameNumber; ++number) result.push_back(&GetFrame(number));
+	return result;
+}
+
+void Profiler::SetPaused(const bool pause) {
+	if (pause == paused) return;
+	pausedFrames.clear();
+	if (pause) {
+		for (const ProfileFrame* frame : GetRetainedFrames()) pausedFrames.push_back(*frame);
+	}
+	paused = pause;
+}
+
+std::vector<std::string> Profiler::GetThreadNames() {
+	std::lock_guard lock(threadBufferMutex);
+	std::vector<std::string> names;
+	names.reserve(threadBuffers.size());
+	for (const auto& buffer : threadBuffers) names.push_back(buffer->ThreadName);
+	return names;
+}
+
+bool Profiler::ExportChromeTrace(const std::string& filePath) {
+	std::ofstream file(filePath);
+	if (!file) {
+		std::cout << "Unable to write profile: " << filePath << std::endl;
+		return false;
+	}
+
+	const std::vector<std::string> threadNames = GetThreadNames();
+	const size_t gpuThreadId = threadNames.size();
+	file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+
+	bool first = true;
+	const auto writeEvent = [&](const std::string& name, const uint64_t start, const uint64_t end, const size_t threadId) {
+		if (!first) file << ",\n";
+		first = false;
+		file << "{\"name\":";
+		WriteJsonString(file, name);
+		file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadId << ",\"ts\":" << static_cast<double>(start) / 1000.0
+			<< ",\"dur\":" << static_cast<double>(end - start) / 1000.0 << "}";
+	};
+	const auto writeThreadName = [&](const std::string& name, const size_t threadId) {
+		if (!first) file << ",\n";
+		first = false;
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId << ",\"args\":{\"name\":";
+		WriteJsonString(file, name);
+		file << "}}";
+	};
+
+	for (size_t i = 0; i < threadNames.size(); ++i) writeThreadName(threadNames[i], i);
+	writeThreadName("GPU", gpuThreadId);
+
+	for (const ProfileFrame* frame : GetRetainedFrames()) {
+		writeEvent("Frame " + std::to_string(frame->FrameNumber), frame->Start, frame->End, gpuThreadId + 1);
+		for (const auto& event : frame->CpuEvents) writeEvent(event.Name, event.Start, event.End, event.ThreadIndex);
+		for (const auto& event : frame->GpuEvents) writeEvent(event.Name, event.Start, event.End, gpuThreadId);
+	}
+	writeThreadName("Frames", gpuThreadId + 1);
+	file << "]}\n";
+
+	std::cout << "Saved profile: " << filePath << std::endl;
+	return true;
+}
+
+void Profiler::RenderImGuiWindow(bool* open) {
+	using namespace ImGui;
+	SetNextWindowSize(ImVec2(800, 420), ImGuiCond_FirstUseEver);
+	if (!Begin("Profiler", open)) {
+		End();
+		return;
+	}
+
+	bool pause = paused;
+	if (Checkbox("Pause", &pause)) SetPaused(pause);
+	SameLine();
+	if (Button("Export Chrome Trace")) {
+		ExportChromeTrace("profile_" + std::to_string(frameNumber) + ".json");
+	}
+
+	const std::vector<const ProfileFrame*> retainedFrames = GetRetainedFrames();
+	if (retainedFrames.empty()) {
+		End();
+		return;
+	}
+
+	// Frame times, clicking a bar selects the frame
+	static uint64_t selectedFrameNumber = 0;
+	// gpu timings of the newest frames are not read back yet
+	const size_t liveFrameIndex = retainedFrames.size() - 1 - std::min(retainedFrames.size() - 1, gpuEnabled ? gpuFrameLatency : 0);
+	const ProfileFrame* selectedFrame = retainedFrames[liveFrameIndex];
+	std::vector<float> frameTimes(retainedFrames.size());
+	for (size_t i = 0; i < retainedFrames.size(); ++i) {
+		frameTimes[i] = static_cast<float>(ToMS(retainedFrames[i]->End - retainedFrames[i]->Start));
+		if (paused && retainedFrames[i]->FrameNumber == selectedFrameNumber) selectedFrame = retainedFrames[i];
+	}
+	PlotHistogram("##FrameTimes", frameTimes.data(), static_cast<int>(frameTimes.size()), 0, "Frame time (ms)", 0.0f, 33.3f, ImVec2(-FLT_MIN, 60));
+	if (IsItemClicked()) {
+		const float t = (GetMousePos().x - GetItemRectMin().x) / GetItemRectSize().x;
+		const size_t index = std::min(retainedFrames.size() - 1, static_cast<size_t>(std::max(0.0f, t) * retainedFrames.size()));
+		selectedFrameNumber = retainedFrames[index]->FrameNumber;
+		selectedFrame = retainedFrames[index];
+		SetPaused(true);
+	}
+	Text("Frame %llu: %.3f ms%s", static_cast<unsigned long long>(selectedFrame->FrameNumber), ToMS(selectedFrame->End - selectedFrame->Start), paused ? "" : " (pause or click a frame to inspect it)");
+
+	// Timeline, one lane per thread plus the gpu
+	const std::vector<std::string> threadNames = GetThreadNames();
+	std::vector<uint32_t> laneDepths(threadNames.size() + 1, 0);
+	for (const auto& event : selectedFrame->CpuEvents) laneDepths[event.ThreadIndex] = std::max(laneDepths[event.ThreadIndex], event.Depth + 1);
+	for (const auto& event : selectedFrame->GpuEvents) laneDepths.back() = std::max(laneDepths.back(), event.Depth + 1);
+
+	const float rowHeight = GetTextLineHeight() + 4.0f;
+	constexpr float labelWidth = 80.0f;
+	std::vector<float> laneOffsets(laneDepths.size(), 0.0f);
+	float timelineHeight = 0.0f;
+	for (size_t lane = 0; lane < laneDepths.size(); ++lane) {
+		laneOffsets[lane] = timelineHeight;
+		if (laneDepths[lane] > 0) timelineHeight += laneDepths[lane] * rowHeight + 4.0f;
+	}
+
+	const ImVec2 origin = GetCursorScreenPos();
+	const float timelineWidth = std::max(1.0f, GetContentRegionAvail().x - labelWidth);
+	InvisibleButton("##Timeline", ImVec2(labelWidth + timelineWidth, std::max(timelineHeight, rowHeight)));
+	ImDrawList* drawList = GetWindowDrawList();
+	const double frameDuration = static_cast<double>(std::max<uint64_t>(1, selectedFrame->End - selectedFrame->Start));
+	const ImVec2 mouse = GetMousePos();
+	const ProfileEvent* hoveredEvent = nullptr;
+
+	const auto drawEvent = [&](const ProfileEvent& event, const size_t lane) {
+		// events of worker jobs may start before or end after the frame
+		const double start = std::clamp((static_cast<double>(event.Start) - selectedFrame->Start) / frameDuration, 0.0, 1.0);
+		const double end = std::clamp((static_cast<double>(event.End) - selectedFrame->Start) / frameDuration, 0.0, 1.0);
+		const ImVec2 min(origin.x + labelWidth + static_cast<float>(start) * timelineWidth, origin.y + laneOffsets[lane] + event.Depth * rowHeight);
+		const ImVec2 max(std::max(min.x + 1.0f, origin.x + labelWidth + static_cast<float>(end) * timelineWidth), min.y + rowHeight - 1.0f);
+		drawList->AddRectFilled(min, max, GetScopeColor(event.Name));
+		if (max.x - min.x > CalcTextSize(event.Name).x + 4.0f) drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32_BLACK, event.Name);
+		if (mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y) hoveredEvent = &event;
+	};
+
+	for (size_t lane = 0; lane < laneDepths.size(); ++lane) {
+		if (laneDepths[lane] == 0) continue;
+		const char* laneName = lane < threadNames.size() ? threadNames[lane].c_str() : "GPU";
+		drawList->AddText(ImVec2(origin.x, origin.y + laneOffsets[lane] + 2.0f), GetColorU32(ImGuiCol_Text), laneName);
+	}
+	for (const auto& event : selectedFrame->CpuEvents) drawEvent(event, event.ThreadIndex);
+	for (const auto& event : selectedFrame->GpuEvents) drawEvent(event, laneDepths.size() - 1);
+
+	if (hoveredEvent != nullptr && IsItemHovered()) {
+		SetTooltip("%s\n%.3f ms", hoveredEvent->Name, ToMS(hoveredEvent->End - hoveredEvent->Start));
+	}
+
+	// Totals per scope of the selected frame
+	struct ScopeTotal {
+		const char* Name;
+		bool Gpu;
+		uint64_t Duration;
+		int Calls;
+	};
+	std::vector<ScopeTotal> totals;
+	std::unordered_map<std::string_view, size_t> cpuLookup, gpuLookup;
+	const auto addTotal = [&totals](std::unordered_map<std::string_view, size_t>& lookup, const ProfileEvent& event, const bool gpu) {
+		const auto [it, inserted] = lookup.try_emplace(event.Name, totals.size());
+		if (inserted) totals.push_back({ event.Name, gpu, 0, 0 });
+		totals[it->second].Duration += event.End - event.Start;
+		++totals[it->second].Calls;
+	};
+	for (const auto& event : selectedFrame->CpuEvents) addTotal(cpuLookup, event, false);
+	for (const auto& event : selectedFrame->GpuEvents) addTotal(gpuLookup, event, true);
+	std::sort(totals.begin(), totals.end(), [](const ScopeTotal& a, const ScopeTotal& b) { return a.Duration > b.Duration; });
+
+	if (BeginTable("ScopeTotals", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY)) {
+		TableSetupColumn("Scope");
+		TableSetupColumn("Timer");
+		TableSetupColumn("Total ms");
+		TableSetupColumn("Calls");
+		TableHeadersRow();
+		for (const auto& total : totals) {
+			TableNextRow();
+			TableNextColumn();
+			TextUnformatted(total.Name);
+			TableNextColumn();
+			TextUnformatted(total.Gpu ? "GPU" : "CPU");
+			TableNextColumn();
+			Text("%.3f", ToMS(total.Duration));
+			TableNextColumn();
+			Text("%d", total.Calls);
+		}
+		EndTable();
+	}
+
+	End();
+}
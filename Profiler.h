@@ -0,0 +1,155 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Set to 0 to compile all profiling scopes out
+#ifndef ENABLE_PROFILER
+#define ENABLE_PROFILER 1
+#endif
+
+namespace Profiling {
+	// Timestamps are nanoseconds since the profiler was first used
+	struct ProfileEvent {
+		const char* Name;
+		uint64_t Start;
+		uint64_t End;
+		uint32_t ThreadIndex;
+		uint32_t Depth;
+	};
+
+	struct ProfileFrame {
+		uint64_t FrameNumber = 0;
+		uint64_t Start = 0;
+		uint64_t End = 0;
+		std::vector<ProfileEvent> CpuEvents;
+		// mapped onto the cpu clock, ThreadIndex is unused
+		std::vector<ProfileEvent> GpuEvents;
+	};
+
+	// Single producer single consumer ring: the owning thread writes, the main thread drains once per frame
+	class ThreadEventBuffer {
+		static constexpr size_t capacity = 4096;
+		std::array<ProfileEvent, capacity> events{};
+		std::atomic<size_t> writeIndex{ 0 };
+		std::atomic<size_t> readIndex{ 0 };
+
+	public:
+		std::string ThreadName;
+		uint32_t ThreadIndex = 0;
+		uint32_t Depth = 0;
+		size_t DroppedEvents = 0;
+
+		void Push(const ProfileEvent& event);
+		void Drain(std::vector<ProfileEvent>& out_events);
+	};
+
+	// Timestamp queries of one frame, read back gpuFrameLatency frames later
+	struct GpuQuery {
+		const char* Name;
+		unsigned int BeginQuery;
+		unsigned int EndQuery;
+		uint32_t Depth;
+	};
+	struct GpuFrame {
+		uint64_t FrameNumber = 0;
+		// added to gpu timestamps to map them onto the cpu clock
+		int64_t CpuOffset = 0;
+		std::vector<GpuQuery> Queries;
+	};
+
+	class Profiler {
+		static constexpr size_t frameHistoryCount = 240;
+		// frames until gpu timestamps are read back
+		static constexpr size_t gpuFrameLatency = 4;
+
+		inline static std::mutex threadBufferMutex;
+		inline static std::vector<std::unique_ptr<ThreadEventBuffer>> threadBuffers;
+
+		inline static std::array<ProfileFrame, frameHistoryCount> frames{};
+		inline static uint64_t frameNumber = 0;
+		inline static bool paused = false;
+		// copy of the history taken when pausing, oldest first
+		inline static std::vector<ProfileFrame> pausedFrames;
+
+		inline static bool gpuEnabled = false;
+		inline static uint32_t gpuDepth = 0;
+		inline static std::array<GpuFrame, gpuFrameLatency> gpuFrames{};
+		inline static std::vector<unsigned int> freeQueries;
+
+		static ThreadEventBuffer& GetThreadBuffer();
+		static ProfileFrame& GetFrame(uint64_t number) { return frames[number % frameHistoryCount]; }
+		static void ResolveGpuFrame(GpuFrame& gpuFrame);
+		static unsigned int AcquireQuery();
+		// Completed frames of the live or paused history, oldest first
+		static std::vector<const ProfileFrame*> GetRetainedFrames();
+		static std::vector<std::string> GetThreadNames();
+		// Pausing freezes the displayed and exported history, recording continues
+		static void SetPaused(bool pause);
+
+	public:
+		static uint64_t Now();
+
+		// Ends the current frame and starts the next one, call once per frame on the main thread
+		static void NewFrame();
+		// Requires a current GL context with timer queries
+		static void InitializeGpu();
+		static void Shutdown();
+		static void SetThreadName(const char* name);
+
+		// Returns the nesting depth of the new scope
+		static uint32_t BeginScope();
+		static void EndScope(const char* name, uint64_t start, uint32_t depth);
+
+		static unsigned int BeginGpuScope(const char* name);
+		static void EndGpuScope(unsigned int query);
+
+		// Writes the retained frames in the Chrome trace event format, viewable in chrome://tracing or Perfetto
+		static bool ExportChromeTrace(const std::string& filePath);
+		static void RenderImGuiWindow(bool* open);
+	};
+
+	class ScopedTimer {
+		const char* name;
+		uint32_t depth;
+		uint64_t start;
+
+	public:
+		ScopedTimer(const ScopedTimer& other) = delete;
+		ScopedTimer& operator=(const ScopedTimer& other) = delete;
+
+		explicit ScopedTimer(const char* name) : name(name), depth(Profiler::BeginScope()), start(Profiler::Now()) { }
+		~ScopedTimer() { Profiler::EndScope(name, start, depth); }
+	};
+
+	// Records GL timestamps around the scope, main thread only
+	class ScopedGpuTimer {
+		unsigned int query;
+
+	public:
+		ScopedGpuTimer(const ScopedGpuTimer& other) = delete;
+		ScopedGpuTimer& operator=(const ScopedGpuTimer& other) = delete;
+
+		explicit ScopedGpuTimer(const char* name) : query(Profiler::BeginGpuScope(name)) { }
+		~ScopedGpuTimer() { Profiler::EndGpuScope(query); }
+	};
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if ENABLE_PROFILER
+// name has to outlive the profiler, use string literals
+#define PROFILE_SCOPE(name) const Profiling::ScopedTimer PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+// Times the scope on the cpu and the gpu
+#define PROFILE_GPU_SCOPE(name) PROFILE_SCOPE(name); const Profiling::ScopedGpuTimer PROFILE_CONCAT(profileGpuScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_GPU_SCOPE(name)
+#endif
@@ -7,11 +7,14 @@
 #include "glad.h"
 #include "MainWindow.h"
 #include "Mesh.h"
+#include "Profiler.h"
 #include "Resources.h"
 #include "Shader.h"
 #include "Time.h"
 #include "Renderable.h"
 #include "Texture.h"
+#include "TextureAtlas.h"
+#include "ThumbnailCache.h"
 
 using namespace Rendering;
 
@@ -66,16 +69,23 @@ bool Renderer::InitOpenGL(SDL_Window* window) {
 
 void Renderer::CompileShader() {
 	delete defaultShader;
+	delete instancedShader;
 	delete gridShader;
 
 	defaultShader = new Shader("default");
+	instancedShader = new Shader("defaultInstanced");
+	instancedShader->Use();
+	instancedShader->setInt("textureArray", 1);
 	gridShader = new Shader("2DGrid");
 }
 
 void Renderer::Exit() {
 	delete defaultShader;
+	delete instancedShader;
 	delete gridShader;
 	delete camera;
+	TextureAtlas::Free();
+	ThumbnailCache::Free();
 }
 
 bool Renderer::Init() {
@@ -83,7 +93,18 @@ bool Renderer::Init() {
 }
 
 void Renderer::Render() {
+	PROFILE_GPU_SCOPE("Renderer::Render");
 	//___ LOOPED RENDERING CODE
+	// upload textures packed since last frame
+	{
+		PROFILE_SCOPE("TextureAtlas::Build");
+		TextureAtlas::Build();
+	}
+	{
+		PROFILE_SCOPE("ThumbnailCache::Update");
+		ThumbnailCache::Update();
+	}
+
 	// use shader program
 	defaultShader->Use();
 
@@ -93,6 +114,11 @@ void Renderer::Render() {
 	// projection matrix transforms view space to however we want to display (orthogonal, perspective)
 	defaultShader->setMat4("projection", *Camera::Main->GetProjectionMatrix());
 
+	instancedShader->Use();
+	instancedShader->setMat4("view", *Camera::Main->GetViewMatrix());
+	instancedShader->setMat4("projection", *Camera::Main->GetProjectionMatrix());
+	defaultShader->Use();
+
 	for (const auto& renderObject : RenderObjects) {
 		if (!renderObject->renderingEnabled) continue;
 		renderObject->Render();
@@ -14,6 +14,7 @@ namespace Rendering {
 		static bool InitOpenGL(SDL_Window* window);
 	public:
 		inline static Shader* defaultShader = nullptr;
+		inline static Shader* instancedShader = nullptr;
 		inline static Shader* gridShader = nullptr;
 
 		inline static bool DrawGrid = true;
@@ -5,52 +5,45 @@
 
 #include "Texture.h"
 #include "Tile.h"
+#include "Prefab.h"
 #include "Files.h"
 #include "Mesh.h"
 #include "Strings.h"
 #include "TextureSheet.h"
 
-inline bool LoadTex(const char* relative_path, const bool refresh, std::map<std::string, Rendering::Texture*>& map, Rendering::Texture*& out_texture, bool isInternal) {
-	out_texture = nullptr;
-
-	const auto texIterator = map.find(relative_path);
-	if (const bool exists = texIterator != map.end()) {
-		if (refresh) texIterator->second->Refresh();
-		out_texture = texIterator->second;
-		return true;
-	}
-
-	if (!Rendering::Texture::LoadFromFile(relative_path, out_texture)) return false;
-
-	return true;
-}
-
 bool Resources::LoadTexture(const char* relative_path, const bool refresh) {
 	Rendering::Texture* _;
-	return LoadTex(relative_path, refresh, Textures, _, false);
+	return LoadTexture(relative_path, _, refresh);
 }
 
 bool Resources::LoadTexture(const char* relative_path, Rendering::Texture*& out_texture, const bool refresh) {
-	return LoadTex(relative_path, refresh, Textures, out_texture, false);
+	// already loaded textures are refreshed by Texture::Deserialize
+	out_texture = nullptr;
+	return Rendering::Texture::LoadFromFile(relative_path, out_texture);
 }
 
 bool Resources::LoadInternalTexture(const char* relative_path, const bool refresh) {
-	Rendering::Texture* _;
-	return LoadTex(relative_path, refresh, InternalTextures, _, true);
+	const auto texIterator = InternalTextures.find(relative_path);
+	if (texIterator != InternalTextures.end()) {
+		if (refresh) texIterator->second->Refresh();
+		return true;
+	}
+
+	Rendering::Texture* _ = nullptr;
+	return Rendering::Texture::LoadFromFile(relative_path, _);
 }
 
 void Resources::AssignOwnership(Rendering::Texture* texture) {
-	auto& map = texture->IsInternal() ? InternalTextures : Textures;
-	map[texture->IsInternal() ? texture->GetImageFilePath() : texture->AssetId] = texture;
-	// Internal textures are referenced by their path
+	if (texture->IsInternal()) InternalTextures[texture->GetImageFilePath()] = texture;
+	else Textures[texture->AssetId] = texture;
 
-	AssetsIdReferences[texture->AssetId.ToString()] = texture->GetImageFilePath();
+	AssetsIdReferences[texture->AssetId] = texture->GetImageFilePath();
 }
 
 void Resources::ReleaseOwnership(const Rendering::Texture* texture, bool deleteObject) {
-	auto& map = texture->IsInternal() ? InternalTextures : Textures;
-	map.erase(texture->AssetId);
-	AssetsIdReferences.erase(texture->AssetId);
+	if (texture->IsInternal()) InternalTextures.erase(texture->GetImageFilePath());
+	else Textures.Erase(texture->AssetId);
+	AssetsIdReferences.Erase(texture->AssetId);
 	if (deleteObject)
 		delete texture;
 }
@@ -64,6 +57,16 @@ void Resources::AssignOwnership(Mesh::StaticMesh* mesh) {
 	Meshes.push_back(mesh);
 }
 
+void Resources::AssignOwnership(Tiles::Tile* tile) {
+	Tiles[tile->AssetId] = tile;
+	AssetsIdReferences[tile->AssetId] = tile->GetRelativeAssetPath().string();
+}
+
+void Resources::AssignOwnership(Tiles::Prefab* prefab) {
+	Prefabs[prefab->AssetId] = prefab;
+	AssetsIdReferences[prefab->AssetId] = prefab->GetRelativeAssetPath().string();
+}
+
 bool Resources::TryLoadAssetFromHeader(const AssetHeader& header, bool refresh) {
 	const auto relPath = header.relativeAssetPath.string();
 	switch (header.aType) {
@@ -75,13 +78,23 @@ bool Resources::TryLoadAssetFromHeader(const AssetHeader& header, bool refresh)
 			return LoadTextureSheet(relPath.c_str(), refresh);
 		case AssetType::Tile:
 			return LoadTile(relPath.c_str(), refresh);
+		case AssetType::Prefab:
+			return LoadPrefab(relPath.c_str(), refresh);
 		case AssetType::Level:
 		case AssetType::UNKNOWN:
 		default: throw std::exception("unexpected case reached");
 	}
 }
 
-void Resources::LoadDirectory(const char* directory, bool refresh, bool includeSubdirectories, std::vector<AssetHeader>* out_Assets) {
+bool Resources::LoadAsset(const AssetHeader& header) {
+	return AssetIsLoaded(header.aId) || TryLoadAssetFromHeader(header, false);
+}
+
+bool Resources::RefreshAsset(const AssetHeader& header) {
+	return TryLoadAssetFromHeader(header, true);
+}
+
+void Resources::LoadDirectory(const char* directory, bool refresh, bool includeSubdirectories, std::vector<AssetHeader>* out_Assets, bool loadImages) {
 	auto dir_iterator = Files::GetDirectoryIterator(directory);
 
 	// we want to match each file with their corresponding .asset meta file
@@ -91,7 +104,7 @@ void Resources::LoadDirectory(const char* directory, bool refresh, bool includeS
 
 	for (auto& entry : dir_iterator) {
 		if (includeSubdirectories && entry.is_directory()) {
-			LoadDirectory(entry.path().string().c_str(), refresh, includeSubdirectories, out_Assets);
+			LoadDirectory(entry.path().string().c_str(), refresh, includeSubdirectories, out_Assets, loadImages);
 			continue;
 		}
 
@@ -118,7 +131,8 @@ void Resources::LoadDirectory(const char* directory, bool refresh, bool includeS
 	for (auto it = metaFiles.begin(); it != metaFiles.end(); ++it) {
 		auto& entry = it;
 		bool loaded = AssetIsLoaded(entry->aId);
-		if (!loaded && !TryLoadAssetFromHeader(*entry, refresh)) {
+		const bool isImage = entry->aType == AssetType::Texture || entry->aType == AssetType::TextureSheet;
+		if (!loaded && (loadImages || !isImage) && !TryLoadAssetFromHeader(*entry, refresh)) {
 			std::cout << "Unable to find corresponding file: " << entry->relativeAssetPath.string().c_str() << " delete meta file if no longer needed" << std::endl;
 			continue;
 		}
@@ -189,12 +203,15 @@ void Resources::LoadDirectory(const char* directory, bool refresh, bool includeS
 }
 
 bool Resources::LoadTextureSheet(const char* relative_path, bool refresh) {
-	const auto tsIt = TextureSheets.find(relative_path);
-	if (tsIt != TextureSheets.end()) {
-		if (refresh) {
-			throw std::exception("texture sheet refresh not implemented");
-		} //TODO: implement refresh
-		return true;
+	const std::filesystem::path absolutePath = Files::GetAbsolutePath(relative_path);
+	AssetHeader header;
+	if (Rendering::TextureSheet* loaded; refresh && AssetHeader::TryReadHeaderFromFile(absolutePath, &header) && TryGetTextureSheet(header.aId, loaded)) {
+		Rendering::DecodedImage image;
+		if (!Rendering::TextureSheet::DecodeFromAssetFile(absolutePath, image)) {
+			std::cout << "Unable to refresh Texturesheet: " << relative_path << std::endl;
+			return false;
+		}
+		return loaded->Reload(absolutePath, image);
 	}
 
 	Rendering::TextureSheet* t = nullptr;
@@ -208,42 +225,55 @@ bool Resources::LoadTextureSheet(const char* relative_path, bool refresh) {
 }
 
 bool Resources::AssetIsLoaded(const AssetId& id) {
-	return AssetsIdReferences.find(id.ToString()) != AssetsIdReferences.end();
+	return AssetsIdReferences.Contains(id);
 }
 
 bool Resources::LoadTile(const char* relative_path, bool refresh) {
 	using namespace Tiles;
-	const auto tileIterator = Tiles.find(relative_path);
-	if (tileIterator != Tiles.end()) {
-		if (refresh) {
-			throw std::exception("tile refresh not implemented");
-		} //TODO: implement refresh
-		return true;
-	}
-
 	Tile* t = nullptr;
 	if (!Tile::LoadFromFile(relative_path, t)) {
 		std::cout << "unable to load Tile: " << relative_path << std::endl;
 		return false;
 	}
 
-	Tiles[t->AssetId] = t;
-	AssetsIdReferences[t->AssetId] = relative_path;
+	// tileMaps and prefabs point to loaded tiles, so they are refreshed in place
+	if (Tile* loaded; refresh && TryGetTile(t->AssetId, loaded)) {
+		*loaded = std::move(*t);
+		delete t;
+		AssetsIdReferences[loaded->AssetId] = loaded->GetRelativeAssetPath().string();
+		return true;
+	}
+
+	AssignOwnership(t);
 	return true;
 }
 
-inline bool TryGetTex(const std::string& key, Rendering::Texture*& out_texture, std::map<std::string, Rendering::Texture*>& map) {
-	out_texture = Rendering::Texture::Empty();
-	if (const auto it = map.find(key); it != map.end()) out_texture = it->second;
-	return out_texture != Rendering::Texture::Empty();
+bool Resources::LoadPrefab(const char* relative_path, bool refresh) {
+	Tiles::Prefab* prefab = nullptr;
+	if (!Tiles::Prefab::LoadFromFile(relative_path, prefab)) {
+		std::cout << "unable to load Prefab: " << relative_path << std::endl;
+		return false;
+	}
+
+	if (Tiles::Prefab* loaded; refresh && TryGetPrefab(prefab->AssetId, loaded)) {
+		*loaded = std::move(*prefab);
+		delete prefab;
+		AssetsIdReferences[loaded->AssetId] = loaded->GetRelativeAssetPath().string();
+		return true;
+	}
+
+	AssignOwnership(prefab);
+	return true;
 }
 
 //Returns Texture::Empty() on fail.
-bool Resources::TryGetTexture(const std::string& assetId, Rendering::Texture*& out_texture) {
-	return TryGetTex(assetId, out_texture, Textures);
+bool Resources::TryGetTexture(const AssetId& assetId, Rendering::Texture*& out_texture) {
+	Rendering::Texture* const* texture = Textures.Find(assetId);
+	out_texture = texture != nullptr ? *texture : Rendering::Texture::Empty();
+	return texture != nullptr;
 }
 
-unsigned Resources::TryGetTextureId(const std::string& assetId) {
+unsigned Resources::TryGetTextureId(const AssetId& assetId) {
 	unsigned int textureId = 0;
 	if (Rendering::Texture* t; TryGetTexture(assetId, t)) {
 		textureId = t->GetTextureID();
@@ -252,20 +282,26 @@ unsigned Resources::TryGetTextureId(const std::string& assetId) {
 }
 
 bool Resources::TryGetInternalTexture(const char* relativePath, Rendering::Texture*& out_texture) {
-	return TryGetTex(relativePath, out_texture, InternalTextures);
+	out_texture = Rendering::Texture::Empty();
+	if (const auto it = InternalTextures.find(relativePath); it != InternalTextures.end()) out_texture = it->second;
+	return out_texture != Rendering::Texture::Empty();
 }
 
-bool Resources::TryGetTile(const std::string& assetId, Tiles::Tile*& out_tile) {
-	out_tile = nullptr;
-	if (const auto it = Tiles.find(assetId); it != Tiles.end()) out_tile = it->second;
-
+bool Resources::TryGetTile(const AssetId& assetId, Tiles::Tile*& out_tile) {
+	Tiles::Tile* const* tile = Tiles.Find(assetId);
+	out_tile = tile != nullptr ? *tile : nullptr;
 	return out_tile != nullptr;
 }
 
-bool Resources::TryGetTextureSheet(const std::string& assetId, Rendering::TextureSheet*& out_textureSheet) {
-	out_textureSheet = nullptr;
-	if (const auto it = TextureSheets.find(assetId); it != TextureSheets.end()) out_textureSheet = it->second;
+bool Resources::TryGetPrefab(const AssetId& assetId, Tiles::Prefab*& out_prefab) {
+	Tiles::Prefab* const* prefab = Prefabs.Find(assetId);
+	out_prefab = prefab != nullptr ? *prefab : nullptr;
+	return out_prefab != nullptr;
+}
 
+bool Resources::TryGetTextureSheet(const AssetId& assetId, Rendering::TextureSheet*& out_textureSheet) {
+	Rendering::TextureSheet* const* textureSheet = TextureSheets.Find(assetId);
+	out_textureSheet = textureSheet != nullptr ? *textureSheet : nullptr;
 	return out_textureSheet != nullptr;
 }
 
@@ -275,15 +311,18 @@ void FreeCollection(PointerCollection pCollection) {
 		delete p;
 }
 
-template<typename PointerMap>
-void FreeMap(PointerMap pMap) {
-	for (auto& pair : pMap)
-		delete pair.second;
+template<typename PointerTable>
+void FreeTable(PointerTable& pTable) {
+	// moved out first, destructors may release ownership of other assets
+	PointerTable table = std::move(pTable);
+	pTable.Clear();
+	table.ForEach([](const AssetId&, auto* p) { delete p; });
 }
 
 void Resources::FreeAll() {
 	FreeCollection(Meshes);
-	FreeMap(Textures);
-	FreeMap(Tiles);
-	FreeMap(TextureSheets);
+	FreeTable(Textures);
+	FreeTable(Tiles);
+	FreeTable(TextureSheets);
+	FreeTable(Prefabs);
 }
\ No newline at end of file
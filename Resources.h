@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "Assets.h"
+#include "AssetTable.h"
 
 
 namespace Rendering {
@@ -13,6 +14,7 @@ namespace Rendering {
 
 namespace Tiles {
 	class Tile;
+	class Prefab;
 }
 
 
@@ -21,14 +23,18 @@ namespace Mesh {
 }
 
 class Resources {
-	inline static std::map<std::string, std::string> AssetsIdReferences;
-	inline static std::map<std::string, Rendering::Texture*> Textures;
+	// relative path of every loaded asset
+	inline static AssetTable<std::string> AssetsIdReferences;
+	inline static AssetTable<Rendering::Texture*> Textures;
+	// Internal textures are referenced by their path
 	inline static std::map<std::string, Rendering::Texture*> InternalTextures;
-	inline static std::map<std::string, Tiles::Tile*> Tiles;
-	inline static std::map<std::string, Rendering::TextureSheet*> TextureSheets;
+	inline static AssetTable<Tiles::Tile*> Tiles;
+	inline static AssetTable<Rendering::TextureSheet*> TextureSheets;
+	inline static AssetTable<Tiles::Prefab*> Prefabs;
 	inline static std::vector<Mesh::StaticMesh*> Meshes;
 
 	static bool LoadTile(const char* relative_path, bool refresh = false);
+	static bool LoadPrefab(const char* relative_path, bool refresh = false);
 	static bool LoadTexture(const char* relative_path, bool refresh = false);
 	static bool LoadTexture(const char* relative_path, Rendering::Texture*& out_texture, bool refresh = false);
 	static bool LoadTextureSheet(const char* relative_path, bool refresh = false);
@@ -39,21 +45,35 @@ public:
 	static const std::map<std::string, Rendering::Texture*>& GetInternalTextures() {
 		return InternalTextures;
 	}
+	static const AssetTable<Rendering::Texture*>& GetTextures() {
+		return Textures;
+	}
+	static const AssetTable<Rendering::TextureSheet*>& GetTextureSheets() {
+		return TextureSheets;
+	}
 
 	static bool AssetIsLoaded(const AssetId& id);
 
+	// loadImages false only lists textures and textureSheets that are not loaded yet, see LoadAsset
 	static void LoadDirectory(const char* directory, bool refresh, bool includeSubdirectories,
-	                          std::vector<AssetHeader>* out_Assets = nullptr);
+	                          std::vector<AssetHeader>* out_Assets = nullptr, bool loadImages = true);
+	// Loads the asset unless it is loaded already
+	static bool LoadAsset(const AssetHeader& header);
+	// Loads the asset or reloads it in place, pointers to loaded assets stay valid
+	static bool RefreshAsset(const AssetHeader& header);
 	static void AssignOwnership(Rendering::TextureSheet* sheet);
 	static void AssignOwnership(Rendering::Texture* texture);
 	static void ReleaseOwnership(const Rendering::Texture* texture, bool deleteObject = false);
 	static void AssignOwnership(Mesh::StaticMesh* mesh);
+	static void AssignOwnership(Tiles::Tile* tile);
+	static void AssignOwnership(Tiles::Prefab* prefab);
 
-	static bool TryGetTexture(const std::string& assetId, Rendering::Texture*& out_texture);
+	static bool TryGetTexture(const AssetId& assetId, Rendering::Texture*& out_texture);
 	static bool TryGetInternalTexture(const char* relativePath, Rendering::Texture*& out_texture);
-	static bool TryGetTile(const std::string& assetId, Tiles::Tile*& out_tile);
-	static bool TryGetTextureSheet(const std::string& assetId, Rendering::TextureSheet*& out_textureSheet);
-	static unsigned TryGetTextureId(const std::string& assetId);
+	static bool TryGetTile(const AssetId& assetId, Tiles::Tile*& out_tile);
+	static bool TryGetTextureSheet(const AssetId& assetId, Rendering::TextureSheet*& out_textureSheet);
+	static bool TryGetPrefab(const AssetId& assetId, Tiles::Prefab*& out_prefab);
+	static unsigned TryGetTextureId(const AssetId& assetId);
 
 	static void FreeAll();
 };
\ No newline at end of file
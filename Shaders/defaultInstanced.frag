@@ -0,0 +1,25 @@
+#version 460 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+flat in vec4 UvRect;
+flat in float Layer;
+
+uniform sampler2D texture1;
+// textureSheets stored as array textures, used by instances with a layer
+uniform sampler2DArray textureArray;
+// below 1 for translucent previews
+uniform float opacity = 1.0;
+
+void main() {
+	if (Layer < 0.0) {
+		// subTexture views and atlas regions share the texture with their neighbours,
+		// staying half a texel inside the rect keeps linear filtering from reading them
+		vec2 halfTexel = 0.5 / vec2(textureSize(texture1, 0));
+		vec2 clamped = clamp(TexCoord, UvRect.xy + halfTexel, UvRect.xy + UvRect.zw - halfTexel);
+		// mip selection from the unclamped coordinates, they keep changing across the clamped border
+		FragColor = textureGrad(texture1, clamped, dFdx(TexCoord), dFdy(TexCoord));
+	}
+	else FragColor = texture(textureArray, vec3(TexCoord, Layer));
+	FragColor.a *= opacity;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#version 460 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec2 aOffset;
+layout (location = 3) in vec2 aScale;
+layout (location = 4) in vec4 aUvRect;
+layout (location = 5) in float aLayer;
+
+out vec2 TexCoord;
+flat out vec4 UvRect;
+flat out float Layer;
+
+uniform float depth;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main() {
+    vec2 worldPos = aPos.xy * aScale + aOffset;
+    gl_Position = projection*view*vec4(worldPos, depth, 1.0);
+    TexCoord = aUvRect.xy + aTexCoord * aUvRect.zw;
+    UvRect = aUvRect;
+    Layer = aLayer;
+}
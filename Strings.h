@@ -8,6 +8,10 @@ namespace Strings {
 	constexpr char Directory_Tiles[] = "Tiles";
 	constexpr char Directory_TextureSheets[] = "TextureSheets";
 	constexpr char Directory_Levels[] = "Levels";
+	constexpr char Directory_Prefabs[] = "Prefabs";
+	constexpr char Directory_Cache[] = "Cache";
+	constexpr char File_ThumbnailCache[] = "Cache\\thumbnails.pack";
+	constexpr char Directory_ImportCache[] = "Cache\\Imports";
 	// Resources
 	constexpr char Icon_Unknown_File[] = "Resources\\Icons\\unknown_file.png";
 	constexpr char Icon_New_File[] = "Resources\\Icons\\new_file.png";
@@ -15,6 +19,11 @@ namespace Strings {
 	constexpr char Icon_Tool_Place[] = "Resources\\Icons\\tool_place.png";
 	constexpr char Icon_Tool_Erase[] = "Resources\\Icons\\tool_erase.png";
 	constexpr char Icon_Tool_Select[] = "Resources\\Icons\\tool_select.png";
+	constexpr char Icon_Tool_Fill[] = "Resources\\Icons\\tool_fill.png";
+	constexpr char Icon_Tool_Rectangle[] = "Resources\\Icons\\tool_rect.png";
+	constexpr char Icon_Tool_Rectangle_Outline[] = "Resources\\Icons\\tool_rect_outline.png";
+	constexpr char Icon_Tool_Line[] = "Resources\\Icons\\tool_line.png";
+	constexpr char Icon_Tool_Stamp[] = "Resources\\Icons\\tool_stamp.png";
 	constexpr char Icon_Previous_Directory[] = "Resources\\Icons\\previous_directory.png";
 }
 
@@ -6,15 +6,22 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
+#include <algorithm>
+#include <climits>
+#include <fstream>
 #include <iostream>
 #include "glad.h"
 #include "Files.h"
+#include "ImportCache.h"
+#include "MappedFile.h"
 #include "Resources.h"
 #include "Serialization.h"
+#include "Strings.h"
+#include "TextureAtlas.h"
 
 using namespace Rendering;
 
-inline bool ImageProperties::SetColorProfile() {
+bool ImageProperties::SetColorProfile() {
 	switch (channelCount) {
 		case 3:
 			colorProfile = GL_RGB;
@@ -44,7 +51,8 @@ Texture::Texture(unsigned int id, const std::filesystem::path& relativePathToIma
 }
 
 bool Texture::LoadImageData(const std::string& relative_path, ImageProperties& out_imageProperties, unsigned char*& out_rawData, bool flipVertically) {
-	stbi_set_flip_vertically_on_load(flipVertically);
+	// per thread, images are decoded on worker threads while loading
+	stbi_set_flip_vertically_on_load_thread(flipVertically);
 	const std::filesystem::path absolutePath = Files::GetAbsolutePath(relative_path);
 	//Force 4 color channels so ImGui doesn't die
 	out_rawData = stbi_load(absolutePath.string().c_str(), &out_imageProperties.width, &out_imageProperties.height, &out_imageProperties.channelCount, 4);
@@ -58,7 +66,32 @@ bool Texture::LoadImageData(const std::string& relative_path, ImageProperties& o
 	return true;
 }
 
-void Texture::BindToGPUAndFreeData(const unsigned int& texture_id, const ImageProperties& imageProperties, unsigned char*& imageData) {
+bool Texture::LoadImageDataFromMemory(const unsigned char* encodedImage, const size_t byteSize, const std::string& relative_path, ImageProperties& out_imageProperties,
+                                      unsigned char*& out_rawData, const bool flipVertically) {
+	stbi_set_flip_vertically_on_load_thread(flipVertically);
+	out_rawData = stbi_load_from_memory(encodedImage, static_cast<int>(byteSize), &out_imageProperties.width, &out_imageProperties.height, &out_imageProperties.channelCount, 4);
+	out_imageProperties.channelCount = 4;
+	if (out_rawData == nullptr) {
+		std::cout << "Unable to load image: " << relative_path << " : " << stbi_failure_reason() << std::endl;
+		return false;
+	}
+	return out_imageProperties.SetColorProfile();
+}
+
+bool Texture::LoadImageProperties(const std::string& relative_path, ImageProperties& out_imageProperties) {
+	const std::filesystem::path absolutePath = Files::GetAbsolutePath(relative_path);
+	if (!stbi_info(absolutePath.string().c_str(), &out_imageProperties.width, &out_imageProperties.height, &out_imageProperties.channelCount)) {
+		std::cout << "Unable to load image: " << relative_path << " : " << stbi_failure_reason() << std::endl;
+		return false;
+	}
+	// same as LoadImageData, which forces 4 channels
+	out_imageProperties.channelCount = 4;
+	return out_imageProperties.SetColorProfile();
+}
+
+int Texture::BindToGPUAndFreeData(const unsigned int& texture_id, DecodedImage& image) {
+	const ImageProperties& imageProperties = image.Properties;
+	const MipChain& mips = image.Mips;
 	//TODO: allow customization of parameters
 	glBindTexture(GL_TEXTURE_2D, texture_id);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -66,47 +99,157 @@ void Texture::BindToGPUAndFreeData(const unsigned int& texture_id, const ImagePr
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, imageProperties.colorProfile, imageProperties.width, imageProperties.height, 0, imageProperties.colorProfile, GL_UNSIGNED_BYTE, imageData);
-	glGenerateMipmap(GL_TEXTURE_2D);
-	free(imageData);
+	if (image.Compression != TextureCompression::None) {
+		const GLenum format = TextureEncoder::GetGLFormat(image.Compression);
+		const int fullLevelCount = MipChain::GetLevelCount(imageProperties.width, imageProperties.height);
+		size_t offset = 0;
+		int levelCount = 0;
+		for (; levelCount < fullLevelCount; ++levelCount) {
+			const int width = MipChain::GetLevelSize(imageProperties.width, levelCount);
+			const int height = MipChain::GetLevelSize(imageProperties.height, levelCount);
+			const size_t byteSize = TextureEncoder::GetEncodedSize(image.Compression, width, height);
+			if (offset + byteSize > image.EncodedLevels.size()) break;
+			glCompressedTexImage2D(GL_TEXTURE_2D, levelCount, format, width, height, 0, static_cast<GLsizei>(byteSize), image.EncodedLevels.data() + offset);
+			offset += byteSize;
+		}
+		// sampling stops at the last uploaded level, the texture would be incomplete and black otherwise
+		if (levelCount < fullLevelCount) {
+			std::cout << "Encoded levels of " << image.ImageFilePath << " end after level " << levelCount - 1 << ", smaller levels are not used." << std::endl;
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, std::max(levelCount - 1, 0));
+		image.EncodedLevels.clear();
+		image.EncodedLevels.shrink_to_fit();
+		return levelCount;
+	}
+
+	// sized, glCopyImageSubData only copies between matching formats such as the rgba8 layers of sheet array textures
+	const GLint internalFormat = imageProperties.colorProfile == GL_RGBA ? GL_RGBA8 : GL_RGB8;
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, imageProperties.width, imageProperties.height, 0, imageProperties.colorProfile, GL_UNSIGNED_BYTE, image.Data);
+	// rgba rows are always 4 byte aligned
+	for (int level = 1; level <= mips.GetGeneratedLevelCount(); ++level) {
+		glTexImage2D(GL_TEXTURE_2D, level, internalFormat, mips.GetLevelWidth(level), mips.GetLevelHeight(level), 0, imageProperties.colorProfile,
+		             GL_UNSIGNED_BYTE, mips.GetLevel(level));
+	}
+	int levelCount = 1 + mips.GetGeneratedLevelCount();
+	if (mips.GetGeneratedLevelCount() == 0) {
+		glGenerateMipmap(GL_TEXTURE_2D);
+		levelCount = MipChain::GetLevelCount(imageProperties.width, imageProperties.height);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+	free(image.Data);
+	image.Data = nullptr;
+	image.Mips.Clear();
+	return levelCount;
+}
+
+void Texture::EncodeDecodedImage(DecodedImage& image) {
+	if (image.Compression == TextureCompression::None || image.Data == nullptr) return;
+	const int width = image.Properties.width;
+	const int height = image.Properties.height;
+	image.EncodedLevels.clear();
+	image.EncodedLevels.reserve(TextureEncoder::GetMipChainSize(image.Compression, width, height));
+	TextureEncoder::Encode(image.Compression, image.Data, width, height, image.EncodedLevels);
+	for (int level = 1; level <= image.Mips.GetGeneratedLevelCount(); ++level) {
+		TextureEncoder::Encode(image.Compression, image.Mips.GetLevel(level), image.Mips.GetLevelWidth(level), image.Mips.GetLevelHeight(level), image.EncodedLevels);
+	}
+	free(image.Data);
+	image.Data = nullptr;
+	image.Mips.Clear();
 }
 
 ImageProperties Texture::GetImageProperties() const {
 	return imageProperties;
 }
 unsigned Texture::GetTextureID() const {
+	if (viewSource != nullptr) return viewSource->textureId;
+	if (AtlasRegion region; textureId == 0 && TextureAtlas::TryGetRegion(AssetId, region)) return TextureAtlas::GetPageTextureId(region.Page);
 	return textureId;
 }
+glm::vec4 Texture::GetUvRect() const {
+	if (AtlasRegion region; textureId == 0 && viewSource == nullptr && TextureAtlas::TryGetRegion(AssetId, region)) return region.UvRect;
+	return uvRect;
+}
 
-bool Texture::Create(const std::filesystem::path& relativePathToImageFile, Texture*& out_texture, bool isInternal, ::AssetId assetId) {
-	ImageProperties imgProps{};
-	unsigned char* rawImageData = nullptr;
-	if (!LoadImageData(relativePathToImageFile.string(), imgProps, rawImageData)) return false;
-	out_texture = CreateFromData(rawImageData, imgProps, relativePathToImageFile, assetId, isInternal);
+bool Texture::Create(const std::filesystem::path& relativePathToImageFile, Texture*& out_texture, bool isInternal, ::AssetId assetId, const TextureCompression compression) {
+	DecodedImage image;
+	const bool loaded = isHeadless ? LoadImageProperties(relativePathToImageFile.string(), image.Properties) : DecodeImage(relativePathToImageFile.string(), image, compression);
+	if (!loaded) return false;
+	image.AssetId = assetId;
+	image.ImageFilePath = relativePathToImageFile.string();
+	image.IsInternal = isInternal;
+	image.Compression = compression;
+	out_texture = CreateFromData(image);
 	return true;
 }
 
 bool Texture::LoadAndBind(const std::string& relativePathToImageFile, ImageProperties& out_imgProps, unsigned int out_textureId) {
-	unsigned char* rawImageData = nullptr;
-	if (!LoadImageData(relativePathToImageFile, out_imgProps, rawImageData)) return false;
+	DecodedImage image;
+	if (!DecodeImage(relativePathToImageFile, image)) return false;
+	out_imgProps = image.Properties;
 	glGenTextures(1, &out_textureId);
-	BindToGPUAndFreeData(textureId, out_imgProps, rawImageData);
+	BindToGPUAndFreeData(textureId, image);
 	return true;
 }
 
-Texture* Texture::CreateFromData(unsigned char* rawImageData, const ImageProperties& imgProps, const std::filesystem::path& relativePathToImageFile, const ::AssetId& assetId, bool isInternal, std::string nameSuffix) {
-	unsigned int textureId;
-	glGenTextures(1, &textureId);
-	BindToGPUAndFreeData(textureId, imgProps, rawImageData);
+bool Texture::ShouldUseAtlas(const std::filesystem::path& relativePathToImageFile, bool isInternal, const TextureCompression compression) {
+	// the atlas pages are rgba8
+	if (isInternal || compression != TextureCompression::None) return false;
+	// loose sprites only, textureSheet slices are views into their sheet's texture and already share it
+	return Files::PathIsSubPathOfRel(relativePathToImageFile, Strings::Directory_Sprites);
+}
+
+Texture* Texture::CreateFromData(DecodedImage& image, std::string nameSuffix) {
+	const std::filesystem::path relativePathToImageFile = image.ImageFilePath;
+	unsigned int textureId = 0;
+	int levelCount = 0;
+	if (isHeadless) {
+		free(image.Data);
+		image.Data = nullptr;
+	}
+	else {
+		// atlased sprites are drawn from their atlas page only
+		if (ShouldUseAtlas(relativePathToImageFile, image.IsInternal, image.Compression) &&
+			TextureAtlas::Submit(image.AssetId, image.Data, image.Properties.width, image.Properties.height)) {
+			free(image.Data);
+			image.Data = nullptr;
+		}
+		else {
+			glGenTextures(1, &textureId);
+			levelCount = BindToGPUAndFreeData(textureId, image);
 #ifdef _DEBUG
-	std::cout << "Image " << relativePathToImageFile.filename().string() << nameSuffix << " bound to textureID: " << textureId << std::endl;
+			std::cout << "Image " << relativePathToImageFile.filename().string() << nameSuffix << " bound to textureID: " << textureId << std::endl;
 #endif
+		}
+	}
 
-	return new Texture(textureId, relativePathToImageFile, imgProps, assetId, isInternal, nameSuffix);
+	Texture* texture = new Texture(textureId, relativePathToImageFile, image.Properties, image.AssetId, image.IsInternal, nameSuffix);
+	texture->compression = image.Compression;
+	texture->levelCount = levelCount;
+	return texture;
 }
 
-void Texture::RefreshFromDataAndFree(unsigned char* rawImageData, const ImageProperties& imgProps) {
-	BindToGPUAndFreeData(textureId, imgProps, rawImageData);
+void Texture::RefreshFromDataAndFree(DecodedImage& image) {
+	imageProperties = image.Properties;
+	compression = image.Compression;
+	if (isHeadless) {
+		free(image.Data);
+		image.Data = nullptr;
+		return;
+	}
+	if (ShouldUseAtlas(pathToImageFile, isInternalTexture, compression) && TextureAtlas::Submit(AssetId, image.Data, imageProperties.width, imageProperties.height)) {
+		free(image.Data);
+		image.Data = nullptr;
+		if (textureId != 0) glDeleteTextures(1, &textureId);
+		textureId = 0;
+		levelCount = 0;
+		return;
+	}
+	// e.g. compressed now, or grown past what the atlas takes
+	TextureAtlas::Remove(AssetId);
+	if (textureId == 0) glGenTextures(1, &textureId);
+	levelCount = BindToGPUAndFreeData(textureId, image);
+	// keeps the cap of a sliced sheet, slicing again recomputes it
+	if (maxMipLevel < levelCount - 1) glTextureParameteri(textureId, GL_TEXTURE_MAX_LEVEL, maxMipLevel);
 #ifdef _DEBUG
 	std::cout << "Image " << Name << " refreshed to textureID: " << textureId << std::endl;
 #endif
@@ -129,73 +272,70 @@ bool Texture::CreateNew(const std::filesystem::path& relativePathToImageFile, bo
 	return true;
 }
 
-void Texture::SliceSubTextureFromData(unsigned char* rawImageData, const ImageProperties& imProps, const SubTextureData& subTextureData, const int subTextureCount, Texture*& out_TexturePtr) const {
-	const size_t pixelByteSize = imProps.channelCount;
-	const size_t originRowByteSize = pixelByteSize * imProps.width;
-
-	const size_t subTextureSize = pixelByteSize * subTextureData.height * subTextureData.width;
-	auto* rawSubTextureData = new unsigned char[subTextureSize];
-	// copies whole rows minus offsets into new SubTextureData
-	// since whole rows are copied, destination offset is always row-yOffset * subTextureWidth
-	const size_t newRowByteSize = pixelByteSize * subTextureData.width;
-
-	for (size_t row = subTextureData.yOffset; row < subTextureData.yOffset + subTextureData.height; row++) {
-		const auto rowOffset = row * originRowByteSize;
-		const auto columnOffset = subTextureData.xOffset * pixelByteSize;
-		const auto srcOffset = rowOffset + columnOffset;
-		const auto dstOffset = (row - subTextureData.yOffset) * newRowByteSize;
-		memcpy(rawSubTextureData + dstOffset, rawImageData + srcOffset, newRowByteSize);
-	}
-
+Texture* Texture::GetOrCreateSubTextureView(const SubTextureData& subTextureData, const int subTextureCount) const {
 	ImageProperties subTexImgProps{};
 	subTexImgProps.width = subTextureData.width;
 	subTexImgProps.height = subTextureData.height;
 	subTexImgProps.channelCount = imageProperties.channelCount;
 	subTexImgProps.colorProfile = imageProperties.colorProfile;
 
-	//flip now before passing to GPU
-	stbi__vertical_flip(rawSubTextureData, subTextureData.width, subTextureData.height, static_cast<int>(pixelByteSize));
-
-	//if asset id exists, refresh it instead of creating a new one
+	//if asset id exists, update it instead of creating a new one
+	Texture* view = nullptr;
 	if (Resources::AssetIsLoaded(subTextureData.assetId)) {
-		if (!Resources::TryGetTexture(subTextureData.assetId, out_TexturePtr)) throw std::exception("unable to get loaded texture");
-		out_TexturePtr->RefreshFromDataAndFree(rawSubTextureData, subTexImgProps);
-		return;
+		if (!Resources::TryGetTexture(subTextureData.assetId, view)) throw std::exception("unable to get loaded texture");
+	}
+	else {
+		const std::string nameSuffix = subTextureSuffix + std::to_string(subTextureCount);
+		view = new Texture(0, GetImageFilePath(), subTexImgProps, subTextureData.assetId, false, nameSuffix);
 	}
-	const std::string nameSuffix = subTextureSuffix + std::to_string(subTextureCount);
-	out_TexturePtr = CreateFromData(rawSubTextureData, subTexImgProps, GetImageFilePath(), subTextureData.assetId, false, nameSuffix);
+
+	// yOffset is from the top, the texture is stored bottom row first
+	const float width = static_cast<float>(imageProperties.width);
+	const float height = static_cast<float>(imageProperties.height);
+	view->viewSource = this;
+	view->imageProperties = subTexImgProps;
+	view->uvRect = glm::vec4(subTextureData.xOffset / width, (imageProperties.height - subTextureData.yOffset - subTextureData.height) / height,
+	                         subTextureData.width / width, subTextureData.height / height);
+	return view;
 }
 
-bool Texture::CreateSubTextures(const std::vector<SubTextureData>& subTextureData, std::vector<Texture*>& out_textures) const {
+bool Texture::CreateSubTextures(const std::vector<SubTextureData>& subTextureData, std::vector<Texture*>& out_textures) {
 	if (this == empty) {
 		std::cout << "Tried to slice empty texture" << std::endl;
 		return false;
 	}
 
-	unsigned char* rawImageData = nullptr;
-	ImageProperties imageProps{};
-	//load without flip so yOffset is from the top instead of the bottom as expected
-	if (!LoadImageData(GetImageFilePath(), imageProps, rawImageData, false)) return false;
-
+	// Level n averages blocks of 2^n texels, which stay inside a subTexture as long as its edges are multiples of 2^n.
+	// Compressed levels are also stored in 4x4 blocks, so there the edges have to be multiples of 4 * 2^n.
+	// Filtering a level still reads the texels across a subTexture's border, the shader clamps that away for the base level only.
+	// Levels are capped so every subTexture keeps at least 2 texels, there neighbours only blend at the border instead of entirely.
+	int alignment = 0;
+	int minEdge = INT_MAX;
 	for (const auto& sData : subTextureData) {
-		if (imageProps.width < sData.xOffset + sData.width || imageProps.height < sData.yOffset + sData.height) {
+		if (imageProperties.width < sData.xOffset + sData.width || imageProperties.height < sData.yOffset + sData.height) {
 			std::cout << "ERROR: Can't create SubTexture from " << GetRelativeAssetPath() << " :" << "SubTexture does not fit within Texture!" << std::endl;
-			free(rawImageData);
 			return false;
 		}
+		alignment |= sData.xOffset | sData.width | sData.height | (imageProperties.height - sData.yOffset - sData.height);
+		minEdge = std::min(minEdge, std::min(sData.width, sData.height));
 	}
+	const int blockAlignment = compression != TextureCompression::None ? TextureEncoder::BlockSize : 1;
+	const bool blockAligned = (alignment & (blockAlignment - 1)) == 0;
+	if (!blockAligned) {
+		std::cout << "WARNING: SubTextures of " << GetRelativeAssetPath() << " are not aligned to compressed 4x4 blocks, neighbouring subTextures mix." << std::endl;
+	}
+	// recomputed on every call, the compression may have changed since
+	// smaller levels may be missing, e.g. of a shorter encoded chain
+	const int maxUploadedLevel = textureId != 0 ? levelCount - 1 : INT_MAX;
+	int levels = 0;
+	while (blockAligned && levels < maxUploadedLevel && minEdge >> (levels + 1) >= 2 && (alignment & blockAlignment << levels) == 0) ++levels;
+	maxMipLevel = levels;
+	if (textureId != 0) glTextureParameteri(textureId, GL_TEXTURE_MAX_LEVEL, maxMipLevel);
 
 	int subTextureCount = 0;
 	for (const auto& sData : subTextureData) {
-		Texture* tPtr = nullptr;
-		SliceSubTextureFromData(rawImageData, imageProps, sData, subTextureCount++, tPtr);
-		out_textures.push_back(tPtr);
-		//std::cout << "SubTextureData " << newPath.string().c_str() << " bound to textureID: " << tPtr->GetTextureID() << std::endl;
+		out_textures.push_back(GetOrCreateSubTextureView(sData, subTextureCount++));
 	}
-
-	//stbi_write_png(newPath.string().c_str(), imageProperties.width, imageProperties.height, imageProperties.channelCount, subTextureData, static_cast<int>(newRowByteSize));
-
-	free(rawImageData);
 	return true;
 }
 
@@ -206,7 +346,84 @@ bool Texture::CanCreateFromPath(const char* absolutePath) {
 	return ok;
 }
 
+bool Texture::DecodeImage(const std::string& relativeImagePath, DecodedImage& out_image, const TextureCompression compression) {
+	out_image.ImageFilePath = relativeImagePath;
+	out_image.Compression = compression;
+	if (!ImportCache::IsEnabled()) {
+		if (!LoadImageData(relativeImagePath, out_image.Properties, out_image.Data)) return false;
+		out_image.Mips.Generate(out_image.Data, out_image.Properties.width, out_image.Properties.height);
+		EncodeDecodedImage(out_image);
+		return true;
+	}
+
+	// the file is hashed for the cache key anyway, so it is decoded from the mapping on a miss
+	MappedFile file;
+	if (!file.Open(Files::GetAbsolutePath(relativeImagePath))) return false;
+	ImportSettings settings;
+	settings.Compression = compression;
+	const uint64_t key = ImportCache::GetKey(file.GetData(), file.GetSize(), settings);
+	ImageProperties& properties = out_image.Properties;
+	if (ImportCache::TryRead(key, out_image)) {
+		properties.channelCount = 4;
+		return properties.SetColorProfile();
+	}
+
+	if (!LoadImageDataFromMemory(file.GetData(), file.GetSize(), relativeImagePath, properties, out_image.Data)) return false;
+	out_image.Mips.Generate(out_image.Data, properties.width, properties.height);
+	EncodeDecodedImage(out_image);
+	ImportCache::Write(key, out_image);
+	return true;
+}
+
+bool Texture::DecodeFromAssetFile(const std::filesystem::path& absoluteAssetPath, DecodedImage& out_image) {
+	std::ifstream file(absoluteAssetPath, std::iostream::binary);
+	if (!file) return false;
+
+	AssetHeader header;
+	if (!AssetHeader::Read(file, &header)) return false;
+	if (header.aType != AssetType::Texture && header.aType != AssetType::TextureInternal) return false;
+
+	out_image.AssetId = header.aId;
+	Serialization::readFromStream(file, out_image.IsInternal);
+	const std::string imageFilePath = Serialization::DeserializeStdString(file);
+	TextureCompression compression = TextureCompression::None;
+	if (file.peek() != EOF) Serialization::readFromStream(file, compression);
+	file.close();
+
+	return DecodeImage(imageFilePath, out_image, compression);
+}
+
+bool Texture::CreateFromDecodedImage(DecodedImage& image, Texture*& out_texture) {
+	if (Resources::AssetIsLoaded(image.AssetId)) {
+		free(image.Data);
+		image.Data = nullptr;
+		return image.IsInternal ? Resources::TryGetInternalTexture(image.ImageFilePath.c_str(), out_texture) : Resources::TryGetTexture(image.AssetId, out_texture);
+	}
+
+	out_texture = CreateFromData(image);
+	return true;
+}
+
+void Texture::RefreshFromDecodedImage(DecodedImage& image) {
+	RefreshFromDataAndFree(image);
+}
+
+size_t Texture::GetGpuByteSize() const {
+	if (viewSource != nullptr || textureId == 0) return 0;
+	return TextureEncoder::GetMipChainSize(compression, imageProperties.width, imageProperties.height);
+}
+
+size_t Texture::GetUncompressedGpuByteSize() const {
+	if (viewSource != nullptr || textureId == 0) return 0;
+	return TextureEncoder::GetMipChainSize(TextureCompression::None, imageProperties.width, imageProperties.height);
+}
+
 void Texture::Serialize(std::ostream& oStream) const {
+	SerializeImageReference(oStream);
+	Serialization::writeToStream(oStream, compression);
+}
+
+void Texture::SerializeImageReference(std::ostream& oStream) const {
 	Serialization::writeToStream(oStream, isInternalTexture);
 	Serialization::Serialize(oStream, GetImageFilePath());
 }
@@ -214,17 +431,25 @@ void Texture::Serialize(std::ostream& oStream) const {
 bool Texture::Deserialize(std::istream& iStream, const AssetHeader& header, Texture*& out_texture) {
 	bool isInternal = false; Serialization::readFromStream(iStream, isInternal);
 	const std::string imageFilePath = Serialization::DeserializeStdString(iStream);
+	// textures saved before compression was an option end here
+	TextureCompression fileCompression = TextureCompression::None;
+	if (iStream.peek() != EOF) Serialization::readFromStream(iStream, fileCompression);
+	return Load(imageFilePath, isInternal, fileCompression, header.aId, out_texture);
+}
+
+bool Texture::Load(const std::string& relativeImagePath, const bool isInternal, const TextureCompression compression, const ::AssetId& assetId, Texture*& out_texture) {
 	//check if it already exists
-	if (!Resources::AssetIsLoaded(header.aId)) {
-		return Create(imageFilePath, out_texture, isInternal, header.aId);
+	if (!Resources::AssetIsLoaded(assetId)) {
+		return Create(relativeImagePath, out_texture, isInternal, assetId, compression);
 	}
 
-	if(!Resources::TryGetTexture(header.aId, out_texture)) {
+	if(!Resources::TryGetTexture(assetId, out_texture)) {
 		std::cerr << "Error while deserializing texture: already loaded but cant get from resources." << std::endl;
 		return false;
 	}
 
-	return out_texture->Refresh(imageFilePath);
+	out_texture->compression = compression;
+	return out_texture->Refresh(relativeImagePath);
 }
 
 bool Texture::Refresh(const std::string& path) {
@@ -234,18 +459,21 @@ bool Texture::Refresh(const std::string& path) {
 #endif
 		return false;
 	}
-	unsigned char* rawImageData = nullptr;
-
+	// subTextures are updated by reslicing their textureSheet
+	if (viewSource != nullptr) return false;
 	const auto& imagePath = path.empty() ? GetImageFilePath() : path;
-	if (!LoadImageData(imagePath, imageProperties, rawImageData)) return false;
-	RefreshFromDataAndFree(rawImageData, imageProperties);
+	if (isHeadless) return LoadImageProperties(imagePath, imageProperties);
+	DecodedImage image;
+	if (!DecodeImage(imagePath, image, compression)) return false;
+	RefreshFromDataAndFree(image);
 
 	return true;
 }
 
 // Texture should be deleted through Resources::ReleaseOwnership, to make sure to remove it from resources
 Texture::~Texture() {
-	glDeleteTextures(1, &textureId);
+	if (textureId != 0) glDeleteTextures(1, &textureId);
+	TextureAtlas::Remove(AssetId);
 #ifdef _DEBUG
 	std::cout << "Image " << Name << " deleted." << std::endl;
 #endif
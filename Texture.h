@@ -2,8 +2,11 @@
 
 #include <string>
 #include <filesystem>
+#include <glm/vec4.hpp>
 
 #include "Assets.h"
+#include "MipChain.h"
+#include "TextureEncoder.h"
 #include "SubTextureData.h"
 
 namespace Rendering {
@@ -18,6 +21,19 @@ namespace Rendering {
 		ImageProperties() = default;
 	};
 
+	// Image of a texture asset decoded off the main thread, data is freed once uploaded
+	struct DecodedImage {
+		::AssetId AssetId;
+		std::string ImageFilePath;
+		bool IsInternal = false;
+		ImageProperties Properties{};
+		unsigned char* Data = nullptr;
+		Rendering::MipChain Mips;
+		// Data and Mips are empty if compressed, EncodedLevels holds every level back to back instead, largest first
+		TextureCompression Compression = TextureCompression::None;
+		std::vector<unsigned char> EncodedLevels;
+	};
+
 
 	class Texture : public PersistentAsset<Texture> {
 	public:
@@ -31,24 +47,46 @@ namespace Rendering {
 		Texture() : PersistentAsset(AssetId::CreateNewAssetId(), AssetType::TextureInternal, "Internal\\Empty_Default"), imageProperties(ImageProperties()) {
 		}
 		bool isInternalTexture = false;
+		// 0 for atlased sprites, which live on their atlas page only
 		unsigned int textureId = 0;
 		ImageProperties imageProperties;
 		std::string pathToImageFile;
+		// subTextures are views into their textureSheet's texture and own no GL texture
+		const Texture* viewSource = nullptr;
+		// xy = uv of bottom left corner, zw = uv size
+		glm::vec4 uvRect{ 0, 0, 1, 1 };
+		// lowered by CreateSubTextures so mip levels do not mix neighbouring subTextures
+		int maxMipLevel = 1000;
+		// mip levels on the GPU including level 0
+		int levelCount = 0;
+		// layer of the textureSheet's array texture, if the sheet uses array storage
+		unsigned int arrayTextureId = 0;
+		int arrayLayer = -1;
+		// set in the texture's meta file
+		TextureCompression compression = TextureCompression::None;
 
 		const char* subTextureSuffix = "_subTexture_";
 
 
 		static bool LoadImageData(const std::string& relative_path, ImageProperties& out_imageProperties, unsigned char*& out_rawData, bool flipVertically = true);
-		static void BindToGPUAndFreeData(const unsigned int& texture_id, const ImageProperties& imageProperties, unsigned char*& imageData);
-		void SliceSubTextureFromData(unsigned char* rawImageData, const ImageProperties& imProps, const SubTextureData& subTextureData, const int
-		                             subTextureCount, Texture*& out_TexturePtr) const;
+		static bool LoadImageDataFromMemory(const unsigned char* encodedImage, size_t byteSize, const std::string& relative_path, ImageProperties& out_imageProperties,
+		                                    unsigned char*& out_rawData, bool flipVertically = true);
+		static bool ShouldUseAtlas(const std::filesystem::path& relativePathToImageFile, bool isInternal, TextureCompression compression);
+		// Uploads level 0 and the prebuilt mip levels, returns the number of levels uploaded including level 0
+		static int BindToGPUAndFreeData(const unsigned int& texture_id, DecodedImage& image);
+		// Replaces the rgba levels of the image with their encoded blocks
+		static void EncodeDecodedImage(DecodedImage& image);
+		Texture* GetOrCreateSubTextureView(const SubTextureData& subTextureData, int subTextureCount) const;
 
 		inline static Texture* empty = nullptr;
-		static bool Create(const std::filesystem::path& relativePathToImageFile, Texture*& out_texture, bool isInternal, ::AssetId assetId);
+		// Without a GL context textures are created with id 0 and only keep their image properties
+		inline static bool isHeadless = false;
+		static bool LoadImageProperties(const std::string& relative_path, ImageProperties& out_imageProperties);
+		static bool Create(const std::filesystem::path& relativePathToImageFile, Texture*& out_texture, bool isInternal, ::AssetId assetId,
+		                   TextureCompression compression = TextureCompression::None);
 		bool LoadAndBind(const std::string& relativePathToImageFile, ImageProperties& out_imgProps, unsigned out_textureId);
-		static Texture* CreateFromData(unsigned char* rawImageData, const ImageProperties& imgProps, const std::filesystem::path& relativePathToImageFile,
-									   const ::AssetId& assetId, bool isInternal, std::string nameSuffix = "");
-		void RefreshFromDataAndFree(unsigned char* rawImageData, const ImageProperties& imgProps);
+		static Texture* CreateFromData(DecodedImage& image, std::string nameSuffix = "");
+		void RefreshFromDataAndFree(DecodedImage& image);
 
 	public:
 		ImageProperties GetImageProperties() const;
@@ -56,12 +94,47 @@ namespace Rendering {
 
 		static bool CreateNew(const std::filesystem::path& relativePathToImageFile, bool isInternal, bool isPartOfTextureSheet, Texture*& out_texture, AssetHeader&
 							  out_assetHeader);
-		bool CreateSubTextures(const std::vector<SubTextureData>& subTextureData, std::vector<Texture*>& out_textures) const;
+		// SubTextures are views into this texture, so slicing does not read the image again.
+		// Already loaded subTextures are updated in place.
+		bool CreateSubTextures(const std::vector<SubTextureData>& subTextureData, std::vector<Texture*>& out_textures);
+		bool IsSubTextureView() const { return viewSource != nullptr; }
+		// Part of the GL texture this texture covers, rows bottom first
+		glm::vec4 GetUvRect() const;
+		// Tiles are rendered from the array texture layer instead of the uv rect if set, pass layer -1 to clear
+		void SetArrayLayer(const unsigned int textureId, const int layer) {
+			arrayTextureId = textureId;
+			arrayLayer = layer;
+		}
+		bool TryGetArrayLayer(unsigned int& out_textureId, int& out_layer) const {
+			out_textureId = arrayTextureId;
+			out_layer = arrayLayer;
+			return arrayLayer >= 0;
+		}
 		static bool CanCreateFromPath(const char* path);
+
+		// Decodes an image file and builds its mip levels, or reads both from the ImportCache. Safe to call from worker threads
+		static bool DecodeImage(const std::string& relativeImagePath, DecodedImage& out_image, TextureCompression compression = TextureCompression::None);
+		// Reads a texture asset file and decodes its image, safe to call from worker threads
+		static bool DecodeFromAssetFile(const std::filesystem::path& absoluteAssetPath, DecodedImage& out_image);
+		// Uploads the decoded image to the GPU and frees its data, main thread only
+		static bool CreateFromDecodedImage(DecodedImage& image, Texture*& out_texture);
+		// Replaces the pixels of this texture, the texture id stays the same. Frees the image data, main thread only
+		void RefreshFromDecodedImage(DecodedImage& image);
 		bool IsInternal() const {
 			return isInternalTexture;
 		}
 
+		TextureCompression GetCompression() const { return compression; }
+		// Takes effect on the next Refresh
+		void SetCompression(const TextureCompression newCompression) { compression = newCompression; }
+		// Video memory of the texture including its mip levels, 0 for subTextures as they share their sheet's texture
+		size_t GetGpuByteSize() const;
+		// What GetGpuByteSize would be as rgba8
+		size_t GetUncompressedGpuByteSize() const;
+
+
+		static void SetHeadless(const bool headless) { isHeadless = headless; }
+		static bool IsHeadless() { return isHeadless; }
 
 		static Texture* Empty() {
 			if (empty == nullptr) empty = new Texture();
@@ -69,7 +142,11 @@ namespace Rendering {
 		}
 
 		void Serialize(std::ostream& oStream) const override;
+		// Serialize without the import options, as embedded in textureSheet files
+		void SerializeImageReference(std::ostream& oStream) const;
 		static bool Deserialize(std::istream& iStream, const AssetHeader& header, Texture*& out_texture);
+		// Creates the texture, or refreshes it in place if it is loaded already
+		static bool Load(const std::string& relativeImagePath, bool isInternal, TextureCompression compression, const ::AssetId& assetId, Texture*& out_texture);
 
 		bool Refresh(const std::string& path = "");
 
@@ -0,0 +1,122 @@
+#include "TextureAtlas.h"
+
+#include <iostream>
+
+#include "glad.h"
+
+using namespace Rendering;
+
+void TextureAtlas::CreatePageTexture(Page& page) {
+	glCreateTextures(GL_TEXTURE_2D, 1, &page.TextureId);
+	glTextureStorage2D(page.TextureId, MipLevels, GL_RGBA8, PageSize, PageSize);
+	glTextureParameteri(page.TextureId, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(page.TextureId, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(page.TextureId, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTextureParameteri(page.TextureId, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTextureParameteri(page.TextureId, GL_TEXTURE_MAX_LEVEL, MipLevels - 1);
+
+	constexpr unsigned char clearColor[4] = { 0, 0, 0, 0 };
+	for (int level = 0; level < MipLevels; ++level) {
+		glClearTexImage(page.TextureId, level, GL_RGBA, GL_UNSIGNED_BYTE, clearColor);
+	}
+#ifdef _DEBUG
+	std::cout << "Created texture atlas page " << pages.size() << " textureID: " << page.TextureId << std::endl;
+#endif
+}
+
+size_t TextureAtlas::GetPageGpuByteSize() {
+	size_t bytes = 0;
+	for (int level = 0; level < MipLevels; ++level) bytes += static_cast<size_t>(PageSize >> level) * (PageSize >> level) * 4;
+	return bytes;
+}
+
+bool TextureAtlas::Submit(const AssetId& assetId, const unsigned char* rgbaPixels, const int width, const int height) {
+	if (!CanSubmit(width, height) || width <= 0 || height <= 0) return false;
+
+	AtlasRegion region;
+	const AtlasRegion* existing = regions.Find(assetId);
+	if (existing != nullptr && existing->PixelSize == glm::ivec2(width, height)) {
+		region = *existing;
+	}
+	else {
+		if (existing != nullptr) Remove(assetId);
+
+		glm::ivec2 position;
+		size_t page = 0;
+		while (page < pages.size() && !pages[page].Packer.TryPack(width, height, position)) ++page;
+		if (page == pages.size()) {
+			pages.emplace_back();
+			if (!pages.back().Packer.TryPack(width, height, position)) {
+				std::cout << "ERROR: Unable to pack " << assetId.ToString() << " into texture atlas" << std::endl;
+				pages.pop_back();
+				return false;
+			}
+		}
+		region.Page = page;
+		region.PixelPosition = position;
+		region.PixelSize = glm::ivec2(width, height);
+		region.UvRect = glm::vec4(glm::vec2(position) / static_cast<float>(PageSize), glm::vec2(width, height) / static_cast<float>(PageSize));
+		regions[assetId] = region;
+		++generation;
+	}
+
+	PendingUpload upload;
+	upload.Page = region.Page;
+	upload.Position = region.PixelPosition - glm::ivec2(Padding);
+	upload.Size = region.PixelSize + glm::ivec2(Padding * 2);
+	AtlasPacker::ExtrudeImage(rgbaPixels, width, height, Padding, upload.Pixels);
+	pendingUploads.emplace_back(std::move(upload));
+	return true;
+}
+
+void TextureAtlas::Remove(const AssetId& assetId) {
+	const AtlasRegion* region = regions.Find(assetId);
+	if (region == nullptr) return;
+	pages[region->Page].Packer.Release(region->PixelPosition, region->PixelSize.x, region->PixelSize.y);
+	regions.Erase(assetId);
+	++generation;
+}
+
+bool TextureAtlas::Contains(const AssetId& assetId) {
+	return regions.Contains(assetId);
+}
+
+bool TextureAtlas::TryGetRegion(const AssetId& assetId, AtlasRegion& out_region) {
+	const AtlasRegion* region = regions.Find(assetId);
+	if (region == nullptr) return false;
+	out_region = *region;
+	return true;
+}
+
+void TextureAtlas::Build() {
+	if (pendingUploads.empty()) return;
+
+	for (auto& page : pages) {
+		if (page.TextureId == 0) CreatePageTexture(page);
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (const auto& upload : pendingUploads) {
+		Page& page = pages[upload.Page];
+		glTextureSubImage2D(page.TextureId, 0, upload.Position.x, upload.Position.y, upload.Size.x, upload.Size.y, GL_RGBA, GL_UNSIGNED_BYTE, upload.Pixels.data());
+		page.NeedsMipmaps = true;
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	pendingUploads.clear();
+
+	for (auto& page : pages) {
+		if (!page.NeedsMipmaps) continue;
+		glGenerateTextureMipmap(page.TextureId);
+		page.NeedsMipmaps = false;
+	}
+}
+
+void TextureAtlas::Free() {
+	for (const auto& page : pages) {
+		if (page.TextureId != 0) glDeleteTextures(1, &page.TextureId);
+	}
+	pages.clear();
+	regions.Clear();
+	pendingUploads.clear();
+	++generation;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <glm/vec4.hpp>
+
+#include "AssetId.h"
+#include "AssetTable.h"
+#include "AtlasPacker.h"
+
+namespace Rendering {
+	struct AtlasRegion {
+		size_t Page = 0;
+		// xy = uv of bottom left corner, zw = uv size
+		glm::vec4 UvRect{ 0, 0, 1, 1 };
+		glm::ivec2 PixelPosition{ 0, 0 };
+		glm::ivec2 PixelSize{ 0, 0 };
+	};
+
+	// Packs small sprites into shared pages so tiles using different textures can be drawn together.
+	// Submitting only packs on the CPU, pixels are uploaded on the next Build() so it can be used before a GL context exists.
+	class TextureAtlas {
+		struct Page {
+			AtlasPacker Packer;
+			unsigned int TextureId = 0;
+			bool NeedsMipmaps = false;
+
+			Page() : Packer(PageSize, PageSize, Padding) {}
+		};
+
+		struct PendingUpload {
+			size_t Page;
+			glm::ivec2 Position; // including padding
+			glm::ivec2 Size; // including padding
+			std::vector<unsigned char> Pixels;
+		};
+
+		inline static std::vector<Page> pages;
+		inline static AssetTable<AtlasRegion> regions;
+		inline static std::vector<PendingUpload> pendingUploads;
+		inline static unsigned int generation = 0;
+
+		static void CreatePageTexture(Page& page);
+	public:
+		static constexpr int PageSize = 2048;
+		static constexpr int Padding = 2;
+		// mip levels beyond this would mix neighbouring regions despite the padding
+		static constexpr int MipLevels = 2;
+		static constexpr int MaxImageSize = 256;
+
+		static bool CanSubmit(int width, int height) { return width <= MaxImageSize && height <= MaxImageSize; }
+
+		// Pixels are tightly packed rgba, rows in GL order (bottom row first). Re-submitting an id of the same size overwrites its region.
+		static bool Submit(const AssetId& assetId, const unsigned char* rgbaPixels, int width, int height);
+		// The region's space goes back to its page and is reused by later submissions
+		static void Remove(const AssetId& assetId);
+		static bool Contains(const AssetId& assetId);
+		static bool TryGetRegion(const AssetId& assetId, AtlasRegion& out_region);
+
+		// Uploads pending pixels, called once per frame before rendering
+		static void Build();
+
+		static unsigned int GetPageTextureId(size_t page) { return pages[page].TextureId; }
+		static size_t GetPageCount() { return pages.size(); }
+		static float GetPageOccupancy(size_t page) { return pages[page].Packer.GetOccupancy(); }
+		// Video memory of one page including its mip levels, pages are only allocated on the GPU once built
+		static size_t GetPageGpuByteSize();
+		static size_t GetRegionCount() { return regions.Size(); }
+		// Increases whenever regions change, renderers caching uvs compare against it
+		static unsigned int GetGeneration() { return generation; }
+
+		static void Free();
+	};
+}
@@ -0,0 +1,202 @@
+#include "TextureEncoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "glad.h"
+#include "JobSystem.h"
+#include "MipChain.h"
+
+using namespace Rendering;
+
+namespace {
+	constexpr int bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// block rows per job
+	constexpr size_t blockRowsPerJob = 4;
+
+	// Writes least significant bits first, as BC7 blocks are laid out
+	struct BitWriter {
+		unsigned char* Bytes;
+		int Position = 0;
+
+		void Write(const uint32_t value, const int bitCount) {
+			for (int i = 0; i < bitCount; ++i, ++Position) {
+				if (value >> i & 1u) Bytes[Position >> 3] |= static_cast<unsigned char>(1u << (Position & 7));
+			}
+		}
+	};
+}
+
+const char* TextureEncoder::GetName(const TextureCompression compression) {
+	switch (compression) {
+		case TextureCompression::None: return "RGBA8";
+		case TextureCompression::BC7: return "BC7";
+		default: return "Unknown";
+	}
+}
+
+unsigned int TextureEncoder::GetGLFormat(const TextureCompression compression) {
+	switch (compression) {
+		case TextureCompression::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		default: return 0;
+	}
+}
+
+size_t TextureEncoder::GetEncodedSize(const TextureCompression compression, const int width, const int height) {
+	const size_t blockCount = static_cast<size_t>((width + BlockSize - 1) / BlockSize) * ((height + BlockSize - 1) / BlockSize);
+	switch (compression) {
+		case TextureCompression::BC7: return blockCount * BC7BlockByteSize;
+		default: return static_cast<size_t>(width) * height * 4;
+	}
+}
+
+size_t TextureEncoder::GetMipChainSize(const TextureCompression compression, const int width, const int height) {
+	size_t byteSize = 0;
+	for (int level = 0; level < MipChain::GetLevelCount(width, height); ++level) {
+		byteSize += GetEncodedSize(compression, MipChain::GetLevelSize(width, level), MipChain::GetLevelSize(height, level));
+	}
+	return byteSize;
+}
+
+void TextureEncoder::Encode(const TextureCompression compression, const unsigned char* rgbaPixels, const int width, const int height,
+                            std::vector<unsigned char>& out_encoded) {
+	const size_t offset = out_encoded.size();
+	out_encoded.resize(offset + GetEncodedSize(compression, width, height));
+	if (compression == TextureCompression::None) {
+		std::memcpy(out_encoded.data() + offset, rgbaPixels, out_encoded.size() - offset);
+		return;
+	}
+
+	const int blocksPerRow = (width + BlockSize - 1) / BlockSize;
+	const int blockRows = (height + BlockSize - 1) / BlockSize;
+	unsigned char* blocks = out_encoded.data() + offset;
+	JobSystem::ParallelFor(blockRows, blockRowsPerJob, [=](const size_t begin, const size_t end) {
+		unsigned char pixels[16][4];
+		for (size_t blockY = begin; blockY < end; ++blockY) {
+			for (int blockX = 0; blockX < blocksPerRow; ++blockX) {
+				// blocks at the edges repeat the last row and column
+				for (int i = 0; i < 16; ++i) {
+					const int x = std::min(blockX * BlockSize + i % BlockSize, width - 1);
+					const int y = std::min(static_cast<int>(blockY) * BlockSize + i / BlockSize, height - 1);
+					std::memcpy(pixels[i], rgbaPixels + (static_cast<size_t>(y) * width + x) * 4, 4);
+				}
+				EncodeBC7Block(pixels, blocks + (blockY * blocksPerRow + blockX) * BC7BlockByteSize);
+			}
+		}
+	});
+}
+
+void TextureEncoder::EncodeBC7Block(const unsigned char (&pixels)[16][4], unsigned char* out_block) {
+	// endpoints at the extremes of the pixels along their principal axis
+	float mean[4] = {};
+	for (const auto& pixel : pixels) {
+		for (int c = 0; c < 4; ++c) mean[c] += pixel[c] / 16.0f;
+	}
+	float covariance[4][4] = {};
+	for (const auto& pixel : pixels) {
+		for (int a = 0; a < 4; ++a) {
+			for (int b = 0; b < 4; ++b) covariance[a][b] += (pixel[a] - mean[a]) * (pixel[b] - mean[b]);
+		}
+	}
+	// power iteration, starting from the channel that varies most
+	int widestChannel = 0;
+	for (int c = 1; c < 4; ++c) {
+		if (covariance[c][c] > covariance[widestChannel][widestChannel]) widestChannel = c;
+	}
+	float axis[4] = {};
+	axis[widestChannel] = 1;
+	for (int iteration = 0; iteration < 8; ++iteration) {
+		float next[4] = {};
+		for (int a = 0; a < 4; ++a) {
+			for (int b = 0; b < 4; ++b) next[a] += covariance[a][b] * axis[b];
+		}
+		const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+		// single colored block
+		if (length < 1e-6f) break;
+		for (int c = 0; c < 4; ++c) axis[c] = next[c] / length;
+	}
+	float minProjection = 0, maxProjection = 0;
+	for (const auto& pixel : pixels) {
+		float projection = 0;
+		for (int c = 0; c < 4; ++c) projection += (pixel[c] - mean[c]) * axis[c];
+		minProjection = std::min(minProjection, projection);
+		maxProjection = std::max(maxProjection, projection);
+	}
+
+	// endpoints have 7 bits per channel and a shared lowest bit per endpoint, every p-bit combination is tried.
+	// opaque and fully transparent blocks keep their exact alpha, which needs both lowest bits set or cleared
+	int minAlpha = 255, maxAlpha = 0;
+	for (const auto& pixel : pixels) {
+		minAlpha = std::min<int>(minAlpha, pixel[3]);
+		maxAlpha = std::max<int>(maxAlpha, pixel[3]);
+	}
+	const int firstPBits = minAlpha == 255 ? 3 : 0;
+	const int lastPBits = maxAlpha == 0 ? 0 : 3;
+	int bestError = INT32_MAX;
+	int bestQuantized[2][4] = {};
+	int bestPBits[2] = {};
+	int bestIndices[16] = {};
+	for (int pBits = firstPBits; pBits <= lastPBits; ++pBits) {
+		const int p[2] = { pBits & 1, pBits >> 1 };
+		int quantized[2][4];
+		int endpoints[2][4];
+		for (int c = 0; c < 4; ++c) {
+			const float values[2] = { mean[c] + axis[c] * minProjection, mean[c] + axis[c] * maxProjection };
+			for (int e = 0; e < 2; ++e) {
+				quantized[e][c] = std::clamp(static_cast<int>(std::lround((values[e] - p[e]) / 2.0f)), 0, 127);
+				endpoints[e][c] = quantized[e][c] << 1 | p[e];
+			}
+		}
+		int palette[16][4];
+		for (int i = 0; i < 16; ++i) {
+			for (int c = 0; c < 4; ++c) palette[i][c] = ((64 - bc7Weights4[i]) * endpoints[0][c] + bc7Weights4[i] * endpoints[1][c] + 32) >> 6;
+		}
+
+		int error = 0;
+		int indices[16];
+		for (int pixel = 0; pixel < 16; ++pixel) {
+			int bestPixelError = INT32_MAX;
+			for (int i = 0; i < 16; ++i) {
+				int pixelError = 0;
+				for (int c = 0; c < 4; ++c) {
+					const int difference = pixels[pixel][c] - palette[i][c];
+					pixelError += difference * difference;
+				}
+				if (pixelError < bestPixelError) {
+					bestPixelError = pixelError;
+					indices[pixel] = i;
+				}
+			}
+			error += bestPixelError;
+		}
+		if (error < bestError) {
+			bestError = error;
+			std::memcpy(bestQuantized, quantized, sizeof(quantized));
+			bestPBits[0] = p[0];
+			bestPBits[1] = p[1];
+			std::memcpy(bestIndices, indices, sizeof(indices));
+		}
+	}
+
+	// the first index is stored without its highest bit, which has to be 0. Swapping the endpoints inverts the indices
+	if (bestIndices[0] >= 8) {
+		for (int c = 0; c < 4; ++c) std::swap(bestQuantized[0][c], bestQuantized[1][c]);
+		std::swap(bestPBits[0], bestPBits[1]);
+		for (int& index : bestIndices) index = 15 - index;
+	}
+
+	std::memset(out_block, 0, BC7BlockByteSize);
+	BitWriter writer{ out_block };
+	// mode 6 is 6 zero bits followed by a one
+	writer.Write(1u << 6, 7);
+	for (int c = 0; c < 4; ++c) {
+		writer.Write(bestQuantized[0][c], 7);
+		writer.Write(bestQuantized[1][c], 7);
+	}
+	writer.Write(bestPBits[0], 1);
+	writer.Write(bestPBits[1], 1);
+	writer.Write(bestIndices[0], 3);
+	for (int i = 1; i < 16; ++i) writer.Write(bestIndices[i], 4);
+}
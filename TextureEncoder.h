@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Rendering {
+	// GPU format textures are imported to, set per texture in its meta file
+	enum class TextureCompression : uint8_t {
+		None = 0,
+		// 4x4 blocks of 16 bytes, a quarter of rgba8. Core since OpenGL 4.2
+		BC7 = 1
+	};
+
+	// CPU block compression of rgba images, done once on import since the ImportCache keeps the result
+	class TextureEncoder {
+	public:
+		static constexpr int BlockSize = 4;
+		static constexpr size_t BC7BlockByteSize = 16;
+
+		static const char* GetName(TextureCompression compression);
+		// Internal format for glCompressedTexImage2D, 0 for TextureCompression::None
+		static unsigned int GetGLFormat(TextureCompression compression);
+		// Bytes of one encoded level, partial blocks at the edges are padded to full blocks
+		static size_t GetEncodedSize(TextureCompression compression, int width, int height);
+		// Bytes of all mip levels down to 1x1 including level 0
+		static size_t GetMipChainSize(TextureCompression compression, int width, int height);
+
+		// Appends the encoded level to out_encoded. Rows of blocks are split across JobSystem workers
+		static void Encode(TextureCompression compression, const unsigned char* rgbaPixels, int width, int height, std::vector<unsigned char>& out_encoded);
+		// BC7 mode 6 only: one rgba endpoint pair per block with 16 interpolated colors, favours encoding speed over quality
+		static void EncodeBC7Block(const unsigned char (&pixels)[16][4], unsigned char* out_block);
+	};
+}
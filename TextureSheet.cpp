@@ -1,14 +1,46 @@
 #include "TextureSheet.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "Resources.h"
 #include "Serialization.h"
 #include "Texture.h"
 #include "ImGuiHelper.h"
+#include "glad.h"
 
 using namespace Rendering;
 
+namespace {
+	// Everything after the textureSheet's own header
+	struct TextureSheetFile {
+		AssetHeader TextureHeader;
+		bool IsInternal = false;
+		std::string ImageFilePath;
+		std::vector<Rendering::SubTextureData> SubTextureData;
+		TextureSheetStorage Storage = TextureSheetStorage::Views;
+		TextureCompression Compression = TextureCompression::None;
+	};
+
+	bool ReadTextureSheetFile(std::istream& iStream, TextureSheetFile& out_file) {
+		using namespace Serialization;
+		//embedded here is the metadata of its mainTexture
+		if (!AssetHeader::Read(iStream, &out_file.TextureHeader)) return false;
+		readFromStream(iStream, out_file.IsInternal);
+		out_file.ImageFilePath = DeserializeStdString(iStream);
+		size_t subTextureCount = 0;
+		readFromStream(iStream, subTextureCount);
+		out_file.SubTextureData.reserve(subTextureCount);
+		for (size_t i = 0; i < subTextureCount; ++i) {
+			out_file.SubTextureData.emplace_back(DeserializeSubTextureData(iStream));
+		}
+		// sheets saved before array storage or compression end early
+		if (iStream.peek() != EOF) readFromStream(iStream, out_file.Storage);
+		if (iStream.peek() != EOF) readFromStream(iStream, out_file.Compression);
+		return !iStream.fail();
+	}
+}
+
 bool TextureSheet::CreateNew(const std::filesystem::path& relativePathToImageFile, TextureSheet*& out_TextureSheet, AssetHeader& out_header) {
 	Texture* mainTex;
 	if (!Texture::CreateNew(relativePathToImageFile, false, true, mainTex, out_header)) {
@@ -26,36 +58,30 @@ bool TextureSheet::CreateNew(const std::filesystem::path& relativePathToImageFil
 }
 
 bool TextureSheet::Deserialize(std::istream& iStream, const AssetHeader& header, TextureSheet*& out_textureSheet) {
-	using namespace Serialization;
-	//embedded here is the metadata of its mainTexture
-	AssetHeader textureHeader;
-	if (!AssetHeader::Read(iStream, &textureHeader)) {
-		std::cout << "Unable to read header of mainTexture asset of textureSheet " << header.relativeAssetPath << std::endl;
+	TextureSheetFile file;
+	if (!ReadTextureSheetFile(iStream, file)) {
+		std::cout << "Unable to read mainTexture asset of textureSheet " << header.relativeAssetPath << std::endl;
 		return false;
 	}
 	Texture* mainTexture;
-	if (!Texture::Deserialize(iStream, textureHeader, mainTexture)) {
+	if (!Texture::Load(file.ImageFilePath, file.IsInternal, file.Compression, file.TextureHeader.aId, mainTexture)) {
 		std::cout << "Unable to deserialize mainTexture asset - unable to load textureSheet " << header.relativeAssetPath << std::endl;
 		return false;
 	}
 	const auto imgFilePath = mainTexture->GetImageFilePath();
 	out_textureSheet = new TextureSheet(mainTexture, imgFilePath, header.aId);
-	size_t subTextureCount = 0;
-	readFromStream(iStream, subTextureCount);
-	if (subTextureCount == 0) {
+	out_textureSheet->storage = file.Storage;
+	if (file.SubTextureData.empty()) {
 		return true;
 	}
-	out_textureSheet->SubTextureData.reserve(subTextureCount);
-
-	for (size_t i = 0; i < subTextureCount; ++i) {
-		out_textureSheet->SubTextureData.emplace_back(DeserializeSubTextureData(iStream));
-	}
+	out_textureSheet->SubTextureData = std::move(file.SubTextureData);
 
 	if (!mainTexture->CreateSubTextures(out_textureSheet->SubTextureData, out_textureSheet->SubTextures)) {
 		delete out_textureSheet;
 		std::cout << "ERROR: Unable to create texture sheet: failed to create subTextures " << header.relativeAssetPath.string() << std::endl;
 		return false;
 	}
+	out_textureSheet->UpdateArrayTexture();
 
 	return true;
 }
@@ -64,12 +90,60 @@ void TextureSheet::Serialize(std::ostream& oStream) const {
 	using namespace Serialization;
 	//Write embedded mainTex metadata first
 	AssetHeader::Write(oStream, mainTexture);
-	mainTexture->Serialize(oStream);
+	mainTexture->SerializeImageReference(oStream);
 	writeToStream(oStream, SubTextureData.size());
 
 	for (auto data : SubTextureData) {
 		Serialization::Serialize(oStream, data);
 	}
+	writeToStream(oStream, storage);
+	writeToStream(oStream, mainTexture->GetCompression());
+}
+
+bool TextureSheet::DecodeFromAssetFile(const std::filesystem::path& absoluteAssetPath, DecodedImage& out_image) {
+	std::ifstream file(absoluteAssetPath, std::iostream::binary);
+	if (!file) return false;
+
+	AssetHeader header;
+	if (!AssetHeader::Read(file, &header) || header.aType != AssetType::TextureSheet) return false;
+	TextureSheetFile sheetFile;
+	if (!ReadTextureSheetFile(file, sheetFile)) return false;
+	file.close();
+
+	out_image.AssetId = sheetFile.TextureHeader.aId;
+	out_image.IsInternal = sheetFile.IsInternal;
+	return Texture::DecodeImage(sheetFile.ImageFilePath, out_image, sheetFile.Compression);
+}
+
+bool TextureSheet::Reload(const std::filesystem::path& absoluteAssetPath, DecodedImage& image) {
+	using namespace Serialization;
+	std::ifstream file(absoluteAssetPath, std::iostream::binary);
+	AssetHeader header;
+	TextureSheetFile sheetFile;
+	if (!file || !AssetHeader::Read(file, &header) || !ReadTextureSheetFile(file, sheetFile)) {
+		std::cout << "Unable to read textureSheet for reloading: " << absoluteAssetPath.string() << std::endl;
+		free(image.Data);
+		image.Data = nullptr;
+		return false;
+	}
+	file.close();
+
+	// slices that are still there keep their texture, so tiles using them stay valid
+	for (Texture* subTexture : SubTextures) {
+		const bool kept = std::any_of(sheetFile.SubTextureData.begin(), sheetFile.SubTextureData.end(), [subTexture](const Rendering::SubTextureData& data) {
+			return data.assetId == subTexture->AssetId;
+		});
+		if (!kept) Resources::ReleaseOwnership(subTexture, true);
+	}
+	SubTextures.clear();
+	SubTextureData = std::move(sheetFile.SubTextureData);
+	storage = sheetFile.Storage;
+
+	mainTexture->RefreshFromDecodedImage(image);
+	const bool sliced = mainTexture->CreateSubTextures(SubTextureData, SubTextures);
+	if (!sliced) std::cout << "ERROR: Unable to slice reloaded textureSheet " << absoluteAssetPath.string() << std::endl;
+	UpdateArrayTexture();
+	return sliced;
 }
 
 void TextureSheet::AutoSlice() {
@@ -113,9 +187,85 @@ void TextureSheet::AutoSlice() {
 	}
 
 	mainTexture->CreateSubTextures(SubTextureData, SubTextures);
+	UpdateArrayTexture();
 	//SaveToFile();
 }
 
+void TextureSheet::SetStorage(const TextureSheetStorage newStorage) {
+	if (storage == newStorage) return;
+	storage = newStorage;
+	UpdateArrayTexture();
+}
+
+void TextureSheet::SetCompression(const TextureCompression compression) {
+	mainTexture->SetCompression(compression);
+	mainTexture->Refresh();
+	SubTextures.clear();
+	mainTexture->CreateSubTextures(SubTextureData, SubTextures);
+	UpdateArrayTexture();
+}
+
+void TextureSheet::UpdateArrayTexture() {
+	if (arrayTextureId != 0) {
+		glDeleteTextures(1, &arrayTextureId);
+		arrayTextureId = 0;
+	}
+	for (Texture* subTexture : SubTextures) subTexture->SetArrayLayer(0, -1);
+	++arrayGeneration;
+	if (storage != TextureSheetStorage::ArrayLayers || SubTextures.empty() || Texture::IsHeadless()) return;
+
+	if (mainTexture->GetCompression() != TextureCompression::None) {
+		// the layers are rgba8 and filled by copying from the sheet's texture
+		std::cout << "TextureSheet " << GetRelativeAssetPath().string() << " is compressed, using views instead of array layers." << std::endl;
+		return;
+	}
+
+	const int width = SubTextureData[0].width;
+	const int height = SubTextureData[0].height;
+	const bool isUniform = std::all_of(SubTextureData.begin(), SubTextureData.end(), [width, height](const Rendering::SubTextureData& data) {
+		return data.width == width && data.height == height;
+	});
+	if (!isUniform) {
+		std::cout << "TextureSheet " << GetRelativeAssetPath().string() << " has subTextures of different sizes, using views instead of array layers." << std::endl;
+		return;
+	}
+
+	const auto layerCount = static_cast<int>(SubTextures.size());
+	GLint maxLayers = 0;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+	if (layerCount > maxLayers) {
+		std::cout << "TextureSheet " << GetRelativeAssetPath().string() << " has " << layerCount << " subTextures but only " << maxLayers
+			<< " array layers are supported, using views instead of array layers." << std::endl;
+		return;
+	}
+
+	int mipLevels = 1;
+	while (std::max(width, height) >> mipLevels > 0) ++mipLevels;
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &arrayTextureId);
+	glTextureStorage3D(arrayTextureId, mipLevels, GL_RGBA8, width, height, layerCount);
+	glTextureParameteri(arrayTextureId, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(arrayTextureId, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(arrayTextureId, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTextureParameteri(arrayTextureId, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	// copied on the GPU from the sheet's texture, which is stored bottom row first while yOffset is from the top
+	const int sheetHeight = mainTexture->GetImageProperties().height;
+	for (int layer = 0; layer < layerCount; ++layer) {
+		const auto& data = SubTextureData[layer];
+		glCopyImageSubData(mainTexture->GetTextureID(), GL_TEXTURE_2D, 0, data.xOffset, sheetHeight - data.yOffset - height, 0,
+		                   arrayTextureId, GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1);
+		SubTextures[layer]->SetArrayLayer(arrayTextureId, layer);
+	}
+	// mips are per layer, so slices never mix
+	glGenerateTextureMipmap(arrayTextureId);
+}
+
+size_t TextureSheet::GetArrayTextureByteSize() const {
+	if (arrayTextureId == 0) return 0;
+	// every layer has the size of the first subTexture
+	return TextureEncoder::GetMipChainSize(TextureCompression::None, SubTextureData[0].width, SubTextureData[0].height) * SubTextures.size();
+}
+
 bool DrawSubSpriteButton(Texture*& texture, int buttonSize, bool shouldHighlight = false) {
 	using namespace ImGui;
 	//	ImVec2 startPos = GetCursorStartPos();
@@ -127,7 +277,7 @@ bool DrawSubSpriteButton(Texture*& texture, int buttonSize, bool shouldHighlight
 	//ImVec2 IconDrawPos(startPos.x, startPos.y);
 	//SetCursorPos(IconDrawPos);
 	if (shouldHighlight) PushStyleColor(ImGuiCol_Button, (ImVec4)ImColor(255, 255, 255));
-	const bool clicked = ImGuiHelper::ImageButton(texture->GetTextureID(), ImVec2(buttonSize, buttonSize), 0);
+	const bool clicked = ImGuiHelper::ImageButton(texture, ImVec2(buttonSize, buttonSize), 0);
 	if (shouldHighlight) PopStyleColor();
 
 	PopID();
@@ -167,6 +317,26 @@ bool TextureSheet::RenderEditWindow(FileEditWindow* editWindow, bool isNewFile)
 		delete t;
 		return true;
 	}
+	int storageIndex = static_cast<int>(storage);
+	const char* storageNames[] = { "Views", "Array Layers" };
+	if (Combo("Storage", &storageIndex, storageNames, 2)) {
+		SetStorage(static_cast<TextureSheetStorage>(storageIndex));
+	}
+	if (IsItemHovered()) {
+		BeginTooltip();
+		TextUnformatted("Array Layers: tiles do not bleed into neighbouring sprites, all sprites need the same size.");
+		EndTooltip();
+	}
+	int compressionIndex = static_cast<int>(mainTexture->GetCompression());
+	const char* compressionNames[] = { TextureEncoder::GetName(TextureCompression::None), TextureEncoder::GetName(TextureCompression::BC7) };
+	if (Combo("Compression", &compressionIndex, compressionNames, 2)) {
+		SetCompression(static_cast<TextureCompression>(compressionIndex));
+	}
+	if (IsItemHovered()) {
+		BeginTooltip();
+		TextUnformatted("BC7: a quarter of the video memory, encoded once on import. Not available with Array Layers.");
+		EndTooltip();
+	}
 	if (TreeNode("AutoSlice")) {
 		InputInt("Sprite Width", &sliceWidth);
 		InputInt("Sprite Height", &sliceHeight);
@@ -218,6 +388,7 @@ bool TextureSheet::RenderEditWindow(FileEditWindow* editWindow, bool isNewFile)
 			mainTexture->CreateSubTextures(stData, stTex);
 			SubTextureData.emplace_back(*tempDataUPtr.release());
 			SubTextures.emplace_back(stTex[0]);
+			UpdateArrayTexture();
 			tempDataUPtr = nullptr;
 			renderTempData = false;
 			CloseCurrentPopup();
@@ -268,6 +439,7 @@ bool TextureSheet::RenderEditWindow(FileEditWindow* editWindow, bool isNewFile)
 				std::vector<Rendering::Texture*> stTex;
 				mainTexture->CreateSubTextures(stData, stTex);
 				SubTextureData[i] = stData[0];
+				UpdateArrayTexture();
 				CloseCurrentPopup();
 			}
 			EndPopup();
@@ -285,6 +457,7 @@ bool TextureSheet::RenderEditWindow(FileEditWindow* editWindow, bool isNewFile)
 		Resources::ReleaseOwnership(*texIt, true);
 		SubTextures.erase(texIt);
 		SubTextureData.erase(SubTextureData.begin() + removeAtPos);
+		UpdateArrayTexture();
 	}
 
 	return false;
@@ -301,5 +474,7 @@ bool TextureSheet::RenderEditWindow(FileEditWindow* editWindow, bool isNewFile)
 	//}
 }
 
-TextureSheet::~TextureSheet() = default;
+TextureSheet::~TextureSheet() {
+	if (arrayTextureId != 0) glDeleteTextures(1, &arrayTextureId);
+}
 
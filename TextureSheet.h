@@ -6,13 +6,21 @@
 namespace Rendering {
 	struct SubTextureData;
 
+	enum class TextureSheetStorage : uint8_t {
+		// subTextures are views into the sheet's texture
+		Views = 0,
+		// every subTexture is one layer of an array texture, tiles are drawn from it without bleeding into neighbouring slices.
+		// requires all subTextures to have the same size
+		ArrayLayers = 1
+	};
+
 	//Represents a Texture that holds multiple individual sprites
 	class TextureSheet : public PersistentAsset<TextureSheet>, public IEditable {
 	public:
 		TextureSheet(const TextureSheet& other) = delete;
 		TextureSheet& operator=(const TextureSheet& other) = delete;
 
-		TextureSheet(TextureSheet&& other) noexcept = default;
+		TextureSheet(TextureSheet&& other) noexcept = delete;
 		TextureSheet& operator=(TextureSheet&& other) noexcept {
 			if(this == &other) return *this;
 			mainTexture = other.mainTexture;
@@ -20,6 +28,9 @@ namespace Rendering {
 			sliceWidth = other.sliceWidth;
 			SubTextures = std::move(other.SubTextures);
 			SubTextureData = std::move(other.SubTextureData);
+			storage = other.storage;
+			// other deletes the previous array texture
+			std::swap(arrayTextureId, other.arrayTextureId);
 
 			return *this;
 		}
@@ -28,6 +39,9 @@ namespace Rendering {
 		int sliceHeight = 16; // in Pixels
 		int zoomLevel = 2;
 		Texture* mainTexture;
+		TextureSheetStorage storage = TextureSheetStorage::Views;
+		unsigned int arrayTextureId = 0;
+		inline static unsigned int arrayGeneration = 0;
 		TextureSheet(Texture* mainTexture, const std::filesystem::path& relativePathToAsset, const ::AssetId& assetId) :
 			PersistentAsset<TextureSheet>(assetId, AssetType::TextureSheet, relativePathToAsset), mainTexture(mainTexture) {}
 
@@ -38,10 +52,27 @@ namespace Rendering {
 		static bool CreateNew(const std::filesystem::path& relativePathToImageFile, TextureSheet*& out_TextureSheet, AssetHeader& out_header);
 		static bool Deserialize(std::istream& iStream, const AssetHeader& header, TextureSheet*& out_textureSheet);
 		void Serialize(std::ostream& oStream) const override;
+		// Reads a textureSheet asset file and decodes its image, safe to call from worker threads
+		static bool DecodeFromAssetFile(const std::filesystem::path& absoluteAssetPath, DecodedImage& out_image);
+		// Reads the slices from the asset file and refreshes the textures in place from the decoded image, which is freed.
+		// SubTextures that are no longer part of the file are deleted.
+		bool Reload(const std::filesystem::path& absoluteAssetPath, DecodedImage& image);
 
 		Texture* GetMainTexture() const { return mainTexture; }
 		void AutoSlice();
 
+		TextureSheetStorage GetStorage() const { return storage; }
+		void SetStorage(TextureSheetStorage newStorage);
+		// Reloads the sheet's texture in the new format and slices it again, as the mip levels a slice keeps depend on it
+		void SetCompression(TextureCompression compression);
+		// Copies the slices into the array texture layers on the GPU, call after the subTextures changed.
+		// Falls back to views if the subTextures differ in size, exceed the array layer limit or the sheet is compressed.
+		void UpdateArrayTexture();
+		// Video memory of the array texture including its mip levels, 0 if the sheet uses views
+		size_t GetArrayTextureByteSize() const;
+		// Increases whenever array textures are recreated, renderers caching layers compare against it
+		static unsigned int GetArrayGeneration() { return arrayGeneration; }
+
 		~TextureSheet() override;
 		bool RenderEditWindow(FileEditWindow* editWindow, bool isNewFile) override;
 		std::filesystem::path IEditableGetAssetPath() override { return GetRelativeAssetPath(); }
@@ -0,0 +1,350 @@
+#include "ThumbnailCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "BinaryFormat.h"
+#include "Files.h"
+#include "glad.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "stb_image.h"
+#include "Texture.h"
+
+using namespace Rendering;
+
+namespace {
+	constexpr size_t thumbnailByteSize = static_cast<size_t>(ThumbnailCache::ThumbnailSize) * ThumbnailCache::ThumbnailSize * 4;
+	constexpr uint64_t packHeaderSize = 8;
+	constexpr uint64_t packRecordSize = sizeof(uint64_t) + thumbnailByteSize;
+	// end of the last complete record, new thumbnails are appended here
+	uint64_t packEnd = packHeaderSize;
+}
+
+bool ThumbnailCache::Initialize(const std::filesystem::path& packFilePath, const size_t maxThumbnailCount) {
+	std::lock_guard lock(packMutex);
+	packIndex.clear();
+	packEnd = packHeaderSize;
+	packPath = packFilePath;
+	// compacting keeps half, which has to leave room for the next thumbnail
+	maxPackThumbnails = std::max<size_t>(maxThumbnailCount, 2);
+	packUseCounter = 0;
+	if (packFile.is_open()) packFile.close();
+
+	const auto createPack = [&packFilePath] {
+		packFile.close();
+		packFile.clear();
+		packFile.open(packFilePath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+		Serialization::WriteLittleEndian(packFile, packMagic);
+		Serialization::WriteLittleEndian(packFile, packVersion);
+		Serialization::WriteLittleEndian(packFile, static_cast<uint16_t>(ThumbnailSize));
+		packFile.flush();
+		return packFile.good();
+	};
+
+	packFile.open(packFilePath, std::ios::in | std::ios::out | std::ios::binary);
+	if (!packFile.is_open()) {
+		if (createPack()) return true;
+		std::cout << "Unable to create thumbnail cache " << packFilePath.string() << std::endl;
+		packFile.close();
+		return false;
+	}
+
+	packFile.seekg(0, std::ios::end);
+	const auto fileSize = static_cast<uint64_t>(packFile.tellg());
+	char header[packHeaderSize] = {};
+	packFile.seekg(0);
+	packFile.read(header, packHeaderSize);
+	Serialization::BinaryReader headerReader(header, packFile ? packHeaderSize : 0);
+	uint32_t magic = 0;
+	uint16_t version = 0, thumbnailSize = 0;
+	headerReader.Read(magic);
+	headerReader.Read(version);
+	headerReader.Read(thumbnailSize);
+	if (magic != packMagic || version != packVersion || thumbnailSize != ThumbnailSize) {
+		// outdated caches are simply rebuilt
+		return createPack();
+	}
+
+	// an incomplete record at the end is overwritten by the next thumbnail
+	for (uint64_t offset = packHeaderSize; offset + packRecordSize <= fileSize; offset += packRecordSize) {
+		char hashBytes[sizeof(uint64_t)];
+		packFile.seekg(static_cast<std::streamoff>(offset));
+		if (!packFile.read(hashBytes, sizeof(hashBytes))) break;
+		uint64_t contentHash = 0;
+		Serialization::BinaryReader(hashBytes, sizeof(hashBytes)).Read(contentHash);
+		// later records count as more recently used
+		packIndex[contentHash] = { offset + sizeof(uint64_t), ++packUseCounter };
+		packEnd = offset + packRecordSize;
+	}
+	packFile.clear();
+	return true;
+}
+
+void ThumbnailCache::Request(const std::string& relativeImagePath, Entry& entry) {
+	entry.Pending = true;
+	JobSystem::Schedule([relativeImagePath] { Generate(relativeImagePath); });
+}
+
+void ThumbnailCache::Generate(const std::string& relativeImagePath) {
+	PROFILE_SCOPE("ThumbnailCache::Generate");
+	FinishedThumbnail result{ relativeImagePath };
+
+	std::ifstream file(Files::GetAbsolutePath(relativeImagePath), std::ios::binary);
+	const std::vector<unsigned char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (!content.empty()) {
+		const uint64_t contentHash = HashContent(content.data(), content.size());
+		if (!TryReadFromPack(contentHash, result.Pixels)) {
+			if (CreateThumbnailPixels(content.data(), content.size(), result.Pixels)) WriteToPack(contentHash, result.Pixels);
+			else std::cout << "Unable to create thumbnail of " << relativeImagePath << " : " << stbi_failure_reason() << std::endl;
+		}
+	}
+
+	std::lock_guard lock(finishedMutex);
+	finished.push_back(std::move(result));
+}
+
+bool ThumbnailCache::TryReadFromPack(const uint64_t contentHash, std::vector<unsigned char>& out_pixels) {
+	std::lock_guard lock(packMutex);
+	const auto iterator = packIndex.find(contentHash);
+	if (iterator == packIndex.end() || !packFile.is_open()) return false;
+
+	out_pixels.resize(thumbnailByteSize);
+	packFile.seekg(static_cast<std::streamoff>(iterator->second.Offset));
+	if (packFile.read(reinterpret_cast<char*>(out_pixels.data()), static_cast<std::streamsize>(thumbnailByteSize))) {
+		iterator->second.LastUsed = ++packUseCounter;
+		return true;
+	}
+	packFile.clear();
+	out_pixels.clear();
+	return false;
+}
+
+void ThumbnailCache::WriteToPack(const uint64_t contentHash, const std::vector<unsigned char>& pixels) {
+	std::lock_guard lock(packMutex);
+	if (!packFile.is_open() || packIndex.count(contentHash)) return;
+	if (packIndex.size() >= maxPackThumbnails) {
+		CompactPack();
+		if (!packFile.is_open()) return;
+	}
+
+	packFile.seekp(static_cast<std::streamoff>(packEnd));
+	Serialization::WriteLittleEndian(packFile, contentHash);
+	Serialization::WriteBlock(packFile, pixels.data(), pixels.size());
+	packFile.flush();
+	if (!packFile) {
+		packFile.clear();
+		return;
+	}
+	packIndex[contentHash] = { packEnd + sizeof(uint64_t), ++packUseCounter };
+	packEnd += packRecordSize;
+}
+
+void ThumbnailCache::CompactPack() {
+	std::vector<std::pair<uint64_t, PackRecord>> kept(packIndex.begin(), packIndex.end());
+	const size_t keepCount = kept.size() / 2;
+	std::nth_element(kept.begin(), kept.begin() + keepCount, kept.end(), [](const auto& a, const auto& b) { return a.second.LastUsed > b.second.LastUsed; });
+	kept.resize(keepCount);
+	// moved in file order, so a record only ever overwrites one that is dropped or already moved
+	std::sort(kept.begin(), kept.end(), [](const auto& a, const auto& b) { return a.second.Offset < b.second.Offset; });
+
+	packIndex.clear();
+	std::vector<char> record(packRecordSize);
+	uint64_t end = packHeaderSize;
+	for (const auto& [contentHash, packRecord] : kept) {
+		const uint64_t recordOffset = packRecord.Offset - sizeof(uint64_t);
+		if (recordOffset != end) {
+			packFile.seekg(static_cast<std::streamoff>(recordOffset));
+			if (!packFile.read(record.data(), static_cast<std::streamsize>(packRecordSize))) break;
+			packFile.seekp(static_cast<std::streamoff>(end));
+			if (!packFile.write(record.data(), static_cast<std::streamsize>(packRecordSize))) break;
+		}
+		packIndex[contentHash] = { end + sizeof(uint64_t), packRecord.LastUsed };
+		end += packRecordSize;
+	}
+	packEnd = end;
+
+	packFile.close();
+	std::error_code error;
+	std::filesystem::resize_file(packPath, packEnd, error);
+	packFile.clear();
+	packFile.open(packPath, std::ios::in | std::ios::out | std::ios::binary);
+	if (error || !packFile.is_open()) {
+		std::cout << "Unable to compact thumbnail cache " << packPath.string() << std::endl;
+		packIndex.clear();
+		packFile.close();
+	}
+}
+
+int ThumbnailCache::AcquireSlot(const std::string& relativeImagePath) {
+	constexpr size_t slotCount = static_cast<size_t>(SlotsPerRow) * SlotsPerRow;
+	if (slotOwners.size() < slotCount) {
+		slotOwners.push_back(relativeImagePath);
+		slotLastUsed.push_back(frameNumber);
+		return static_cast<int>(slotOwners.size() - 1);
+	}
+
+	// least recently drawn, thumbnails drawn this frame stay
+	const auto oldest = std::min_element(slotLastUsed.begin(), slotLastUsed.end());
+	if (*oldest >= frameNumber) return -1;
+	const int slot = static_cast<int>(oldest - slotLastUsed.begin());
+	if (const auto previousOwner = entries.find(slotOwners[slot]); previousOwner != entries.end()) previousOwner->second.Slot = -1;
+	slotOwners[slot] = relativeImagePath;
+	slotLastUsed[slot] = frameNumber;
+	return slot;
+}
+
+void ThumbnailCache::Refresh(const std::string& relativeImagePath) {
+	const auto iterator = entries.find(relativeImagePath);
+	if (iterator == entries.end()) return;
+	Entry& entry = iterator->second;
+
+	std::error_code error;
+	const auto writeTime = std::filesystem::last_write_time(Files::GetAbsolutePath(relativeImagePath), error);
+	if (error || writeTime == entry.WriteTime) return;
+	entry.WriteTime = writeTime;
+	entry.Failed = false;
+	const auto waiting = std::find_if(waitingForSlot.begin(), waitingForSlot.end(), [&relativeImagePath](const FinishedThumbnail& thumbnail) {
+		return thumbnail.RelativeImagePath == relativeImagePath;
+	});
+	if (waiting != waitingForSlot.end()) waitingForSlot.erase(waiting);
+	else if (entry.Pending) return;
+	Request(relativeImagePath, entry);
+}
+
+bool ThumbnailCache::TryGetThumbnail(const std::string& relativeImagePath, Thumbnail& out_thumbnail) {
+	const auto [iterator, inserted] = entries.try_emplace(relativeImagePath);
+	Entry& entry = iterator->second;
+	if (inserted) {
+		std::error_code error;
+		entry.WriteTime = std::filesystem::last_write_time(Files::GetAbsolutePath(relativeImagePath), error);
+	}
+	if (entry.Slot < 0) {
+		if (!entry.Pending && !entry.Failed) Request(relativeImagePath, entry);
+		return false;
+	}
+
+	slotLastUsed[entry.Slot] = frameNumber;
+	const glm::vec2 slotPosition(entry.Slot % SlotsPerRow, entry.Slot / SlotsPerRow);
+	out_thumbnail.TextureId = atlasTextureId;
+	out_thumbnail.UvMin = slotPosition * static_cast<float>(ThumbnailSize) / static_cast<float>(AtlasSize);
+	out_thumbnail.UvMax = out_thumbnail.UvMin + glm::vec2(static_cast<float>(ThumbnailSize) / static_cast<float>(AtlasSize));
+	return true;
+}
+
+void ThumbnailCache::Update() {
+	++frameNumber;
+	// waiting ones first, they finished earlier
+	std::vector<FinishedThumbnail> uploads;
+	uploads.swap(waitingForSlot);
+	{
+		std::lock_guard lock(finishedMutex);
+		uploads.insert(uploads.end(), std::make_move_iterator(finished.begin()), std::make_move_iterator(finished.end()));
+		finished.clear();
+	}
+	if (uploads.empty()) return;
+
+	if (atlasTextureId == 0 && !Texture::IsHeadless()) {
+		glCreateTextures(GL_TEXTURE_2D, 1, &atlasTextureId);
+		glTextureStorage2D(atlasTextureId, 1, GL_RGBA8, AtlasSize, AtlasSize);
+		glTextureParameteri(atlasTextureId, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(atlasTextureId, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(atlasTextureId, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(atlasTextureId, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		constexpr unsigned char clearColor[4] = { 0, 0, 0, 0 };
+		glClearTexImage(atlasTextureId, 0, GL_RGBA, GL_UNSIGNED_BYTE, clearColor);
+	}
+
+	for (auto& thumbnail : uploads) {
+		Entry& entry = entries[thumbnail.RelativeImagePath];
+		if (thumbnail.Pixels.empty()) {
+			entry.Pending = false;
+			entry.Failed = true;
+			continue;
+		}
+		// a refreshed thumbnail replaces the old one in place
+		const int slot = entry.Slot >= 0 ? entry.Slot : AcquireSlot(thumbnail.RelativeImagePath);
+		if (slot < 0) {
+			// stays pending, so it is not decoded again
+			waitingForSlot.push_back(std::move(thumbnail));
+			continue;
+		}
+		entry.Pending = false;
+		entry.Slot = slot;
+		if (atlasTextureId != 0) {
+			glTextureSubImage2D(atlasTextureId, 0, slot % SlotsPerRow * ThumbnailSize, slot / SlotsPerRow * ThumbnailSize, ThumbnailSize, ThumbnailSize,
+								GL_RGBA, GL_UNSIGNED_BYTE, thumbnail.Pixels.data());
+		}
+	}
+}
+
+void ThumbnailCache::Free() {
+	if (atlasTextureId != 0) glDeleteTextures(1, &atlasTextureId);
+	atlasTextureId = 0;
+	entries.clear();
+	slotOwners.clear();
+	slotLastUsed.clear();
+	waitingForSlot.clear();
+	finished.clear();
+
+	std::lock_guard lock(packMutex);
+	packIndex.clear();
+	if (packFile.is_open()) packFile.close();
+}
+
+bool ThumbnailCache::CreateThumbnailPixels(const unsigned char* encodedImage, const size_t byteSize, std::vector<unsigned char>& out_pixels) {
+	stbi_set_flip_vertically_on_load_thread(false);
+	int width, height, channelCount;
+	unsigned char* image = stbi_load_from_memory(encodedImage, static_cast<int>(byteSize), &width, &height, &channelCount, 4);
+	if (image == nullptr) return false;
+
+	// small images are scaled up by whole pixels so pixel art stays sharp
+	float scale = std::min(static_cast<float>(ThumbnailSize) / width, static_cast<float>(ThumbnailSize) / height);
+	if (scale > 1.0f) scale = std::floor(scale);
+	const int targetWidth = std::clamp(static_cast<int>(width * scale), 1, ThumbnailSize);
+	const int targetHeight = std::clamp(static_cast<int>(height * scale), 1, ThumbnailSize);
+	const int offsetX = (ThumbnailSize - targetWidth) / 2;
+	const int offsetY = (ThumbnailSize - targetHeight) / 2;
+
+	out_pixels.assign(thumbnailByteSize, 0);
+	for (int y = 0; y < targetHeight; ++y) {
+		const int sourceY0 = y * height / targetHeight;
+		const int sourceY1 = std::max(sourceY0 + 1, (y + 1) * height / targetHeight);
+		for (int x = 0; x < targetWidth; ++x) {
+			const int sourceX0 = x * width / targetWidth;
+			const int sourceX1 = std::max(sourceX0 + 1, (x + 1) * width / targetWidth);
+
+			// box filter, colors weighted by alpha so transparent pixels do not darken the edges
+			uint64_t red = 0, green = 0, blue = 0, alpha = 0;
+			for (int sourceY = sourceY0; sourceY < sourceY1; ++sourceY) {
+				const unsigned char* pixel = image + (static_cast<size_t>(sourceY) * width + sourceX0) * 4;
+				for (int sourceX = sourceX0; sourceX < sourceX1; ++sourceX, pixel += 4) {
+					red += pixel[0] * pixel[3];
+					green += pixel[1] * pixel[3];
+					blue += pixel[2] * pixel[3];
+					alpha += pixel[3];
+				}
+			}
+			const uint64_t pixelCount = static_cast<uint64_t>(sourceX1 - sourceX0) * (sourceY1 - sourceY0);
+			unsigned char* target = out_pixels.data() + (static_cast<size_t>(offsetY + y) * ThumbnailSize + offsetX + x) * 4;
+			if (alpha == 0) continue;
+			target[0] = static_cast<unsigned char>(red / alpha);
+			target[1] = static_cast<unsigned char>(green / alpha);
+			target[2] = static_cast<unsigned char>(blue / alpha);
+			target[3] = static_cast<unsigned char>(alpha / pixelCount);
+		}
+	}
+	stbi_image_free(image);
+	return true;
+}
+
+uint64_t ThumbnailCache::HashContent(const unsigned char* data, const size_t byteSize) {
+	// FNV-1a
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < byteSize; ++i) {
+		hash ^= data[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
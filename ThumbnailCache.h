@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/vec2.hpp>
+
+namespace Rendering {
+	struct Thumbnail {
+		unsigned int TextureId = 0;
+		// top left and bottom right corner, rows are stored top first
+		glm::vec2 UvMin{ 0, 0 };
+		glm::vec2 UvMax{ 1, 1 };
+	};
+
+	// Small previews of image files for the file browsers, so browsing does not need the full textures.
+	// Thumbnails are keyed by a hash of the image file's content and kept in a pack file, missing ones are generated by
+	// JobSystem workers. Thumbnails in use share one atlas texture, the least recently drawn ones are evicted when it is full.
+	// Pack file layout, little-endian: uint32 magic "THPK", uint16 version, uint16 thumbnail size,
+	// then per thumbnail uint64 content hash followed by size * size rgba pixels.
+	// Once the pack holds its maximum thumbnail count, it is compacted to the most recently used half.
+	class ThumbnailCache {
+		struct Entry {
+			std::filesystem::file_time_type WriteTime;
+			int Slot = -1;
+			bool Pending = false;
+			// not retried until the image changes
+			bool Failed = false;
+		};
+		struct FinishedThumbnail {
+			std::string RelativeImagePath;
+			std::vector<unsigned char> Pixels;
+		};
+		struct PackRecord {
+			// of the pixels
+			uint64_t Offset;
+			uint64_t LastUsed;
+		};
+
+		static constexpr uint32_t packMagic = 0x4B504854; // "THPK"
+		static constexpr uint16_t packVersion = 1;
+
+		// main thread only, keyed by relative image path
+		inline static std::unordered_map<std::string, Entry> entries;
+		inline static std::vector<std::string> slotOwners;
+		inline static std::vector<uint64_t> slotLastUsed;
+		inline static uint64_t frameNumber = 0;
+		inline static unsigned int atlasTextureId = 0;
+		// finished while every slot was drawn this frame, uploaded once one frees up
+		inline static std::vector<FinishedThumbnail> waitingForSlot;
+
+		// shared with workers
+		inline static std::mutex packMutex;
+		inline static std::fstream packFile;
+		inline static std::filesystem::path packPath;
+		inline static size_t maxPackThumbnails = 0;
+		inline static uint64_t packUseCounter = 0;
+		inline static std::unordered_map<uint64_t, PackRecord> packIndex;
+		inline static std::mutex finishedMutex;
+		inline static std::vector<FinishedThumbnail> finished;
+
+		static void Request(const std::string& relativeImagePath, Entry& entry);
+		static void Generate(const std::string& relativeImagePath);
+		static bool TryReadFromPack(uint64_t contentHash, std::vector<unsigned char>& out_pixels);
+		static void WriteToPack(uint64_t contentHash, const std::vector<unsigned char>& pixels);
+		// packMutex must be held
+		static void CompactPack();
+		static int AcquireSlot(const std::string& relativeImagePath);
+
+	public:
+		static constexpr int ThumbnailSize = 64;
+		static constexpr int AtlasSize = 2048;
+		static constexpr int SlotsPerRow = AtlasSize / ThumbnailSize;
+		// 64 MB of thumbnails
+		static constexpr size_t DefaultMaxPackThumbnails = 4096;
+
+		// Opens or creates the pack file and reads its index
+		static bool Initialize(const std::filesystem::path& packFilePath, size_t maxThumbnailCount = DefaultMaxPackThumbnails);
+
+		// Generates the thumbnail again if the image changed since it was requested
+		static void Refresh(const std::string& relativeImagePath);
+		// False while the thumbnail is not in the atlas, requests it if needed
+		static bool TryGetThumbnail(const std::string& relativeImagePath, Thumbnail& out_thumbnail);
+
+		// Main thread, once per frame: uploads finished thumbnails to the atlas
+		static void Update();
+		// Workers must be finished
+		static void Free();
+
+		// Decodes and shrinks an image to fit ThumbnailSize, keeping its aspect ratio. Rows top first.
+		static bool CreateThumbnailPixels(const unsigned char* encodedImage, size_t byteSize, std::vector<unsigned char>& out_pixels);
+		static uint64_t HashContent(const unsigned char* data, size_t byteSize);
+	};
+}
@@ -81,10 +81,10 @@ namespace Tiles {
 		}
 		ImGui::SameLine(); ImGuiHelper::TextWithToolTip("", "AutoTiles and walls will automatically change their displayed texture based on the tiles around them.");
 
-		unsigned int texId = 0;
-		if (Rendering::Texture* t; Resources::TryGetTexture(DisplayTexture, t)) texId = t->GetTextureID();
+		Rendering::Texture* displayTexture;
+		Resources::TryGetTexture(DisplayTexture, displayTexture);
 		ImGuiHelper::TextWithToolTip("Tile Icon", "Texture that will represent this tile in menus");
-		ImGuiHelper::Image(texId, ImVec2(32, 32));
+		ImGuiHelper::Image(displayTexture, ImVec2(32, 32));
 		if (ImGui::BeginDragDropTarget()) {
 			if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("Texture")) {
 				const Rendering::Texture* t = *static_cast<const Rendering::Texture**>(payload->Data);
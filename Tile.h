@@ -32,6 +32,14 @@ namespace  Tiles {
 		const ITilePattern* GetPattern() const {
 			return patternUPtr.get();
 		}
+		ITilePattern* GetPattern() {
+			return patternUPtr.get();
+		}
+		// Replaces the pattern with an empty one of the new type
+		void SetType(Tiles::TileType type) {
+			TileType = type;
+			SetPatternFromType();
+		}
 
 		void TileMapSet(TileMap* tileMap, glm::vec2 position) const;
 		void TileMapErase(TileMap* tileMap, glm::vec2 position) const;
@@ -0,0 +1,43 @@
+#include "TileChunk.h"
+
+namespace Tiles {
+	TileChunk* TileChunkStorage::GetChunk(const glm::ivec2 chunkCoord) const {
+		const auto it = chunks.find(chunkCoord);
+		return it != chunks.end() ? it->second.get() : nullptr;
+	}
+
+	TileChunk* TileChunkStorage::GetOrCreateChunk(const glm::ivec2 chunkCoord) {
+		auto& chunk = chunks[chunkCoord];
+		if (chunk == nullptr) chunk = std::make_unique<TileChunk>();
+		return chunk.get();
+	}
+
+	uint16_t TileChunkStorage::GetTileIndex(const glm::ivec2 position) const {
+		const TileChunk* chunk = GetChunk(ToChunkCoord(position));
+		if (chunk == nullptr) return 0;
+		return chunk->TileIndices[TileChunk::CellIndex(ToLocalPosition(position))];
+	}
+
+	void TileChunkStorage::OnTilesAdded(TileChunk* chunk, const int count) {
+		chunk->TileCount += count;
+		tileCount += count;
+	}
+
+	void TileChunkStorage::OnTileRemoved(TileChunk* chunk, const glm::ivec2 chunkCoord) {
+		--tileCount;
+		if (--chunk->TileCount == 0) {
+			chunks.erase(chunkCoord);
+		}
+	}
+
+	void TileChunkStorage::Clear() {
+		chunks.clear();
+		tileCount = 0;
+	}
+
+	size_t TileChunkStorage::GetMemoryUsage() const {
+		// chunk payload + one hash node (key, pointer, next, cached hash) and bucket per chunk
+		constexpr size_t nodeSize = sizeof(glm::ivec2) + sizeof(std::unique_ptr<TileChunk>) + sizeof(void*) + sizeof(size_t);
+		return chunks.size() * (sizeof(TileChunk) + nodeSize) + chunks.bucket_count() * sizeof(void*);
+	}
+}
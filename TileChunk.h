@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <glm/vec2.hpp>
+#include "glm/gtx/hash.hpp"
+
+#include "TilePatterns.h"
+
+namespace Rendering {
+	class Texture;
+}
+
+namespace Tiles {
+
+	// Dense block of tiles. Tile indices point into the owning tileMap's palette, 0 means empty.
+	struct TileChunk {
+		static constexpr int Size = 32;
+		static constexpr int Shift = 5;
+		static constexpr int LocalMask = Size - 1;
+		static constexpr int CellCount = Size * Size;
+
+		std::array<uint16_t, CellCount> TileIndices{};
+		std::array<uint8_t, CellCount> Masks{};
+		std::array<Rendering::Texture*, CellCount> Textures{};
+		int TileCount = 0;
+
+		static int CellIndex(const glm::ivec2 local) { return local.y * Size + local.x; }
+		static glm::ivec2 CellPosition(const int cell) { return { cell & LocalMask, cell >> Shift }; }
+
+		SurroundingTileFlags GetMask(const int cell) const { return static_cast<SurroundingTileFlags>(Masks[cell]); }
+	};
+
+	// Sparse collection of chunks, addressed by tileMap grid positions.
+	class TileChunkStorage {
+		std::unordered_map<glm::ivec2, std::unique_ptr<TileChunk>> chunks{};
+		size_t tileCount = 0;
+
+	public:
+		// Arithmetic shift and mask floor towards negative infinity, so -1 ends up in chunk -1 at local 31
+		static glm::ivec2 ToChunkCoord(const glm::ivec2 position) { return { position.x >> TileChunk::Shift, position.y >> TileChunk::Shift }; }
+		static glm::ivec2 ToLocalPosition(const glm::ivec2 position) { return { position.x & TileChunk::LocalMask, position.y & TileChunk::LocalMask }; }
+		static glm::ivec2 ToGridPosition(const glm::ivec2 chunkCoord, const glm::ivec2 local) { return chunkCoord * TileChunk::Size + local; }
+
+		TileChunk* GetChunk(glm::ivec2 chunkCoord) const;
+		TileChunk* GetOrCreateChunk(glm::ivec2 chunkCoord);
+
+		// Returns palette index at position or 0 if empty
+		uint16_t GetTileIndex(glm::ivec2 position) const;
+
+		// Bookkeeping for tiles being added/removed from a chunk, removes the chunk once it is empty
+		void OnTileAdded(TileChunk* chunk) { OnTilesAdded(chunk, 1); }
+		void OnTilesAdded(TileChunk* chunk, int count);
+		void OnTileRemoved(TileChunk* chunk, glm::ivec2 chunkCoord);
+
+		void Clear();
+
+		size_t GetTileCount() const { return tileCount; }
+		size_t GetChunkCount() const { return chunks.size(); }
+		size_t GetMemoryUsage() const;
+
+		// func(const glm::ivec2& chunkCoord, const TileChunk& chunk)
+		template<typename Func>
+		void ForEachChunk(Func&& func) const {
+			for (const auto& [coord, chunk] : chunks) func(coord, *chunk);
+		}
+
+		// func(const glm::ivec2& gridPosition, const TileChunk& chunk, int cell)
+		template<typename Func>
+		void ForEachTile(Func&& func) const {
+			for (const auto& [coord, chunk] : chunks) {
+				const glm::ivec2 origin = coord * TileChunk::Size;
+				for (int cell = 0; cell < TileChunk::CellCount; ++cell) {
+					if (chunk->TileIndices[cell] == 0) continue;
+					func(origin + TileChunk::CellPosition(cell), *chunk, cell);
+				}
+			}
+		}
+	};
+}
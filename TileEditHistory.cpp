@@ -0,0 +1,163 @@
+#include "TileEditHistory.h"
+
+#include <iostream>
+
+#include "TileMap.h"
+
+Tiles::TileEditHistory::TileEditHistory(const size_t memoryBudgetBytes) : memoryBudget(memoryBudgetBytes) {
+}
+
+void Tiles::TileEditHistory::BeginStroke(TileMap* tileMap) {
+	if (strokeMap == tileMap) return;
+	if (IsRecording()) EndStroke();
+	if (tileMap == nullptr) return;
+
+	strokeMap = tileMap;
+	strokeMap->SetEditHistory(this);
+}
+
+void Tiles::TileEditHistory::RecordCell(const glm::ivec2 gridPosition, const uint16_t previousIndex, const uint8_t previousMask) {
+	// only the state before the first change of a cell matters
+	if (!strokeLookup.try_emplace(gridPosition, strokeDeltas.size()).second) return;
+
+	// pinned right away, the stroke may release the last reference to the previous tile
+	if (previousIndex != 0) strokeMap->PinPaletteIndex(previousIndex);
+	strokeDeltas.push_back({ gridPosition.x, gridPosition.y, previousIndex, 0, previousMask, 0 });
+}
+
+void Tiles::TileEditHistory::EndStroke() {
+	if (!IsRecording()) return;
+	TileMap* tileMap = strokeMap;
+	tileMap->SetEditHistory(nullptr);
+	strokeMap = nullptr;
+	strokeLookup.clear();
+
+	// drop cells that ended up unchanged, the rest keeps its pins
+	size_t changedCount = 0;
+	for (auto& delta : strokeDeltas) {
+		tileMap->GetCellState(glm::ivec2(delta.X, delta.Y), delta.NewIndex, delta.NewMask);
+		if (delta.NewIndex == delta.PreviousIndex) {
+			if (delta.PreviousIndex != 0) tileMap->UnpinPaletteIndex(delta.PreviousIndex);
+			continue;
+		}
+		if (delta.NewIndex != 0) tileMap->PinPaletteIndex(delta.NewIndex);
+		strokeDeltas[changedCount++] = delta;
+	}
+	strokeDeltas.resize(changedCount);
+	if (strokeDeltas.empty()) return;
+
+	DiscardRedo();
+	const size_t capacity = GetCapacity();
+	if (strokeDeltas.size() > capacity) {
+		std::cout << "Edit of " << strokeDeltas.size() << " tiles exceeds the undo memory budget, history cleared." << std::endl;
+		for (const auto& delta : strokeDeltas) {
+			if (delta.PreviousIndex != 0) tileMap->UnpinPaletteIndex(delta.PreviousIndex);
+			if (delta.NewIndex != 0) tileMap->UnpinPaletteIndex(delta.NewIndex);
+		}
+		strokeDeltas.clear();
+		Clear();
+		return;
+	}
+	if (deltas.size() != capacity) deltas.resize(capacity);
+	while (deltaCount + strokeDeltas.size() > capacity) EvictOldest();
+
+	const Entry entry{ tileMap, (deltaStart + deltaCount) % capacity, strokeDeltas.size() };
+	for (size_t i = 0; i < strokeDeltas.size(); ++i) deltas[(entry.FirstDelta + i) % capacity] = strokeDeltas[i];
+	deltaCount += strokeDeltas.size();
+	entries.push_back(entry);
+	appliedCount = entries.size();
+	strokeDeltas.clear();
+}
+
+void Tiles::TileEditHistory::UnpinEntry(const Entry& entry) {
+	if (entry.Map == nullptr) return;
+	for (size_t i = 0; i < entry.DeltaCount; ++i) {
+		const TileCellDelta& delta = GetDelta(entry, i);
+		if (delta.PreviousIndex != 0) entry.Map->UnpinPaletteIndex(delta.PreviousIndex);
+		if (delta.NewIndex != 0) entry.Map->UnpinPaletteIndex(delta.NewIndex);
+	}
+}
+
+void Tiles::TileEditHistory::EvictOldest() {
+	const Entry& oldest = entries.front();
+	UnpinEntry(oldest);
+	deltaStart = (deltaStart + oldest.DeltaCount) % GetCapacity();
+	deltaCount -= oldest.DeltaCount;
+	entries.pop_front();
+	if (appliedCount > 0) --appliedCount;
+}
+
+void Tiles::TileEditHistory::DiscardRedo() {
+	while (entries.size() > appliedCount) {
+		UnpinEntry(entries.back());
+		deltaCount -= entries.back().DeltaCount;
+		entries.pop_back();
+	}
+}
+
+void Tiles::TileEditHistory::Apply(const Entry& entry, const bool undo) {
+	// deltas of one entry touch distinct cells, autotiling of the dilated region runs once on CommitEdit
+	entry.Map->BeginEdit();
+	for (size_t i = 0; i < entry.DeltaCount; ++i) entry.Map->ApplyCellDelta(GetDelta(entry, i), undo);
+	entry.Map->CommitEdit();
+}
+
+bool Tiles::TileEditHistory::Undo() {
+	EndStroke();
+	while (appliedCount > 0) {
+		const Entry& entry = entries[--appliedCount];
+		if (entry.Map == nullptr) continue;
+		Apply(entry, true);
+		return true;
+	}
+	return false;
+}
+
+bool Tiles::TileEditHistory::Redo() {
+	EndStroke();
+	while (appliedCount < entries.size()) {
+		const Entry& entry = entries[appliedCount++];
+		if (entry.Map == nullptr) continue;
+		Apply(entry, false);
+		return true;
+	}
+	return false;
+}
+
+void Tiles::TileEditHistory::RemoveTileMap(const TileMap* tileMap) {
+	if (strokeMap == tileMap) EndStroke();
+	// the tileMap and its palette go away, so its pins are simply forgotten
+	for (auto& entry : entries) {
+		if (entry.Map == tileMap) entry.Map = nullptr;
+	}
+}
+
+void Tiles::TileEditHistory::Clear() {
+	EndStroke();
+	for (const auto& entry : entries) UnpinEntry(entry);
+	entries.clear();
+	deltaStart = 0;
+	deltaCount = 0;
+	appliedCount = 0;
+}
+
+void Tiles::TileEditHistory::SetMemoryBudget(const size_t bytes) {
+	EndStroke();
+	const size_t newCapacity = bytes / sizeof(TileCellDelta);
+	while (deltaCount > newCapacity) EvictOldest();
+
+	// repack the remaining entries from the start of the new ring
+	std::vector<TileCellDelta> newDeltas;
+	if (deltaCount > 0) {
+		newDeltas.resize(newCapacity);
+		size_t position = 0;
+		for (auto& entry : entries) {
+			for (size_t i = 0; i < entry.DeltaCount; ++i) newDeltas[position + i] = GetDelta(entry, i);
+			entry.FirstDelta = position;
+			position += entry.DeltaCount;
+		}
+	}
+	deltas = std::move(newDeltas);
+	deltaStart = 0;
+	memoryBudget = bytes;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+#include <glm/vec2.hpp>
+#include "glm/gtx/hash.hpp"
+
+namespace Tiles {
+	class TileMap;
+
+	// Change of one cell, indices refer to the tileMap's palette and stay valid while the history pins them
+	struct TileCellDelta {
+		int32_t X;
+		int32_t Y;
+		uint16_t PreviousIndex;
+		uint16_t NewIndex;
+		uint8_t PreviousMask;
+		uint8_t NewMask;
+	};
+
+	// Undo/redo journal of tile edits. Each stroke becomes one entry, its deltas are stored in a ring buffer
+	// sized by the memory budget and the oldest entries are evicted first.
+	class TileEditHistory {
+		struct Entry {
+			// null once the tileMap was deleted, skipped by undo and redo
+			TileMap* Map;
+			size_t FirstDelta;
+			size_t DeltaCount;
+		};
+
+		size_t memoryBudget;
+		std::vector<TileCellDelta> deltas;
+		size_t deltaStart = 0;
+		size_t deltaCount = 0;
+		std::deque<Entry> entries;
+		// entries before this index can be undone, the rest redone
+		size_t appliedCount = 0;
+
+		TileMap* strokeMap = nullptr;
+		std::vector<TileCellDelta> strokeDeltas;
+		std::unordered_map<glm::ivec2, size_t> strokeLookup;
+
+		// the ring is allocated on the first stroke
+		size_t GetCapacity() const { return memoryBudget / sizeof(TileCellDelta); }
+		const TileCellDelta& GetDelta(const Entry& entry, size_t index) const { return deltas[(entry.FirstDelta + index) % GetCapacity()]; }
+		void UnpinEntry(const Entry& entry);
+		void EvictOldest();
+		void DiscardRedo();
+		void Apply(const Entry& entry, bool undo);
+
+	public:
+		TileEditHistory(const TileEditHistory& other) = delete;
+		TileEditHistory& operator=(const TileEditHistory& other) = delete;
+
+		static constexpr size_t DefaultMemoryBudget = 16 * 1024 * 1024;
+		explicit TileEditHistory(size_t memoryBudgetBytes = DefaultMemoryBudget);
+
+		// Cells edited on the tileMap until EndStroke are merged into one entry
+		void BeginStroke(TileMap* tileMap);
+		void EndStroke();
+		bool IsRecording() const { return strokeMap != nullptr; }
+		// Called by the tileMap before a cell changes
+		void RecordCell(glm::ivec2 gridPosition, uint16_t previousIndex, uint8_t previousMask);
+
+		bool Undo();
+		bool Redo();
+		bool CanUndo() const { return appliedCount > 0; }
+		bool CanRedo() const { return appliedCount < entries.size(); }
+
+		// Drops the entries of a tileMap that is about to be deleted
+		void RemoveTileMap(const TileMap* tileMap);
+		void Clear();
+
+		// Keeps the newest entries that fit into the new budget
+		void SetMemoryBudget(size_t bytes);
+		size_t GetMemoryBudget() const { return memoryBudget; }
+		size_t GetMemoryUsage() const { return deltaCount * sizeof(TileCellDelta) + entries.size() * sizeof(Entry); }
+		size_t GetEntryCount() const { return entries.size(); }
+		size_t GetUndoCount() const { return appliedCount; }
+	};
+}
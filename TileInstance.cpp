@@ -2,37 +2,23 @@
 
 #include "Resources.h"
 #include "Tile.h"
-#include "TileMap.h"
 
-namespace Tiles {
-
-	bool TileInstance::HasSameTileAtPos(const glm::ivec2 position, const TileMap* tileMap) const {
-		TileInstance* tileInstance = nullptr;
-		if (tileMap->TryGetTile(position, tileInstance)) {
-			bool same = tileInstance->parent == this->parent;
-			return same;
-		}
-		return false;
+namespace {
+	// Stable per position, unlike srand/rand it does not touch global state
+	uint32_t HashPosition(const glm::ivec2 position) {
+		uint32_t hash = static_cast<uint32_t>(position.x) * 0x8da6b343u ^ static_cast<uint32_t>(position.y) * 0xd8163841u;
+		hash ^= hash >> 16;
+		hash *= 0x7feb352du;
+		hash ^= hash >> 15;
+		return hash;
 	}
+}
 
-	SurroundingTileFlags TileInstance::GetMaskFromSurroundingTiles(const glm::ivec2 position, const TileMap* tileMap) const {
-		SurroundingTileFlags surroundingMask = SurroundingTileFlags::NONE;
-
-		if (HasSameTileAtPos(position + glm::ivec2(-1, 1), tileMap)) surroundingMask = surroundingMask | SurroundingTileFlags::UP_LEFT;
-		if (HasSameTileAtPos(position + glm::ivec2(0, 1), tileMap)) surroundingMask = surroundingMask | SurroundingTileFlags::UP;
-		if (HasSameTileAtPos(position + glm::ivec2(1, 1), tileMap)) surroundingMask = surroundingMask | SurroundingTileFlags::UP_RIGHT;
-		if (HasSameTileAtPos(position + glm::ivec2(-1, 0), tileMap)) surroundingMask = surroundingMask | SurroundingTileFlags::LEFT;
-		if (HasSameTileAtPos(position + glm::ivec2(1, 0), tileMap)) surroundingMask = surroundingMask | SurroundingTileFlags::RIGHT;
-		if (HasSameTileAtPos(position + glm::ivec2(-1, -1), tileMap)) surroundingMask = surroundingMask | SurroundingTileFlags::DOWN_LEFT;
-		if (HasSameTileAtPos(position + glm::ivec2(0, -1), tileMap)) surroundingMask = surroundingMask | SurroundingTileFlags::DOWN;
-		if (HasSameTileAtPos(position + glm::ivec2(1, -1), tileMap)) surroundingMask = surroundingMask | SurroundingTileFlags::DOWN_RIGHT;
-
-		return surroundingMask;
-	}
+namespace Tiles {
 
-	Rendering::Texture* TileInstance::GetTextureFromMask(const glm::ivec2 position) const {
+	Rendering::Texture* TileInstance::GetTextureFromMask(const Tile* parent, const SurroundingTileFlags mask, const glm::ivec2 position) {
 		Rendering::Texture* t = Rendering::Texture::Empty();
-		auto slot = parent->GetPattern()->GetTileSlot(surroundingTileMask);
+		auto slot = parent->GetPattern()->GetTileSlot(mask);
 		if (slot && !slot->TileSprites.empty()) {
 
 			int spriteCount = slot->TileSprites.size();
@@ -42,10 +28,7 @@ namespace Tiles {
 				return t;
 			}
 
-			//seed random 
-			const unsigned seed = position.x ^ 91028309 ^ position.y;
-			srand(seed);
-			int pos = rand() % spriteCount;
+			const int pos = static_cast<int>(HashPosition(position) % spriteCount);
 
 			const TextureVariant& variant = slot->TileSprites[pos];
 			Resources::TryGetTexture(variant.TextureId, t);
@@ -54,11 +37,4 @@ namespace Tiles {
 		return t;
 	}
 
-	void TileInstance::Refresh(glm::ivec2 position, const TileMap* tileMap) {
-		auto mask = parent->TileType == TileType::Simple ? SurroundingTileFlags::NONE : GetMaskFromSurroundingTiles(position, tileMap);
-		surroundingTileMask = mask;
-		texture = GetTextureFromMask(position);
-	}
-
-
 }
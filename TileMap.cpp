@@ -1,4 +1,11 @@
 #include "TileMap.h"
+
+#include <bitset>
+#include <cassert>
+#include <climits>
+#include <iostream>
+#include <unordered_set>
+
 #include "Mesh.h"
 #include "Shader.h"
 #include "TileInstance.h"
@@ -6,80 +13,481 @@
 #include "Files.h"
 #include "Resources.h"
 #include "Tile.h"
+#include "TextureAtlas.h"
+#include "TextureSheet.h"
+#include "Camera.h"
+#include "TileEditHistory.h"
+#include "Prefab.h"
 
 #include "ImGuiHelper.h"
 
+namespace {
+	constexpr float tileDepth = 0.01f;
+
+	struct NeighbourOffset {
+		glm::ivec2 Offset;
+		Tiles::SurroundingTileFlags Flag;
+	};
+
+	const NeighbourOffset neighbourOffsets[] = {
+		{ glm::ivec2(-1, 1), Tiles::SurroundingTileFlags::UP_LEFT },
+		{ glm::ivec2(0, 1), Tiles::SurroundingTileFlags::UP },
+		{ glm::ivec2(1, 1), Tiles::SurroundingTileFlags::UP_RIGHT },
+		{ glm::ivec2(-1, 0), Tiles::SurroundingTileFlags::LEFT },
+		{ glm::ivec2(1, 0), Tiles::SurroundingTileFlags::RIGHT },
+		{ glm::ivec2(-1, -1), Tiles::SurroundingTileFlags::DOWN_LEFT },
+		{ glm::ivec2(0, -1), Tiles::SurroundingTileFlags::DOWN },
+		{ glm::ivec2(1, -1), Tiles::SurroundingTileFlags::DOWN_RIGHT },
+	};
+}
+
+uint16_t Tiles::TileMap::AcquirePaletteIndex(const Tile* tile) {
+	if (const auto it = paletteLookup.find(tile); it != paletteLookup.end()) {
+		++paletteReferenceCounts[it->second];
+		return it->second;
+	}
+
+	uint16_t index = 0;
+	if (!freePaletteIndices.empty()) {
+		index = freePaletteIndices.back();
+		freePaletteIndices.pop_back();
+		palette[index] = tile;
+		paletteReferenceCounts[index] = 1;
+		palettePinCounts[index] = 0;
+	}
+	else {
+		if (palette.size() > UINT16_MAX) throw std::exception("tileMap palette is full");
+		index = static_cast<uint16_t>(palette.size());
+		palette.push_back(tile);
+		paletteReferenceCounts.push_back(1);
+		palettePinCounts.push_back(0);
+	}
+	paletteLookup.emplace(tile, index);
+	return index;
+}
+
+void Tiles::TileMap::ReleasePaletteIndex(const uint16_t index) {
+	if (--paletteReferenceCounts[index] > 0) return;
+
+	paletteLookup.erase(palette[index]);
+	palette[index] = nullptr;
+	freePaletteIndices.push_back(index);
+}
+
+void Tiles::TileMap::PinPaletteIndex(const uint16_t index) {
+	++paletteReferenceCounts[index];
+	++palettePinCounts[index];
+}
+
+void Tiles::TileMap::UnpinPaletteIndex(const uint16_t index) {
+	--palettePinCounts[index];
+	ReleasePaletteIndex(index);
+}
+
+bool Tiles::TileMap::HasSameTileAtPos(const glm::ivec2 position, const uint16_t tileIndex) const {
+	return chunks.GetTileIndex(ConvertToTileMapGridPosition(position)) == tileIndex;
+}
+
+Tiles::SurroundingTileFlags Tiles::TileMap::GetMaskFromSurroundingTiles(const TileChunk* chunk, const glm::ivec2 local, const glm::ivec2 position, const uint16_t tileIndex) const {
+	// neighbours of cells away from the chunk border can be read straight from the chunk
+	const bool isInterior = GridDimensions == glm::ivec2(1, 1) && local.x > 0 && local.y > 0 && local.x < TileChunk::LocalMask && local.y < TileChunk::LocalMask;
+
+	SurroundingTileFlags surroundingMask = SurroundingTileFlags::NONE;
+	for (const auto& [offset, flag] : neighbourOffsets) {
+		const bool isSame = isInterior ? chunk->TileIndices[TileChunk::CellIndex(local + offset)] == tileIndex : HasSameTileAtPos(position + offset, tileIndex);
+		if (isSame) surroundingMask = surroundingMask | flag;
+	}
+
+	return surroundingMask;
+}
+
+void Tiles::TileMap::RefreshTile(TileChunk* chunk, const int cell, const glm::ivec2 position) const {
+	const uint16_t tileIndex = chunk->TileIndices[cell];
+	const Tile* tile = palette[tileIndex];
+	const auto mask = tile->TileType == TileType::Simple ? SurroundingTileFlags::NONE : GetMaskFromSurroundingTiles(chunk, TileChunk::CellPosition(cell), position, tileIndex);
+	chunk->Masks[cell] = static_cast<uint8_t>(mask);
+	chunk->Textures[cell] = TileInstance::GetTextureFromMask(tile, mask, position);
+	instancesDirty = true;
+}
+
 void Tiles::TileMap::RefreshSurroundingTileInstances(const glm::ivec2 position) {
-	TileInstance* t = nullptr;
-	for (int x = -1; x <= 1; ++x) {
-		for (int y = -1; y <= 1; ++y) {
-			if (x == 0 && y == 0) continue; //skip self
-			const auto tilePos = glm::ivec2(position.x + x, position.y + y);
-			if (TryGetTile(tilePos, t))t->Refresh(tilePos, this);
-		}
+	for (const auto& neighbour : neighbourOffsets) {
+		const auto tilePos = position + neighbour.Offset;
+		const auto gridPos = ConvertToTileMapGridPosition(tilePos);
+		TileChunk* chunk = chunks.GetChunk(TileChunkStorage::ToChunkCoord(gridPos));
+		if (chunk == nullptr) continue;
+
+		const int cell = TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(gridPos));
+		if (chunk->TileIndices[cell] != 0) RefreshTile(chunk, cell, gridPos);
 	}
 }
 
-void Tiles::TileMap::ReduceTileReferences(const Tile* tile) {
-	auto id = tile->AssetId.ToString();
-	--tileReferences[id];
+void Tiles::TileMap::OnTileEdited(const glm::ivec2 grid_position) {
+	if (editDepth > 0) {
+		editedPositions.push_back(grid_position);
+		return;
+	}
 
-	if (tileReferences[id] == 0) {
-		tileReferences.erase(id);
+	TileChunk* chunk = chunks.GetChunk(TileChunkStorage::ToChunkCoord(grid_position));
+	if (chunk != nullptr) {
+		const int cell = TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(grid_position));
+		if (chunk->TileIndices[cell] != 0) RefreshTile(chunk, cell, grid_position);
 	}
+	RefreshSurroundingTileInstances(grid_position);
 }
 
-void Tiles::TileMap::SetTile(const Tile* tile, glm::ivec2 grid_position) {
-	grid_position = ConvertToTileMapGridPosition(grid_position);
-	auto ti = TileInstance(tile, grid_position, this);
-	if (auto it = data.find(grid_position); it != data.end()) {
-		if (it->second.GetParent() != tile) {
-			//being replaced with a different tile
-			ReduceTileReferences(it->second.GetParent());
+void Tiles::TileMap::CommitEdit() {
+	assert(editDepth > 0 && "CommitEdit called without BeginEdit");
+	// release builds ignore the unmatched call
+	if (editDepth == 0) return;
+	if (--editDepth > 0) return;
+	RefreshEditedTiles();
+}
+
+void Tiles::TileMap::RefreshAllTiles() {
+	chunks.ForEachChunk([this](const glm::ivec2& coord, const TileChunk&) {
+		TileChunk* chunk = chunks.GetChunk(coord);
+		for (int cell = 0; cell < TileChunk::CellCount; ++cell) {
+			if (chunk->TileIndices[cell] != 0) RefreshTile(chunk, cell, TileChunkStorage::ToGridPosition(coord, TileChunk::CellPosition(cell)));
 		}
-		it->second = ti;
+	});
+	instancesDirty = true;
+}
+
+void Tiles::TileMap::RefreshEditedTiles() {
+	if (editedPositions.empty()) return;
+
+	// dilate edited positions by one tile, marking cells per chunk so every cell is refreshed once
+	std::unordered_map<glm::ivec2, std::bitset<TileChunk::CellCount>> dirtyCells;
+	glm::ivec2 cachedCoord(INT_MAX);
+	std::bitset<TileChunk::CellCount>* cachedCells = nullptr;
+	const auto markDirty = [&](const glm::ivec2 gridPos) {
+		const auto chunkCoord = TileChunkStorage::ToChunkCoord(gridPos);
+		if (cachedCells == nullptr || chunkCoord != cachedCoord) {
+			cachedCoord = chunkCoord;
+			cachedCells = &dirtyCells[chunkCoord];
+		}
+		cachedCells->set(TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(gridPos)));
+	};
+	for (const auto& position : editedPositions) {
+		markDirty(position);
+		for (const auto& neighbour : neighbourOffsets) markDirty(ConvertToTileMapGridPosition(position + neighbour.Offset));
 	}
-	else {
-		//New tile at this position
-		data.emplace(grid_position, ti);
-		++tileReferences[tile->GetAssetId().ToString()];
+	editedPositions.clear();
+
+	for (const auto& [chunkCoord, cells] : dirtyCells) {
+		TileChunk* chunk = chunks.GetChunk(chunkCoord);
+		if (chunk == nullptr) continue;
+		for (int cell = 0; cell < TileChunk::CellCount; ++cell) {
+			if (!cells.test(cell) || chunk->TileIndices[cell] == 0) continue;
+			RefreshTile(chunk, cell, TileChunkStorage::ToGridPosition(chunkCoord, TileChunk::CellPosition(cell)));
+		}
 	}
+}
 
+void Tiles::TileMap::SetTile(const Tile* tile, glm::ivec2 grid_position) {
+	grid_position = ConvertToTileMapGridPosition(grid_position);
+	TileChunk* chunk = chunks.GetOrCreateChunk(TileChunkStorage::ToChunkCoord(grid_position));
+	const int cell = TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(grid_position));
 
-	RefreshSurroundingTileInstances(grid_position);
+	const uint16_t previousIndex = chunk->TileIndices[cell];
+	if (editHistory != nullptr && palette[previousIndex] != tile) editHistory->RecordCell(grid_position, previousIndex, chunk->Masks[cell]);
+	if (previousIndex == 0) {
+		//New tile at this position
+		chunk->TileIndices[cell] = AcquirePaletteIndex(tile);
+		chunks.OnTileAdded(chunk);
+	}
+	else if (palette[previousIndex] != tile) {
+		//being replaced with a different tile
+		chunk->TileIndices[cell] = AcquirePaletteIndex(tile);
+		ReleasePaletteIndex(previousIndex);
+	}
+
+	OnTileEdited(grid_position);
 }
 
 void Tiles::TileMap::RemoveTile(glm::ivec2 grid_position) {
 	grid_position = ConvertToTileMapGridPosition(grid_position);
-	auto it = data.find(grid_position);
-	if (it == data.end()) {
+	const auto chunkCoord = TileChunkStorage::ToChunkCoord(grid_position);
+	TileChunk* chunk = chunks.GetChunk(chunkCoord);
+	if (chunk == nullptr) {
 		return;
 	}
-	ReduceTileReferences(it->second.GetParent());
-	data.erase(grid_position);
-	RefreshSurroundingTileInstances(grid_position);
+	const int cell = TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(grid_position));
+	const uint16_t tileIndex = chunk->TileIndices[cell];
+	if (tileIndex == 0) {
+		return;
+	}
+
+	if (editHistory != nullptr) editHistory->RecordCell(grid_position, tileIndex, chunk->Masks[cell]);
+	ReleasePaletteIndex(tileIndex);
+	chunk->TileIndices[cell] = 0;
+	chunk->Masks[cell] = 0;
+	chunk->Textures[cell] = nullptr;
+	// may free the chunk
+	chunks.OnTileRemoved(chunk, chunkCoord);
+	instancesDirty = true;
+
+	OnTileEdited(grid_position);
 }
 
-bool Tiles::TileMap::TryGetTile(glm::ivec2 grid_position, TileInstance*& out_tileInstance) {
-	grid_position = ConvertToTileMapGridPosition(grid_position);
-	const auto iterator = data.find(grid_position);
-	if (iterator != data.end()) {
-		out_tileInstance = &iterator->second;
-		return true;
+bool Tiles::TileMap::TryGetTile(const glm::ivec2 grid_position, TileInstance& out_tileInstance) const {
+	const auto gridPos = ConvertToTileMapGridPosition(grid_position);
+	const TileChunk* chunk = chunks.GetChunk(TileChunkStorage::ToChunkCoord(gridPos));
+	if (chunk != nullptr) {
+		const int cell = TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(gridPos));
+		if (const uint16_t tileIndex = chunk->TileIndices[cell]; tileIndex != 0) {
+			out_tileInstance = TileInstance(palette[tileIndex], chunk->Textures[cell], chunk->GetMask(cell));
+			return true;
+		}
 	}
-	out_tileInstance = nullptr;
+	out_tileInstance = TileInstance();
 	return false;
 }
 
-bool Tiles::TileMap::TryGetTile(const glm::ivec2 grid_position, TileInstance*& out_tileInstance) const {
-	const auto gridPos = ConvertToTileMapGridPosition(grid_position);
-	auto iterator = data.find(gridPos);
-	if (iterator != data.end()) {
-		out_tileInstance = const_cast<TileInstance*>(&iterator->second);
-		return true;
+size_t Tiles::TileMap::FloodFill(const Tile* tile, const glm::ivec2 grid_position, const glm::ivec2 boundsMin, const glm::ivec2 boundsMax, const size_t maxArea) {
+	using namespace glm;
+	// scanning happens in cells of GridDimensions, converted positions are multiples of it
+	const ivec2 dims = GridDimensions;
+	const ivec2 start = ConvertToTileMapGridPosition(grid_position) / dims;
+	const ivec2 minCell = ConvertToTileMapGridPosition(boundsMin) / dims;
+	const ivec2 maxCell = ConvertToTileMapGridPosition(boundsMax) / dims;
+	if (any(lessThan(start, minCell)) || any(greaterThan(start, maxCell))) return 0;
+
+	const uint16_t targetIndex = chunks.GetTileIndex(start * dims);
+	if (palette[targetIndex] == tile) return 0;
+
+	// rows are scanned left to right, so the last chunk is usually the next one
+	ivec2 cachedCoord(INT_MAX);
+	const TileChunk* cachedChunk = nullptr;
+	const auto isTarget = [&](const ivec2 cell) {
+		const ivec2 gridPos = cell * dims;
+		const ivec2 chunkCoord = TileChunkStorage::ToChunkCoord(gridPos);
+		if (chunkCoord != cachedCoord) {
+			cachedCoord = chunkCoord;
+			cachedChunk = chunks.GetChunk(chunkCoord);
+		}
+		const uint16_t index = cachedChunk != nullptr ? cachedChunk->TileIndices[TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(gridPos))] : 0;
+		return index == targetIndex;
+	};
+
+	// visited cells per chunk of cells, grows with the filled area and not with the bounds
+	std::unordered_map<ivec2, std::bitset<TileChunk::CellCount>> visited;
+	ivec2 cachedVisitedCoord(INT_MAX);
+	std::bitset<TileChunk::CellCount>* cachedVisited = nullptr;
+	const auto getVisitedCells = [&](const ivec2 chunkCoord, const bool create) {
+		if (chunkCoord != cachedVisitedCoord || (create && cachedVisited == nullptr)) {
+			cachedVisitedCoord = chunkCoord;
+			if (create) cachedVisited = &visited[chunkCoord];
+			else {
+				const auto it = visited.find(chunkCoord);
+				cachedVisited = it != visited.end() ? &it->second : nullptr;
+			}
+		}
+		return cachedVisited;
+	};
+	const auto isVisited = [&](const ivec2 cell) {
+		const auto* cells = getVisitedCells(TileChunkStorage::ToChunkCoord(cell), false);
+		return cells != nullptr && cells->test(TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(cell)));
+	};
+	const auto markVisited = [&](const ivec2 cell) {
+		getVisitedCells(TileChunkStorage::ToChunkCoord(cell), true)->set(TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(cell)));
+	};
+	const auto isOpen = [&](const int x, const int y) { return !isVisited(ivec2(x, y)) && isTarget(ivec2(x, y)); };
+
+	struct Span {
+		int Y;
+		int MinX;
+		int MaxX;
+	};
+	std::vector<Span> spans;
+	std::vector<ivec2> seeds{ start };
+	size_t area = 0;
+	while (!seeds.empty()) {
+		const ivec2 seed = seeds.back();
+		seeds.pop_back();
+		if (!isOpen(seed.x, seed.y)) continue;
+
+		Span span{ seed.y, seed.x, seed.x };
+		while (span.MinX > minCell.x && isOpen(span.MinX - 1, span.Y)) --span.MinX;
+		while (span.MaxX < maxCell.x && isOpen(span.MaxX + 1, span.Y)) ++span.MaxX;
+		for (int x = span.MinX; x <= span.MaxX; ++x) markVisited(ivec2(x, span.Y));
+
+		area += static_cast<size_t>(span.MaxX - span.MinX) + 1;
+		if (area > maxArea) {
+			std::cout << "Fill area exceeds the maximum of " << maxArea << " tiles." << std::endl;
+			return 0;
+		}
+		spans.push_back(span);
+
+		// one seed per open run in the rows above and below
+		for (const int y : { span.Y - 1, span.Y + 1 }) {
+			if (y < minCell.y || y > maxCell.y) continue;
+			bool inRun = false;
+			for (int x = span.MinX; x <= span.MaxX; ++x) {
+				const bool open = isOpen(x, y);
+				if (open && !inRun) seeds.emplace_back(x, y);
+				inRun = open;
+			}
+		}
 	}
-	out_tileInstance = nullptr;
-	return false;
+
+	BeginEdit();
+	for (const auto& span : spans) {
+		for (int x = span.MinX; x <= span.MaxX; ++x) SetTile(tile, ivec2(x, span.Y) * dims);
+	}
+	CommitEdit();
+	return area;
+}
+
+void Tiles::TileMap::CopyRegion(const glm::ivec2 boundsMin, const glm::ivec2 boundsMax, Prefab& out_region) const {
+	using namespace glm;
+	const ivec2 dims = GridDimensions;
+	const ivec2 minCell = ConvertToTileMapGridPosition(min(boundsMin, boundsMax)) / dims;
+	const ivec2 maxCell = ConvertToTileMapGridPosition(max(boundsMin, boundsMax)) / dims;
+	out_region.Reset(maxCell - minCell + 1, dims);
+
+	// tileMap palette index to region palette index
+	std::vector<uint16_t> paletteRemap(palette.size(), 0);
+	for (int y = minCell.y; y <= maxCell.y; ++y) {
+		for (int x = minCell.x; x <= maxCell.x; ++x) {
+			const ivec2 gridPos = ivec2(x, y) * dims;
+			const TileChunk* chunk = chunks.GetChunk(TileChunkStorage::ToChunkCoord(gridPos));
+			if (chunk == nullptr) continue;
+			const int cell = TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(gridPos));
+			const uint16_t tileIndex = chunk->TileIndices[cell];
+			if (tileIndex == 0) continue;
+
+			if (paletteRemap[tileIndex] == 0) {
+				paletteRemap[tileIndex] = static_cast<uint16_t>(out_region.Palette.size());
+				out_region.Palette.push_back(palette[tileIndex]);
+			}
+			const size_t regionCell = out_region.GetCellIndex(ivec2(x, y) - minCell);
+			out_region.TileIndices[regionCell] = paletteRemap[tileIndex];
+			out_region.Masks[regionCell] = chunk->Masks[cell];
+		}
+	}
+}
+
+void Tiles::TileMap::EraseRegion(const glm::ivec2 boundsMin, const glm::ivec2 boundsMax) {
+	using namespace glm;
+	const ivec2 dims = GridDimensions;
+	const ivec2 minCell = ConvertToTileMapGridPosition(min(boundsMin, boundsMax)) / dims;
+	const ivec2 maxCell = ConvertToTileMapGridPosition(max(boundsMin, boundsMax)) / dims;
+
+	BeginEdit();
+	for (int y = minCell.y; y <= maxCell.y; ++y) {
+		for (int x = minCell.x; x <= maxCell.x; ++x) RemoveTile(ivec2(x, y) * dims);
+	}
+	CommitEdit();
+}
+
+void Tiles::TileMap::PasteRegion(const Prefab& region, const glm::ivec2 grid_position) {
+	using namespace glm;
+	const ivec2 dims = GridDimensions;
+	const ivec2 origin = ConvertToTileMapGridPosition(grid_position) / dims;
+	// masks of a region copied with other grid dimensions do not match this tileMap's neighbours
+	const bool keepMasks = region.GridDimensions == GridDimensions;
+
+	// region palette index to tileMap palette index, acquired on first use
+	std::vector<uint16_t> paletteRemap(region.Palette.size(), 0);
+	ivec2 cachedCoord(INT_MAX);
+	TileChunk* cachedChunk = nullptr;
+
+	BeginEdit();
+	for (int y = 0; y < region.Size.y; ++y) {
+		for (int x = 0; x < region.Size.x; ++x) {
+			const size_t regionCell = region.GetCellIndex(ivec2(x, y));
+			const uint16_t regionIndex = region.TileIndices[regionCell];
+			const ivec2 gridPos = (origin + ivec2(x, y)) * dims;
+			const ivec2 chunkCoord = TileChunkStorage::ToChunkCoord(gridPos);
+			if (chunkCoord != cachedCoord || (cachedChunk == nullptr && regionIndex != 0)) {
+				cachedCoord = chunkCoord;
+				cachedChunk = regionIndex != 0 ? chunks.GetOrCreateChunk(chunkCoord) : chunks.GetChunk(chunkCoord);
+			}
+			TileChunk* chunk = cachedChunk;
+			if (chunk == nullptr) continue;
+
+			const int cell = TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(gridPos));
+			const uint16_t previousIndex = chunk->TileIndices[cell];
+			if (previousIndex == 0 && regionIndex == 0) continue;
+
+			uint16_t tileIndex = 0;
+			const Tile* tile = region.Palette[regionIndex];
+			if (regionIndex != 0) {
+				uint16_t& mappedIndex = paletteRemap[regionIndex];
+				if (mappedIndex == 0) mappedIndex = AcquirePaletteIndex(tile);
+				else ++paletteReferenceCounts[mappedIndex];
+				tileIndex = mappedIndex;
+			}
+			if (editHistory != nullptr && previousIndex != tileIndex) editHistory->RecordCell(gridPos, previousIndex, chunk->Masks[cell]);
+			if (previousIndex != 0) ReleasePaletteIndex(previousIndex);
+
+			chunk->TileIndices[cell] = tileIndex;
+			if (tileIndex == 0) {
+				chunk->Masks[cell] = 0;
+				chunk->Textures[cell] = nullptr;
+				// may free the chunk
+				chunks.OnTileRemoved(chunk, chunkCoord);
+				cachedCoord = ivec2(INT_MAX);
+			}
+			else {
+				const uint8_t mask = region.Masks[regionCell];
+				chunk->Masks[cell] = mask;
+				chunk->Textures[cell] = TileInstance::GetTextureFromMask(tile, static_cast<SurroundingTileFlags>(mask), gridPos);
+				if (previousIndex == 0) chunks.OnTileAdded(chunk);
+			}
+
+			const bool isBorder = x == 0 || y == 0 || x == region.Size.x - 1 || y == region.Size.y - 1;
+			if (isBorder || !keepMasks) OnTileEdited(gridPos);
+		}
+	}
+	instancesDirty = true;
+	CommitEdit();
+}
+
+size_t Tiles::TileMap::GetMemoryUsage() const {
+	return chunks.GetMemoryUsage() + palette.capacity() * sizeof(const Tile*) + (paletteReferenceCounts.capacity() + palettePinCounts.capacity()) * sizeof(int);
+}
+
+void Tiles::TileMap::GetCellState(const glm::ivec2 grid_position, uint16_t& out_tileIndex, uint8_t& out_mask) const {
+	const TileChunk* chunk = chunks.GetChunk(TileChunkStorage::ToChunkCoord(grid_position));
+	if (chunk == nullptr) {
+		out_tileIndex = 0;
+		out_mask = 0;
+		return;
+	}
+	const int cell = TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(grid_position));
+	out_tileIndex = chunk->TileIndices[cell];
+	out_mask = chunk->Masks[cell];
+}
+
+void Tiles::TileMap::ApplyCellDelta(const TileCellDelta& delta, const bool undo) {
+	const glm::ivec2 gridPos(delta.X, delta.Y);
+	const uint16_t targetIndex = undo ? delta.PreviousIndex : delta.NewIndex;
+	const auto chunkCoord = TileChunkStorage::ToChunkCoord(gridPos);
+	TileChunk* chunk = targetIndex != 0 ? chunks.GetOrCreateChunk(chunkCoord) : chunks.GetChunk(chunkCoord);
+	if (chunk == nullptr) return;
+
+	const int cell = TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(gridPos));
+	const uint16_t currentIndex = chunk->TileIndices[cell];
+	if (currentIndex == targetIndex) return;
+
+	// the history pins targetIndex, so its palette entry still holds the tile
+	if (targetIndex != 0) ++paletteReferenceCounts[targetIndex];
+	if (currentIndex != 0) ReleasePaletteIndex(currentIndex);
+	chunk->TileIndices[cell] = targetIndex;
+	chunk->Masks[cell] = undo ? delta.PreviousMask : delta.NewMask;
+
+	if (targetIndex == 0) {
+		chunk->Textures[cell] = nullptr;
+		// may free the chunk
+		chunks.OnTileRemoved(chunk, chunkCoord);
+	}
+	else if (currentIndex == 0) chunks.OnTileAdded(chunk);
+	instancesDirty = true;
+
+	OnTileEdited(gridPos);
 }
 
 glm::ivec2 Tiles::TileMap::ConvertToTileMapGridPosition(glm::ivec2 grid_position) const {
@@ -104,33 +512,117 @@ glm::ivec2 Tiles::TileMap::ConvertToTileMapGridPosition(glm::ivec2 grid_position
 	return grid_position - offset;
 }
 
-void Tiles::TileMap::Render() const {
+void Tiles::TileMap::RebuildInstances() const {
 	using namespace glm;
-	// TODO: GPU instancing and pack textures in atlas to render in one draw call as this is highly inefficient
-	for (const auto& pair : data) {
-		// offset by half in every axis
-		auto offset = vec3(floor(pair.first.x) + TileDimensions.x / 2.0f, floor(pair.first.y) + TileDimensions.y / 2.0f, 0.01);
+	std::vector<Rendering::InstanceData> instances;
+	instances.reserve(chunks.GetTileCount());
+	instanceBatches.clear();
+	renderChunks.clear();
+	visibleRanges.clear();
+
+	// instances are stored chunk by chunk so chunks can be culled, within a chunk they are grouped by GL texture.
+	// tiles with atlas regions all share their page, textureSheet slices their sheet's texture or array texture
+	std::map<Rendering::InstanceTexture, std::vector<Rendering::InstanceData>> chunkInstancesByTexture;
+	const vec2 scale = TileDimensions;
+	chunks.ForEachChunk([&](const ivec2& coord, const TileChunk& chunk) {
+		for (auto& [instanceTexture, textureInstances] : chunkInstancesByTexture) textureInstances.clear();
+
+		const ivec2 origin = coord * TileChunk::Size;
+		for (int cell = 0; cell < TileChunk::CellCount; ++cell) {
+			const Rendering::Texture* texture = chunk.Textures[cell];
+			// empty, or placed during an uncommitted edit
+			if (texture == nullptr) continue;
+			// offset by half in every axis
+			const vec2 offset = vec2(origin + TileChunk::CellPosition(cell)) + scale / 2.0f;
+
+			Rendering::AtlasRegion region;
+			unsigned int arrayTextureId;
+			int layer;
+			if (Rendering::TextureAtlas::TryGetRegion(texture->AssetId, region)) {
+				chunkInstancesByTexture[{ Rendering::TextureAtlas::GetPageTextureId(region.Page) }].push_back({ offset, scale, region.UvRect });
+			}
+			else if (texture->TryGetArrayLayer(arrayTextureId, layer)) {
+				chunkInstancesByTexture[{ arrayTextureId, true }].push_back({ offset, scale, vec4(0, 0, 1, 1), static_cast<float>(layer) });
+			}
+			else {
+				chunkInstancesByTexture[{ texture->GetTextureID() }].push_back({ offset, scale, texture->GetUvRect() });
+			}
+		}
 
-		mat4 modelM = translate(mat4(1.0f), offset);
-		if (TileDimensions != ivec2(1, 1)) {
-			modelM = scale(modelM, vec3(TileDimensions, 1));
+		RenderChunk renderChunk{
+			// tiles larger than one cell reach past the chunk border
+			AABB(vec3(vec2(origin), tileDepth), vec3(vec2(origin + TileChunk::Size - 1) + scale, tileDepth)),
+			static_cast<size_t>(chunk.TileCount), instanceBatches.size(), 0
+		};
+		for (const auto& [instanceTexture, textureInstances] : chunkInstancesByTexture) {
+			if (textureInstances.empty()) continue;
+			instanceBatches.push_back({ instanceTexture, instances.size(), textureInstances.size() });
+			instances.insert(instances.end(), textureInstances.begin(), textureInstances.end());
 		}
-		Rendering::Renderer::defaultShader->setMat4("model", modelM);
+		renderChunk.BatchCount = instanceBatches.size() - renderChunk.FirstBatch;
+		renderChunks.push_back(renderChunk);
+	});
 
-		glBindTexture(GL_TEXTURE_2D, pair.second.GetActiveTextureId());
-		Mesh::StaticMesh::GetDefaultQuad()->Draw();
+	if (instanceBuffer == nullptr) instanceBuffer = std::make_unique<Rendering::InstanceBuffer>(Mesh::StaticMesh::GetDefaultQuad());
+	instanceBuffer->Upload(instances);
+	instancesDirty = false;
+	atlasGeneration = Rendering::TextureAtlas::GetGeneration();
+	arrayGeneration = Rendering::TextureSheet::GetArrayGeneration();
+}
+
+void Tiles::TileMap::Render() const {
+	renderStats = {};
+	if (instancesDirty || atlasGeneration != Rendering::TextureAtlas::GetGeneration() || arrayGeneration != Rendering::TextureSheet::GetArrayGeneration()) {
+		RebuildInstances();
 	}
+	if (instanceBuffer->GetInstanceCount() == 0) return;
+
+	for (auto& [instanceTexture, ranges] : visibleRanges) ranges.clear();
+	const Frustum frustum = Rendering::Camera::Main->GetFrustum();
+	for (const auto& renderChunk : renderChunks) {
+		if (!frustum.Intersects(renderChunk.Bounds)) {
+			++renderStats.ChunksCulled;
+			renderStats.TilesCulled += renderChunk.TileCount;
+			continue;
+		}
+		++renderStats.ChunksDrawn;
+		renderStats.TilesDrawn += renderChunk.TileCount;
+
+		for (size_t i = renderChunk.FirstBatch; i < renderChunk.FirstBatch + renderChunk.BatchCount; ++i) {
+			const auto& batch = instanceBatches[i];
+			auto& ranges = visibleRanges[batch.Texture];
+			// visible chunks using a single texture are usually next to each other in the buffer
+			if (!ranges.empty() && ranges.back().FirstInstance + ranges.back().InstanceCount == batch.FirstInstance) {
+				ranges.back().InstanceCount += batch.InstanceCount;
+			}
+			else {
+				ranges.push_back({ batch.FirstInstance, batch.InstanceCount });
+			}
+		}
+	}
+	if (renderStats.ChunksDrawn == 0) return;
+
+	const auto& shader = Rendering::Renderer::instancedShader;
+	shader->Use();
+	shader->setFloat("depth", tileDepth);
+	for (const auto& [instanceTexture, ranges] : visibleRanges) {
+		if (ranges.empty()) continue;
+		instanceTexture.Bind();
+		instanceBuffer->Draw(ranges);
+	}
+	Rendering::Renderer::defaultShader->Use();
 }
 
 void Tiles::TileMap::RenderImGui() {
 	using namespace ImGui;
 
 	InputText("Name", &Name);
-	SliderInt2("Tile Dimensions", &TileDimensions[0], 1, 5);
+	if (SliderInt2("Tile Dimensions", &TileDimensions[0], 1, 5)) SetDirty();
 	SliderInt2("Grid Dimensions", &GridDimensions[0], 1, 5);
+	Text("Tiles: %zu, Chunks: %zu (%.2f MB)", GetTileCount(), GetChunkCount(), static_cast<double>(GetMemoryUsage()) / (1024.0 * 1024.0));
 }
 
-bool Tiles::TileMap::Deserialize(std::istream& iStream, TileMap*& out_tileMap) {
+bool Tiles::TileMap::Deserialize(std::istream& iStream, TileMap*& out_tileMap, std::vector<::AssetId>* out_missingTiles) {
 	auto tileMapUPTR = std::make_unique<TileMap>();
 	tileMapUPTR->Name = Serialization::DeserializeStdString(iStream);
 	int type = 0; Serialization::readFromStream(iStream, type);
@@ -150,8 +642,11 @@ bool Tiles::TileMap::Deserialize(std::istream& iStream, TileMap*& out_tileMap) {
 			int tileIndex = 0; Serialization::readFromStream(iStream, tileIndex);
 			Tiles::Tile* t = nullptr;
 			if (!Resources::TryGetTile(tileId, t)) {
-				std::string msg = "unable to load tile " + tileId.ToString();
-				throw std::exception(msg.c_str());
+				if (out_missingTiles == nullptr) {
+					std::cout << "Unable to load tile " << tileId.ToString() << " for tileMap: " << tileMapUPTR->Name << std::endl;
+					return false;
+				}
+				out_missingTiles->push_back(tileId);
 			}
 			tileIndexTable[tileIndex] = t;
 		}
@@ -164,51 +659,198 @@ bool Tiles::TileMap::Deserialize(std::istream& iStream, TileMap*& out_tileMap) {
 			int tileIndex = 0; Serialization::readFromStream(iStream, tileIndex);
 			int mask = 0; Serialization::readFromStream(iStream, mask);
 			const Tile* tile = tileIndexTable[tileIndex];
-			tileMapUPTR->data.emplace(position, TileInstance(tile, static_cast<SurroundingTileFlags>(mask), position));
-			++tileMapUPTR->tileReferences[tile->GetAssetId().ToString()];
+			if (tile == nullptr) continue;
+
+			TileChunk* chunk = tileMapUPTR->chunks.GetOrCreateChunk(TileChunkStorage::ToChunkCoord(position));
+			const int cell = TileChunk::CellIndex(TileChunkStorage::ToLocalPosition(position));
+			if (chunk->TileIndices[cell] != 0) continue; //duplicate entry
+
+			const auto tileMask = static_cast<SurroundingTileFlags>(mask);
+			chunk->TileIndices[cell] = tileMapUPTR->AcquirePaletteIndex(tile);
+			chunk->Masks[cell] = static_cast<uint8_t>(mask);
+			chunk->Textures[cell] = TileInstance::GetTextureFromMask(tile, tileMask, position);
+			tileMapUPTR->chunks.OnTileAdded(chunk);
 		}
 	}
 	out_tileMap = tileMapUPTR.release();
 	return true;
 }
 
-void Tiles::TileMap::Serialize(std::ostream& oStream) const {
-	Serialization::Serialize(oStream, Name);
-	int type = (int)Type; Serialization::writeToStream(oStream, type);
-	Serialization::writeToStream(oStream, GridDimensions.x);
-	Serialization::writeToStream(oStream, GridDimensions.y);
-	Serialization::writeToStream(oStream, TileDimensions.x);
-	Serialization::writeToStream(oStream, TileDimensions.y);
-
-	auto tileCount = data.size();
-	Serialization::writeToStream(oStream, tileCount);
-	if (tileCount > 0) {
-		//Build tile index table
-		auto tileRefCount = tileReferences.size();
-		if (tileRefCount < 1) throw std::exception("tile reference count is 0 when tile count is > 0");
-		Serialization::writeToStream(oStream, tileRefCount);
-		std::map<const Tile*, int> tileIndexTable;
-
-		int refIndex = 0;
-		for (auto refIt = tileReferences.begin(); refIt != tileReferences.end(); ++refIt) {
-			Tile* t = nullptr;
-			if (!Resources::TryGetTile(refIt->first, t)) {
-				std::string msg = "unable to serialize tileMap: " + Name + ": tile not found: " + refIt->first;
-				throw std::exception(msg.c_str());
+bool Tiles::TileMap::DeserializeBinary(Serialization::BinaryReader& reader, TileMap*& out_tileMap, std::vector<::AssetId>* out_missingTiles) {
+	auto tileMapUPTR = std::make_unique<TileMap>();
+	TileMap* tileMap = tileMapUPTR.get();
+	int32_t type = 0;
+	reader.ReadString32(tileMap->Name);
+	reader.Read(type);
+	reader.Read(tileMap->GridDimensions.x);
+	reader.Read(tileMap->GridDimensions.y);
+	reader.Read(tileMap->TileDimensions.x);
+	reader.Read(tileMap->TileDimensions.y);
+	tileMap->Type = static_cast<TileMapType>(type);
+
+	//Palette, file index i + 1 maps to a tileMap palette index (duplicates get merged)
+	uint32_t paletteCount = 0;
+	if (!reader.Read(paletteCount) || paletteCount > UINT16_MAX) return false;
+	std::vector<uint16_t> paletteRemap(paletteCount + 1, 0);
+	for (uint32_t i = 0; i < paletteCount; ++i) {
+		std::string tileIdString;
+		if (!reader.ReadString32(tileIdString)) return false;
+		::AssetId tileId;
+		if (!::AssetId::TryParse(tileIdString, tileId)) return false;
+		Tiles::Tile* t = nullptr;
+		if (!Resources::TryGetTile(tileId, t)) {
+			if (out_missingTiles == nullptr) {
+				std::cout << "Unable to load tile " << tileIdString << " for tileMap: " << tileMap->Name << std::endl;
+				return false;
 			}
-			tileIndexTable[t] = refIndex;
+			// cells of the missing tile stay empty
+			out_missingTiles->push_back(tileId);
+			continue;
+		}
+		if (const auto it = tileMap->paletteLookup.find(t); it != tileMap->paletteLookup.end()) {
+			paletteRemap[i + 1] = it->second;
+			continue;
+		}
+		const auto index = static_cast<uint16_t>(tileMap->palette.size());
+		tileMap->palette.push_back(t);
+		tileMap->paletteReferenceCounts.push_back(0);
+		tileMap->palettePinCounts.push_back(0);
+		tileMap->paletteLookup.emplace(t, index);
+		paletteRemap[i + 1] = index;
+	}
+	bool isIdentityRemap = true;
+	for (uint32_t i = 0; i <= paletteCount; ++i) isIdentityRemap &= paletteRemap[i] == i;
 
-			Serialization::Serialize(oStream, refIt->first);
-			Serialization::writeToStream(oStream, refIndex);
-			++refIndex;
+	//Chunk table
+	uint32_t chunkCount = 0;
+	if (!reader.Read(chunkCount)) return false;
+	// every chunk has a table entry and a tile block, a corrupt count fails here instead of allocating for it
+	constexpr size_t chunkEntryByteSize = sizeof(int32_t) * 3;
+	constexpr size_t chunkBlockByteSize = sizeof(TileChunk::TileIndices) + sizeof(TileChunk::Masks);
+	if (chunkCount > reader.GetRemaining() / (chunkEntryByteSize + chunkBlockByteSize)) return false;
+	std::vector<glm::ivec2> chunkCoords(chunkCount);
+	std::vector<int32_t> chunkTileCounts(chunkCount);
+	std::unordered_set<glm::ivec2> uniqueChunkCoords;
+	uniqueChunkCoords.reserve(chunkCount);
+	for (uint32_t i = 0; i < chunkCount; ++i) {
+		reader.Read(chunkCoords[i].x);
+		reader.Read(chunkCoords[i].y);
+		reader.Read(chunkTileCounts[i]);
+		if (!uniqueChunkCoords.insert(chunkCoords[i]).second) return false;
+	}
+	if (reader.HasFailed()) return false;
+
+	// resolved textures per palette index and mask, slots with multiple variants depend on position and are resolved per tile
+	struct CachedTexture {
+		Rendering::Texture* Texture = nullptr;
+		bool IsResolved = false;
+		bool IsPositionDependent = false;
+	};
+	std::vector<std::array<CachedTexture, 256>> textureCache(tileMap->palette.size());
+
+	//Tile blocks, decoded before their chunk is created so chunks without tiles are never stored
+	std::array<uint16_t, TileChunk::CellCount> tileIndices{};
+	std::array<uint8_t, TileChunk::CellCount> masks{};
+	for (uint32_t i = 0; i < chunkCount; ++i) {
+		if (!reader.ReadBlock(tileIndices.data(), sizeof(tileIndices))) return false;
+		if (!reader.ReadBlock(masks.data(), sizeof(masks))) return false;
+
+		int fileTileCount = 0;
+		int tileCount = 0;
+		for (uint16_t& tileIndex : tileIndices) {
+			if (tileIndex == 0) continue;
+			if (tileIndex > paletteCount) return false;
+			++fileTileCount;
+			if (!isIdentityRemap) tileIndex = paletteRemap[tileIndex];
+			if (tileIndex != 0) ++tileCount;
 		}
+		// counted before missing tiles are dropped
+		if (fileTileCount != chunkTileCounts[i]) return false;
+		if (tileCount == 0) continue;
+
+		const glm::ivec2 coord = chunkCoords[i];
+		TileChunk* chunk = tileMap->chunks.GetOrCreateChunk(coord);
+		chunk->TileIndices = tileIndices;
+		chunk->Masks = masks;
+		const glm::ivec2 origin = coord * TileChunk::Size;
+		for (int cell = 0; cell < TileChunk::CellCount; ++cell) {
+			const uint16_t tileIndex = chunk->TileIndices[cell];
+			if (tileIndex == 0) continue;
+			++tileMap->paletteReferenceCounts[tileIndex];
+
+			const uint8_t mask = chunk->Masks[cell];
+			CachedTexture& cached = textureCache[tileIndex][mask];
+			if (!cached.IsResolved) {
+				const Tile* tile = tileMap->palette[tileIndex];
+				const TileSlot* slot = tile->GetPattern()->GetTileSlot(static_cast<SurroundingTileFlags>(mask));
+				cached.IsPositionDependent = slot != nullptr && slot->TileSprites.size() > 1;
+				cached.Texture = TileInstance::GetTextureFromMask(tile, static_cast<SurroundingTileFlags>(mask), origin);
+				cached.IsResolved = true;
+			}
+			chunk->Textures[cell] = cached.IsPositionDependent
+				? TileInstance::GetTextureFromMask(tileMap->palette[tileIndex], static_cast<SurroundingTileFlags>(mask), origin + TileChunk::CellPosition(cell))
+				: cached.Texture;
+		}
+		tileMap->chunks.OnTilesAdded(chunk, tileCount);
+	}
+
+	// drop palette entries nothing refers to so they can be reused
+	for (uint16_t i = 1; i < tileMap->palette.size(); ++i) {
+		if (tileMap->paletteReferenceCounts[i] > 0) continue;
+		tileMap->paletteLookup.erase(tileMap->palette[i]);
+		tileMap->palette[i] = nullptr;
+		tileMap->freePaletteIndices.push_back(i);
+	}
+
+	out_tileMap = tileMapUPTR.release();
+	return true;
+}
+
+void Tiles::TileMap::Serialize(std::ostream& oStream) const {
+	using namespace Serialization;
+	WriteString32(oStream, Name);
+	WriteLittleEndian(oStream, static_cast<int32_t>(Type));
+	WriteLittleEndian(oStream, static_cast<int32_t>(GridDimensions.x));
+	WriteLittleEndian(oStream, static_cast<int32_t>(GridDimensions.y));
+	WriteLittleEndian(oStream, static_cast<int32_t>(TileDimensions.x));
+	WriteLittleEndian(oStream, static_cast<int32_t>(TileDimensions.y));
+
+	//Palette, compacted to the used entries
+	std::vector<uint16_t> paletteRemap(palette.size(), 0);
+	uint16_t paletteCount = 0;
+	// tiles only kept by the edit history are left out
+	for (size_t paletteIndex = 1; paletteIndex < palette.size(); ++paletteIndex) {
+		if (!IsPaletteIndexPlaced(paletteIndex)) continue;
+		paletteRemap[paletteIndex] = ++paletteCount;
+	}
+	WriteLittleEndian(oStream, static_cast<uint32_t>(paletteCount));
+	for (size_t paletteIndex = 1; paletteIndex < palette.size(); ++paletteIndex) {
+		if (!IsPaletteIndexPlaced(paletteIndex)) continue;
+		WriteString32(oStream, palette[paletteIndex]->GetAssetId().ToString());
+	}
+	bool isIdentityRemap = true;
+	for (size_t i = 1; i < paletteRemap.size(); ++i) isIdentityRemap &= !IsPaletteIndexPlaced(i) || paletteRemap[i] == i;
+
+	//Chunk table
+	WriteLittleEndian(oStream, static_cast<uint32_t>(chunks.GetChunkCount()));
+	std::vector<const TileChunk*> orderedChunks;
+	orderedChunks.reserve(chunks.GetChunkCount());
+	chunks.ForEachChunk([&](const glm::ivec2& coord, const TileChunk& chunk) {
+		WriteLittleEndian(oStream, static_cast<int32_t>(coord.x));
+		WriteLittleEndian(oStream, static_cast<int32_t>(coord.y));
+		WriteLittleEndian(oStream, static_cast<int32_t>(chunk.TileCount));
+		orderedChunks.push_back(&chunk);
+	});
 
-		//Write tile info
-		for (const auto& [pos, tileInstance] : data) {
-			Serialization::writeToStream(oStream, pos.x);
-			Serialization::writeToStream(oStream, pos.y);
-			Serialization::writeToStream(oStream, tileIndexTable[tileInstance.GetParent()]);
-			Serialization::writeToStream(oStream, static_cast<int>(tileInstance.GetMask()));
+	//Tile blocks, same order as the chunk table
+	std::array<uint16_t, TileChunk::CellCount> remappedIndices{};
+	for (const TileChunk* chunk : orderedChunks) {
+		const uint16_t* indices = chunk->TileIndices.data();
+		if (!isIdentityRemap) {
+			for (int cell = 0; cell < TileChunk::CellCount; ++cell) remappedIndices[cell] = paletteRemap[chunk->TileIndices[cell]];
+			indices = remappedIndices.data();
 		}
+		WriteBlock(oStream, indices, sizeof(chunk->TileIndices));
+		WriteBlock(oStream, chunk->Masks.data(), sizeof(chunk->Masks));
 	}
 }
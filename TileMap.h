@@ -7,9 +7,14 @@
 #include "Renderable.h"
 #include "TileMap.h"
 #include "TileInstance.h"
+#include "TileChunk.h"
+#include "InstanceBuffer.h"
+#include "MathExt.h"
 #include <map>
+#include <vector>
 
 #include "Assets.h"
+#include "BinaryFormat.h"
 
 namespace Rendering {
 	class Shader;
@@ -17,6 +22,9 @@ namespace Rendering {
 
 namespace Tiles {
 	class Tile;
+	class TileEditHistory;
+	struct TileCellDelta;
+	class Prefab;
 
 
 	//TODO: display a warning/hint when selecting a tile that does not match tilemap type?
@@ -27,17 +35,119 @@ namespace Tiles {
 		Ceiling
 	};
 
-	class TileMap : public Rendering::Renderable, public Serialization::Serializable<TileMap> {
-		std::unordered_map<glm::ivec2, TileInstance> data{};
-		std::map<std::string, int> tileReferences{};
+	// Per frame culling counts
+	struct TileMapRenderStats {
+		size_t ChunksDrawn = 0;
+		size_t ChunksCulled = 0;
+		size_t TilesDrawn = 0;
+		size_t TilesCulled = 0;
+
+		TileMapRenderStats& operator+=(const TileMapRenderStats& other) {
+			ChunksDrawn += other.ChunksDrawn;
+			ChunksCulled += other.ChunksCulled;
+			TilesDrawn += other.TilesDrawn;
+			TilesCulled += other.TilesCulled;
+			return *this;
+		}
+	};
 
+	class TileMap : public Rendering::Renderable, public Serialization::Serializable<TileMap> {
+		TileChunkStorage chunks{};
+
+		// Tiles used by this tileMap, chunks store index into palette. Index 0 is reserved for empty cells.
+		std::vector<const Tile*> palette{ nullptr };
+		std::vector<int> paletteReferenceCounts{ 0 };
+		// references held by the edit history, included in paletteReferenceCounts
+		std::vector<int> palettePinCounts{ 0 };
+		std::unordered_map<const Tile*, uint16_t> paletteLookup{};
+		std::vector<uint16_t> freePaletteIndices{};
+
+		uint16_t AcquirePaletteIndex(const Tile* tile);
+		void ReleasePaletteIndex(uint16_t index);
+
+		struct InstanceBatch {
+			Rendering::InstanceTexture Texture;
+			size_t FirstInstance;
+			size_t InstanceCount;
+		};
+
+		// Instances of one chunk, its batches are contiguous in instanceBatches
+		struct RenderChunk {
+			AABB Bounds;
+			size_t TileCount;
+			size_t FirstBatch;
+			size_t BatchCount;
+		};
+
+		// Instance data is only rebuilt when tiles or dimensions change
+		mutable std::unique_ptr<Rendering::InstanceBuffer> instanceBuffer;
+		mutable std::vector<InstanceBatch> instanceBatches;
+		mutable std::vector<RenderChunk> renderChunks;
+		// ranges of chunks passing the frustum test, per GL texture. Kept to reuse allocations between frames
+		mutable std::map<Rendering::InstanceTexture, std::vector<Rendering::InstanceRange>> visibleRanges;
+		mutable TileMapRenderStats renderStats{};
+		mutable bool instancesDirty = true;
+		mutable unsigned int atlasGeneration = 0;
+		mutable unsigned int arrayGeneration = 0;
+
+		void RebuildInstances() const;
+
+		bool HasSameTileAtPos(glm::ivec2 position, uint16_t tileIndex) const;
+		SurroundingTileFlags GetMaskFromSurroundingTiles(const TileChunk* chunk, glm::ivec2 local, glm::ivec2 position, uint16_t tileIndex) const;
+		void RefreshTile(TileChunk* chunk, int cell, glm::ivec2 position) const;
 		void RefreshSurroundingTileInstances(const glm::ivec2 position);
-		void ReduceTileReferences(const Tile* tile);
+
+		// Grid positions changed since BeginEdit, refreshed together on CommitEdit
+		int editDepth = 0;
+		std::vector<glm::ivec2> editedPositions{};
+		void OnTileEdited(glm::ivec2 grid_position);
+		void RefreshEditedTiles();
+
+		// records cell changes while a stroke is in progress
+		TileEditHistory* editHistory = nullptr;
+		bool IsPaletteIndexPlaced(size_t index) const { return palette[index] != nullptr && paletteReferenceCounts[index] > palettePinCounts[index]; }
 	public:
 		void SetTile(const Tile* tile, glm::ivec2 grid_position);
 		void RemoveTile(glm::ivec2 grid_position);
-		bool TryGetTile(glm::ivec2 grid_position, TileInstance*& out_tileInstance);
-		bool TryGetTile(const glm::ivec2 grid_position, TileInstance*& out_tileInstance) const;
+
+		// Edits between BeginEdit and CommitEdit defer autotiling, CommitEdit refreshes every affected tile exactly once.
+		// Calls can be nested, only the outermost CommitEdit refreshes. Masks and textures are stale until then.
+		void BeginEdit() { ++editDepth; }
+		void CommitEdit();
+		// Resolves mask and texture of every placed tile again, after the tiles or their textures were reloaded
+		void RefreshAllTiles();
+		bool TryGetTile(glm::ivec2 grid_position, TileInstance& out_tileInstance) const;
+
+		// Scanline flood fill of the empty or same tile region connected to grid_position, clipped to the inclusive bounds.
+		// Applied as one batched edit. Returns the number of filled tiles, nothing is filled if the region exceeds maxArea.
+		size_t FloodFill(const Tile* tile, glm::ivec2 grid_position, glm::ivec2 boundsMin, glm::ivec2 boundsMax, size_t maxArea);
+
+		// Region functions take inclusive grid position bounds
+		void CopyRegion(glm::ivec2 boundsMin, glm::ivec2 boundsMax, Prefab& out_region) const;
+		void EraseRegion(glm::ivec2 boundsMin, glm::ivec2 boundsMax);
+		// Writes every cell of the region, empty ones included, with grid_position as its bottom left corner.
+		// Masks are taken from the region, so only its border is autotiled again.
+		void PasteRegion(const Prefab& region, glm::ivec2 grid_position);
+
+		size_t GetTileCount() const { return chunks.GetTileCount(); }
+		size_t GetChunkCount() const { return chunks.GetChunkCount(); }
+		size_t GetMemoryUsage() const;
+
+		// Used by TileEditHistory. Pinned palette indices keep their tile while no cell uses it.
+		void SetEditHistory(TileEditHistory* history) { editHistory = history; }
+		void PinPaletteIndex(uint16_t index);
+		void UnpinPaletteIndex(uint16_t index);
+		void GetCellState(glm::ivec2 grid_position, uint16_t& out_tileIndex, uint8_t& out_mask) const;
+		// Sets the cell to the delta's previous (undo) or new state, call between BeginEdit and CommitEdit
+		void ApplyCellDelta(const TileCellDelta& delta, bool undo);
+
+		// func(const Tile* tile, int referenceCount) for every tile placed in this tileMap
+		template<typename Func>
+		void ForEachReferencedTile(Func&& func) const {
+			for (size_t i = 1; i < palette.size(); ++i) {
+				if (IsPaletteIndexPlaced(i)) func(palette[i], paletteReferenceCounts[i] - palettePinCounts[i]);
+			}
+		}
 
 		glm::ivec2 ConvertToTileMapGridPosition(glm::ivec2 grid_position) const;
 
@@ -48,11 +158,20 @@ namespace Tiles {
 		TileMap() : TileMap("") { }
 		explicit TileMap(std::string name, TileMapType type = TileMapType::Any, glm::ivec2 tileDimensions = glm::ivec2(1,1), glm::ivec2 gridDimensions = glm::ivec2(1,1)) : Serializable(name), Type(type), GridDimensions(gridDimensions), TileDimensions(tileDimensions) { }
 
+		// Draws the chunks overlapping the main camera's view frustum
 		void Render() const override;
+		// Counts of the last Render call
+		const TileMapRenderStats& GetRenderStats() const { return renderStats; }
+		void SetDirty() { instancesDirty = true; }
 
 		void RenderImGui();
 
-		static bool Deserialize(std::istream& iStream, TileMap*& out_tileMap);
+		// Tiles missing from Resources fail the load. If out_missingTiles is given, their ids are added to it instead
+		// and their cells are left empty.
+		// Per tile format of levels before the binary level format, only used to migrate them
+		static bool Deserialize(std::istream& iStream, TileMap*& out_tileMap, std::vector<::AssetId>* out_missingTiles = nullptr);
+		static bool DeserializeBinary(Serialization::BinaryReader& reader, TileMap*& out_tileMap, std::vector<::AssetId>* out_missingTiles = nullptr);
+		// Writes the chunked binary format, layout is described in Level.h
 		void Serialize(std::ostream& oStream) const override;
 	};
 
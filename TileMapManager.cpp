@@ -5,6 +5,7 @@
 #include "GridToolBar.h"
 #include "Input.h"
 #include "Mesh.h"
+#include "Profiler.h"
 #include "Renderer.h"
 #include "Shader.h"
 
@@ -16,7 +17,7 @@ void Tiles::TileMapManager::RenderImGuiWindow() {
 	static bool tileMapWindowOpen = true;
 	const auto main_viewport = GetMainViewport();
 
-	SetNextWindowSize(ImVec2(300, 200), ImGuiCond_Once);
+	SetNextWindowSize(ImVec2(300, 240), ImGuiCond_Once);
 	PushStyleVar(ImGuiStyleVar_WindowMinSize, ImVec2(200, 200));
 	if (Begin("TileMaps", &tileMapWindowOpen, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoMove)) {
 		ImGuiHelper::TextCentered("Active TileMap");
@@ -114,6 +115,7 @@ void Tiles::TileMapManager::RenderImGuiWindow() {
 			auto it = tileMaps.begin() + deleteIndex;
 			if (it != tileMaps.end()) {
 				bool isActiveTileMap = activeTileMap == *it;
+				EditHistory.RemoveTileMap(*it);
 				delete* it;
 				tileMaps.erase(it);
 				if (isActiveTileMap) {
@@ -127,13 +129,23 @@ void Tiles::TileMapManager::RenderImGuiWindow() {
 		if (Button("Add TileMap")) {
 			tileMaps.push_back(new TileMap("New TileMap"));
 		}
+
+		Text("Chunks drawn: %zu culled: %zu", FrameStats.ChunksDrawn, FrameStats.ChunksCulled);
+		Text("Tiles drawn: %zu culled: %zu", FrameStats.TilesDrawn, FrameStats.TilesCulled);
 	}
 	End();
 	PopStyleVar();
 }
 
 void Tiles::TileMapManager::Render() const {
-	for (const auto& tileMap : tileMaps) if (tileMap->renderingEnabled) tileMap->Render();
+	PROFILE_GPU_SCOPE("TileMapManager::Render");
+	FrameStats = {};
+	for (const auto& tileMap : tileMaps) {
+		if (!tileMap->renderingEnabled) continue;
+		tileMap->Render();
+		FrameStats += tileMap->GetRenderStats();
+	}
+	if (gridToolBar != nullptr) gridToolBar->Preview.Render();
 
 	// render grid
 	if (!Rendering::Renderer::DrawGrid) return;
@@ -2,6 +2,7 @@
 #include <vector>
 
 #include "TileMap.h"
+#include "TileEditHistory.h"
 
 namespace GridTools {
 	class GridToolBar;
@@ -21,11 +22,20 @@ namespace Tiles {
 
 		bool autoSelectTileMapOnTileSelect = false;
 
+		TileEditHistory EditHistory;
+
+		// Summed over all visible tileMaps during the last Render call
+		mutable TileMapRenderStats FrameStats{};
+
 		void RenderImGuiWindow();
 
 		void Render() const override;
 
 		void SetActiveTileMap(TileMap* tileMap);
+		// See TileMap::RefreshAllTiles
+		void RefreshAllTiles() const {
+			for (const auto& tileMap : tileMaps) tileMap->RefreshAllTiles();
+		}
 
 		~TileMapManager() override {
 			for (const auto& tm : tileMaps) {
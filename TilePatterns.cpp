@@ -4,33 +4,173 @@
 #include "Texture.h"
 
 
-int hasFlag(const Tiles::SurroundingTileFlags& mask, const Tiles::SurroundingTileFlags& flag) {
-	const int iFlag = static_cast<int>(flag);
-	return (static_cast<int>(mask) & iFlag) == iFlag;
-}
+namespace {
+	using Tiles::SurroundingTileFlags;
+	using Tiles::AutoTilePatternFlag;
+	using Tiles::AutoWallPatternFlag;
+
+	constexpr int hasFlag(const SurroundingTileFlags& mask, const SurroundingTileFlags& flag) {
+		const int iFlag = static_cast<int>(flag);
+		return (static_cast<int>(mask) & iFlag) == iFlag;
+	}
 
+	// Rules the lookup tables are generated from, only evaluated at compile time
+	constexpr AutoWallPatternFlag ComputeWallPattern(const SurroundingTileFlags& mask) {
+		const bool hasLeft = hasFlag(mask, SurroundingTileFlags::LEFT);
+		const bool hasRight = hasFlag(mask, SurroundingTileFlags::RIGHT);
 
-const Tiles::TileSlot* Tiles::AutoTilePattern::GetTileSlot(const SurroundingTileFlags& mask) const {
-	const auto pattern = PatternFromSurroundingTiles(mask);
+		if(hasLeft && hasRight) {
+			return AutoWallPatternFlag::CENTER;
+		}
+
+		if(hasLeft && !hasRight) {
+			return AutoWallPatternFlag::RIGHT;
+		}
+
+		if(hasRight && !hasLeft) {
+			return AutoWallPatternFlag::LEFT;
+		}
+
+		return AutoWallPatternFlag::SOLO;
+	}
+
+	constexpr AutoTilePatternFlag ComputeAutoTilePattern(const SurroundingTileFlags& mask) {
+		const int straightSum = hasFlag(mask, SurroundingTileFlags::LEFT) +
+			hasFlag(mask, SurroundingTileFlags::RIGHT) +
+			hasFlag(mask, SurroundingTileFlags::UP) +
+			hasFlag(mask, SurroundingTileFlags::DOWN);
+
+		const int diagonalSum = hasFlag(mask, SurroundingTileFlags::UP_LEFT) +
+			hasFlag(mask, SurroundingTileFlags::UP_RIGHT) +
+			hasFlag(mask, SurroundingTileFlags::DOWN_LEFT) +
+			hasFlag(mask, SurroundingTileFlags::DOWN_RIGHT);
+
+		//Singles/Horizontals
+		if (straightSum + diagonalSum == 0) return AutoTilePatternFlag::SOLO;
+
+		if (straightSum == 1) {
+			if (hasFlag(mask, SurroundingTileFlags::RIGHT)) return AutoTilePatternFlag::SINGLE_LEFT;
+			if (hasFlag(mask, SurroundingTileFlags::LEFT)) return AutoTilePatternFlag::SINGLE_RIGHT;
+			if (hasFlag(mask, SurroundingTileFlags::DOWN)) return AutoTilePatternFlag::SINGLE_TOP;
+			if (hasFlag(mask, SurroundingTileFlags::UP)) return AutoTilePatternFlag::SINGLE_BOT;
+		}
+
+		if (straightSum == 2) {
+			if (hasFlag(mask, SurroundingTileFlags::LEFT) && hasFlag(mask, SurroundingTileFlags::RIGHT)) return AutoTilePatternFlag::HORIZONTAL_MIDDLE;
+			if (hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::DOWN)) return AutoTilePatternFlag::VERTICAL_MIDDLE;
+		}
+
+		//TOP LEFT
+		if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::DOWN)
+			&& !hasFlag(mask, SurroundingTileFlags::UP) && !hasFlag(mask, SurroundingTileFlags::LEFT)) {
+			return AutoTilePatternFlag::OUTER_TOP_LEFT;
+		}
+
+		//TOP RIGHT
+		if (!hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::DOWN)
+			&& !hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::LEFT)) {
+			return AutoTilePatternFlag::OUTER_TOP_RIGHT;
+		}
+		//RIGHT_CENTER
+		if (!hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::DOWN)
+			&& hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::LEFT)) {
+			return AutoTilePatternFlag::OUTER_MID_RIGHT;
+		}
+		//LEFT_CENTER
+		if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::DOWN)
+			&& hasFlag(mask, SurroundingTileFlags::UP) && !hasFlag(mask, SurroundingTileFlags::LEFT)) {
+			return AutoTilePatternFlag::OUTER_MID_LEFT;
+		}
+		//TOP_CENTER
+		if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::DOWN)
+			&& !hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::LEFT)) {
+			return AutoTilePatternFlag::OUTER_TOP_MID;
+		}
+		//BOTTOM_LEFT
+		if (hasFlag(mask, SurroundingTileFlags::RIGHT) && !hasFlag(mask, SurroundingTileFlags::DOWN)
+			&& hasFlag(mask, SurroundingTileFlags::UP) && !hasFlag(mask, SurroundingTileFlags::LEFT)) {
+			return AutoTilePatternFlag::OUTER_BOT_LEFT;
+		}
+		//BOTTOM_RIGHT
+		if (!hasFlag(mask, SurroundingTileFlags::RIGHT) && !hasFlag(mask, SurroundingTileFlags::DOWN)
+			&& hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::LEFT)) {
+			return AutoTilePatternFlag::OUTER_BOT_RIGHT;
+		}
+		//BOTTOM_CENTER
+		if (hasFlag(mask, SurroundingTileFlags::RIGHT) && !hasFlag(mask, SurroundingTileFlags::DOWN)
+			&& hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::LEFT)) {
+			return AutoTilePatternFlag::OUTER_BOT_MID;
+		}
+		//BOTTOM_LEFT_INVERSE
+		if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::UP)
+			&& hasFlag(mask, SurroundingTileFlags::LEFT) && !hasFlag(mask, SurroundingTileFlags::UP_RIGHT) && diagonalSum >= 3) {
+			return AutoTilePatternFlag::INNER_BOT_LEFT;
+		}
+		//BOTTOM_RIGHT_INVERSE
+		if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::UP)
+			&& hasFlag(mask, SurroundingTileFlags::LEFT) && !hasFlag(mask, SurroundingTileFlags::UP_LEFT) && diagonalSum >= 3) {
+			return AutoTilePatternFlag::INNER_BOT_RIGHT;
+		}
+		//TOP_LEFT_INVERSE
+		if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::UP)
+			&& hasFlag(mask, SurroundingTileFlags::LEFT) &&
+			!hasFlag(mask, SurroundingTileFlags::DOWN_RIGHT) && diagonalSum >= 3) {
+			return AutoTilePatternFlag::INNER_TOP_LEFT;
+		}
+		//TOP_RIGHT_INVERSE
+		if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::UP)
+			&& hasFlag(mask, SurroundingTileFlags::LEFT) &&
+			!hasFlag(mask, SurroundingTileFlags::DOWN_LEFT) && diagonalSum >= 3) {
+			return AutoTilePatternFlag::INNER_TOP_RIGHT;
+		}
+
+		return AutoTilePatternFlag::CENTER;
+	}
+
+	template<typename PatternFlag, PatternFlag(*Compute)(const SurroundingTileFlags&)>
+	constexpr std::array<PatternFlag, 256> BuildPatternTable() {
+		std::array<PatternFlag, 256> table{};
+		for (int mask = 0; mask < 256; ++mask) {
+			table[mask] = Compute(static_cast<SurroundingTileFlags>(mask));
+		}
+		return table;
+	}
+
+	constexpr auto autoTilePatternTable = BuildPatternTable<AutoTilePatternFlag, ComputeAutoTilePattern>();
+	constexpr auto autoWallPatternTable = BuildPatternTable<AutoWallPatternFlag, ComputeWallPattern>();
+
+	constexpr auto allSurrounding = static_cast<SurroundingTileFlags>(0xFF);
+	constexpr auto allStraight = SurroundingTileFlags::UP | SurroundingTileFlags::RIGHT | SurroundingTileFlags::DOWN | SurroundingTileFlags::LEFT;
+
+	static_assert(autoTilePatternTable[0] == AutoTilePatternFlag::SOLO);
+	static_assert(autoTilePatternTable[static_cast<int>(allSurrounding)] == AutoTilePatternFlag::CENTER);
+	static_assert(autoTilePatternTable[static_cast<int>(SurroundingTileFlags::RIGHT)] == AutoTilePatternFlag::SINGLE_LEFT);
+	static_assert(autoTilePatternTable[static_cast<int>(SurroundingTileFlags::RIGHT | SurroundingTileFlags::DOWN | SurroundingTileFlags::DOWN_RIGHT)] == AutoTilePatternFlag::OUTER_TOP_LEFT);
+	static_assert(autoTilePatternTable[static_cast<int>(allStraight | SurroundingTileFlags::UP_LEFT | SurroundingTileFlags::DOWN_LEFT | SurroundingTileFlags::DOWN_RIGHT)] == AutoTilePatternFlag::INNER_BOT_LEFT);
+	static_assert(autoWallPatternTable[0] == AutoWallPatternFlag::SOLO);
+	static_assert(autoWallPatternTable[static_cast<int>(SurroundingTileFlags::LEFT | SurroundingTileFlags::RIGHT)] == AutoWallPatternFlag::CENTER);
+	static_assert(autoWallPatternTable[static_cast<int>(SurroundingTileFlags::LEFT)] == AutoWallPatternFlag::RIGHT);
+}
 
-	const auto it = TileSlots.find(pattern);
-	if (it != TileSlots.end()) return &it->second;
 
-	return nullptr;
+Tiles::AutoTilePatternFlag Tiles::AutoTilePattern::PatternFromSurroundingTiles(const SurroundingTileFlags& mask) {
+	return autoTilePatternTable[static_cast<uint8_t>(mask)];
+}
+
+const Tiles::TileSlot* Tiles::AutoTilePattern::GetTileSlot(const SurroundingTileFlags& mask) const {
+	const TileSlot& slot = TileSlots[static_cast<size_t>(PatternFromSurroundingTiles(mask))];
+	return slot.TileSprites.empty() ? nullptr : &slot;
 }
 
 void DrawTileSlotButton(Tiles::TileSlot* tileSlot, const char* description, int pattern, std::function<void(Rendering::Texture*)> onDropTexture, ImVec2 size = ImVec2(32, 32)) {
 	using namespace ImGui;
-	unsigned int texId = 0;
 	Rendering::Texture* tex = nullptr;
 
-	if (tileSlot != nullptr) {
-		if (!tileSlot->TileSprites.empty() && Resources::TryGetTexture(tileSlot->TileSprites.back().TextureId, tex)) {
-			texId = tex->GetTextureID();
-		}
+	if (tileSlot != nullptr && !tileSlot->TileSprites.empty()) {
+		Resources::TryGetTexture(tileSlot->TileSprites.back().TextureId, tex);
 	}
 	std::string id = "ImageId" + std::to_string(pattern);
-	ImGuiHelper::Image(texId, size, id.c_str());
+	ImGuiHelper::Image(tex != nullptr ? tex : Rendering::Texture::Empty(), size, id.c_str());
 	ImGuiHelper::DropTargetTexture(onDropTexture);
 	ImGuiHelper::DragSourceTexture(tex);
 
@@ -47,12 +187,10 @@ void DrawTileSlotButton(Tiles::TileSlot* tileSlot, const char* description, int
 	int index = 0;
 	for (auto it = tileSlot->TileSprites.begin(); it != tileSlot->TileSprites.end();) {
 		if (index++ % squareRoot != 0) ImGui::SameLine();
-		unsigned int textureId = 0;
 		Rendering::Texture* variantTex = nullptr;
-		if (Resources::TryGetTexture(it->TextureId, variantTex))
-			textureId = variantTex->GetTextureID();
+		Resources::TryGetTexture(it->TextureId, variantTex);
 
-		ImGuiHelper::Image(textureId);
+		ImGuiHelper::Image(variantTex);
 		ImGuiHelper::DragSourceTexture(variantTex);
 		bool removed = false;
 		//when hovered, display tooltip and allow deletion with "X" key
@@ -76,9 +214,7 @@ void DrawTileSlotButton(Tiles::TileSlot* tileSlot, const char* description, int
 void Tiles::AutoTilePattern::RenderDearImGui() {
 	using namespace ImGui;
 	auto wrapDrawTileSlotButton = [this](const AutoTilePatternFlag& pattern, const char* description) {
-		TileSlot* tileSlot = nullptr;
-		if (auto it = this->TileSlots.find(pattern); it != TileSlots.end())
-			tileSlot = &it->second;
+		TileSlot* tileSlot = &TileSlots[static_cast<size_t>(pattern)];
 
 		DrawTileSlotButton(tileSlot, description, (int)pattern,
 						   [this, &pattern](Rendering::Texture* t) {
@@ -121,9 +257,7 @@ void Tiles::SimpleTilePattern::RenderDearImGui() {
 
 void Tiles::AutoWallPattern::RenderDearImGui() {
 	auto wrapDrawTileSlotButton = [this](const AutoWallPatternFlag& pattern, const char* description) {
-		TileSlot* tileSlot = nullptr;
-		if (auto it = this->TileSlots.find(pattern); it != TileSlots.end())
-			tileSlot = &it->second;
+		TileSlot* tileSlot = &TileSlots[static_cast<size_t>(pattern)];
 
 		DrawTileSlotButton(tileSlot, description, (int)pattern,
 						   [this, &pattern](Rendering::Texture* t) {
@@ -143,125 +277,10 @@ void Tiles::AutoWallPattern::RenderDearImGui() {
 }
 
 Tiles::AutoWallPatternFlag Tiles::AutoWallPattern::PatternFromSurroundingTiles(const SurroundingTileFlags& mask) {
-	const bool hasLeft = hasFlag(mask, SurroundingTileFlags::LEFT);
-	const bool hasRight = hasFlag(mask, SurroundingTileFlags::RIGHT);
-
-	if(hasLeft && hasRight) {
-		return AutoWallPatternFlag::CENTER;
-	}
-
-	if(hasLeft && !hasRight) {
-		return AutoWallPatternFlag::RIGHT;
-	}
-
-	if(hasRight && !hasLeft) {
-		return AutoWallPatternFlag::LEFT;
-	}
-
-	return AutoWallPatternFlag::SOLO;
+	return autoWallPatternTable[static_cast<uint8_t>(mask)];
 }
 
 const Tiles::TileSlot* Tiles::AutoWallPattern::GetTileSlot(const SurroundingTileFlags& mask) const {
-
-	const auto pattern = PatternFromSurroundingTiles(mask);
-
-	const auto it = TileSlots.find(pattern);
-	if (it != TileSlots.end()) return &it->second;
-
-	return nullptr;
-	
-}
-
-
-Tiles::AutoTilePatternFlag Tiles::AutoTilePattern::PatternFromSurroundingTiles(const SurroundingTileFlags& mask) {
-	const int straightSum = hasFlag(mask, SurroundingTileFlags::LEFT) +
-		hasFlag(mask, SurroundingTileFlags::RIGHT) +
-		hasFlag(mask, SurroundingTileFlags::UP) +
-		hasFlag(mask, SurroundingTileFlags::DOWN);
-
-	const int diagonalSum = hasFlag(mask, SurroundingTileFlags::UP_LEFT) +
-		hasFlag(mask, SurroundingTileFlags::UP_RIGHT) +
-		hasFlag(mask, SurroundingTileFlags::DOWN_LEFT) +
-		hasFlag(mask, SurroundingTileFlags::DOWN_RIGHT);
-
-	//Singles/Horizontals
-	if (straightSum + diagonalSum == 0) return AutoTilePatternFlag::SOLO;
-
-	if (straightSum == 1) {
-		if (hasFlag(mask, SurroundingTileFlags::RIGHT)) return AutoTilePatternFlag::SINGLE_LEFT;
-		if (hasFlag(mask, SurroundingTileFlags::LEFT)) return AutoTilePatternFlag::SINGLE_RIGHT;
-		if (hasFlag(mask, SurroundingTileFlags::DOWN)) return AutoTilePatternFlag::SINGLE_TOP;
-		if (hasFlag(mask, SurroundingTileFlags::UP)) return AutoTilePatternFlag::SINGLE_BOT;
-	}
-
-	if (straightSum == 2) {
-		if (hasFlag(mask, SurroundingTileFlags::LEFT) && hasFlag(mask, SurroundingTileFlags::RIGHT)) return AutoTilePatternFlag::HORIZONTAL_MIDDLE;
-		if (hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::DOWN)) return AutoTilePatternFlag::VERTICAL_MIDDLE;
-	}
-
-	//TOP LEFT
-	if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::DOWN)
-		&& !hasFlag(mask, SurroundingTileFlags::UP) && !hasFlag(mask, SurroundingTileFlags::LEFT)) {
-		return AutoTilePatternFlag::OUTER_TOP_LEFT;
-	}
-
-	//TOP RIGHT
-	if (!hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::DOWN)
-		&& !hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::LEFT)) {
-		return AutoTilePatternFlag::OUTER_TOP_RIGHT;
-	}
-	//RIGHT_CENTER
-	if (!hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::DOWN)
-		&& hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::LEFT)) {
-		return AutoTilePatternFlag::OUTER_MID_RIGHT;
-	}
-	//LEFT_CENTER
-	if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::DOWN)
-		&& hasFlag(mask, SurroundingTileFlags::UP) && !hasFlag(mask, SurroundingTileFlags::LEFT)) {
-		return AutoTilePatternFlag::OUTER_MID_LEFT;
-	}
-	//TOP_CENTER
-	if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::DOWN)
-		&& !hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::LEFT)) {
-		return AutoTilePatternFlag::OUTER_TOP_MID;
-	}
-	//BOTTOM_LEFT
-	if (hasFlag(mask, SurroundingTileFlags::RIGHT) && !hasFlag(mask, SurroundingTileFlags::DOWN)
-		&& hasFlag(mask, SurroundingTileFlags::UP) && !hasFlag(mask, SurroundingTileFlags::LEFT)) {
-		return AutoTilePatternFlag::OUTER_BOT_LEFT;
-	}
-	//BOTTOM_RIGHT
-	if (!hasFlag(mask, SurroundingTileFlags::RIGHT) && !hasFlag(mask, SurroundingTileFlags::DOWN)
-		&& hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::LEFT)) {
-		return AutoTilePatternFlag::OUTER_BOT_RIGHT;
-	}
-	//BOTTOM_CENTER
-	if (hasFlag(mask, SurroundingTileFlags::RIGHT) && !hasFlag(mask, SurroundingTileFlags::DOWN)
-		&& hasFlag(mask, SurroundingTileFlags::UP) && hasFlag(mask, SurroundingTileFlags::LEFT)) {
-		return AutoTilePatternFlag::OUTER_BOT_MID;
-	}
-	//BOTTOM_LEFT_INVERSE
-	if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::UP)
-		&& hasFlag(mask, SurroundingTileFlags::LEFT) && !hasFlag(mask, SurroundingTileFlags::UP_RIGHT) && diagonalSum >= 3) {
-		return AutoTilePatternFlag::INNER_BOT_LEFT;
-	}
-	//BOTTOM_RIGHT_INVERSE
-	if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::UP)
-		&& hasFlag(mask, SurroundingTileFlags::LEFT) && !hasFlag(mask, SurroundingTileFlags::UP_LEFT) && diagonalSum >= 3) {
-		return AutoTilePatternFlag::INNER_BOT_RIGHT;
-	}
-	//TOP_LEFT_INVERSE
-	if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::UP)
-		&& hasFlag(mask, SurroundingTileFlags::LEFT) &&
-		!hasFlag(mask, SurroundingTileFlags::DOWN_RIGHT) && diagonalSum >= 3) {
-		return AutoTilePatternFlag::INNER_TOP_LEFT;
-	}
-	//TOP_RIGHT_INVERSE
-	if (hasFlag(mask, SurroundingTileFlags::RIGHT) && hasFlag(mask, SurroundingTileFlags::UP)
-		&& hasFlag(mask, SurroundingTileFlags::LEFT) &&
-		!hasFlag(mask, SurroundingTileFlags::DOWN_LEFT) && diagonalSum >= 3) {
-		return AutoTilePatternFlag::INNER_TOP_RIGHT;
-	}
-
-	return AutoTilePatternFlag::CENTER;
+	const TileSlot& slot = TileSlots[static_cast<size_t>(PatternFromSurroundingTiles(mask))];
+	return slot.TileSprites.empty() ? nullptr : &slot;
 }
@@ -1,6 +1,8 @@
 #pragma once
+#include <array>
+#include <functional>
+#include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "AssetId.h"
@@ -19,7 +21,7 @@ namespace Tiles {
 		UP_LEFT = 1 << 7
 	};
 
-	inline SurroundingTileFlags operator|(SurroundingTileFlags a, SurroundingTileFlags b) {
+	constexpr SurroundingTileFlags operator|(SurroundingTileFlags a, SurroundingTileFlags b) {
 		return static_cast<SurroundingTileFlags>(static_cast<int>(a) | static_cast<int>(b));
 	}
 
@@ -58,6 +60,10 @@ namespace Tiles {
 		RIGHT
 	};
 
+	// Slot arrays are indexed by flag value, index 0 stays unused
+	constexpr size_t AutoTilePatternSlotCount = static_cast<size_t>(AutoTilePatternFlag::VERTICAL_MIDDLE) + 1;
+	constexpr size_t AutoWallPatternSlotCount = static_cast<size_t>(AutoWallPatternFlag::RIGHT) + 1;
+
 	struct TextureVariant {
 		AssetId TextureId;
 		float ProbabilityModifier;
@@ -78,16 +84,18 @@ namespace Tiles {
 		virtual const TileSlot* GetTileSlot(const SurroundingTileFlags& mask) const = 0;
 		virtual std::unique_ptr<ITilePattern> Clone() const = 0;
 		virtual uint8_t GetTypeByte() const = 0;
+		virtual void ForEachTileSlot(const std::function<void(const TileSlot&)>& func) const = 0;
 	};
 
 	class AutoTilePattern : public ITilePattern {
 	public:
-		std::unordered_map<AutoTilePatternFlag, TileSlot> TileSlots;
+		std::array<TileSlot, AutoTilePatternSlotCount> TileSlots;
 
 		void AddTextureVariant(int flag, TextureVariant variant) override {
-			TileSlots[static_cast<AutoTilePatternFlag>(flag)].TileSprites.emplace_back(std::move(variant));
+			TileSlots[flag].TileSprites.emplace_back(std::move(variant));
 		}
 
+		// Lookup into a table generated at compile time for all 256 masks
 		static AutoTilePatternFlag PatternFromSurroundingTiles(const SurroundingTileFlags& mask);
 
 		const TileSlot* GetTileSlot(const SurroundingTileFlags& mask) const override;
@@ -101,6 +109,10 @@ namespace Tiles {
 		uint8_t GetTypeByte() const override {
 			return 2;
 		}
+
+		void ForEachTileSlot(const std::function<void(const TileSlot&)>& func) const override {
+			for (const auto& slot : TileSlots) func(slot);
+		}
 	};
 
 	class SimpleTilePattern : public ITilePattern {
@@ -123,25 +135,34 @@ namespace Tiles {
 		uint8_t GetTypeByte() const override {
 			return 1;
 		}
+
+		void ForEachTileSlot(const std::function<void(const TileSlot&)>& func) const override {
+			func(tileSlot);
+		}
 	};
 
 	class AutoWallPattern : public ITilePattern {
 	public:
-		std::unordered_map<AutoWallPatternFlag, TileSlot> TileSlots;
+		std::array<TileSlot, AutoWallPatternSlotCount> TileSlots;
 
 		std::unique_ptr<ITilePattern> Clone() const override {
 			return std::make_unique<AutoWallPattern>(*this);
 		}
+		// Lookup into a table generated at compile time for all 256 masks
 		static AutoWallPatternFlag PatternFromSurroundingTiles(const SurroundingTileFlags& mask);
 
 		void AddTextureVariant(int patternFlag, TextureVariant variant) override {
-			TileSlots[static_cast<AutoWallPatternFlag>(patternFlag)].TileSprites.emplace_back(std::move(variant));
+			TileSlots[patternFlag].TileSprites.emplace_back(std::move(variant));
 		}
 		void RenderDearImGui() override;
 		const TileSlot* GetTileSlot(const SurroundingTileFlags& mask) const override;
 		uint8_t GetTypeByte() const override {
 			return 3;
 		}
+
+		void ForEachTileSlot(const std::function<void(const TileSlot&)>& func) const override {
+			for (const auto& slot : TileSlots) func(slot);
+		}
 	};
 }
 
@@ -169,17 +190,40 @@ namespace Serialization {
 		return tileSlot;
 	}
 
-	inline std::ostream& Serialize(std::ostream& oStream, const Tiles::AutoTilePattern& tilePattern) {
-		writeToStream(oStream, tilePattern.TileSlots.size());
-
-		for (const auto& [key, entry] : tilePattern.TileSlots) {
-			writeToStream(oStream, static_cast<int>(key));
-			Serialize(oStream, entry);
+	// Writes only used slots as (flag, slot) pairs
+	template<size_t SlotCount>
+	std::ostream& SerializeTileSlots(std::ostream& oStream, const std::array<Tiles::TileSlot, SlotCount>& tileSlots) {
+		size_t usedSlotCount = 0;
+		for (const auto& slot : tileSlots) if (!slot.TileSprites.empty()) ++usedSlotCount;
+		writeToStream(oStream, usedSlotCount);
+
+		for (size_t flag = 0; flag < SlotCount; ++flag) {
+			if (tileSlots[flag].TileSprites.empty()) continue;
+			writeToStream(oStream, static_cast<int>(flag));
+			Serialize(oStream, tileSlots[flag]);
 		}
 
 		return oStream;
 	}
 
+	template<size_t SlotCount>
+	void DeserializeTileSlots(std::istream& stream, std::array<Tiles::TileSlot, SlotCount>& out_tileSlots) {
+		size_t count = 0; readFromStream(stream, count);
+		for (size_t i = 0; i < count; ++i) {
+			int pattern = 0; readFromStream(stream, pattern);
+			Tiles::TileSlot slot = DeserializeTileSlot(stream);
+			if (pattern < 0 || pattern >= static_cast<int>(SlotCount)) {
+				std::cout << "ignoring tileSlot with unknown pattern flag: " << pattern << std::endl;
+				continue;
+			}
+			out_tileSlots[pattern] = std::move(slot);
+		}
+	}
+
+	inline std::ostream& Serialize(std::ostream& oStream, const Tiles::AutoTilePattern& tilePattern) {
+		return SerializeTileSlots(oStream, tilePattern.TileSlots);
+	}
+
 	inline std::ostream& Serialize(std::ostream& oStream, const Tiles::SimpleTilePattern& tilePattern) {
 		Serialize(oStream, tilePattern.tileSlot);
 
@@ -187,14 +231,7 @@ namespace Serialization {
 	}
 
 	inline std::ostream& Serialize(std::ostream& oStream, const Tiles::AutoWallPattern& tilePattern) {
-		writeToStream(oStream, tilePattern.TileSlots.size());
-
-		for (const auto& [key, entry] : tilePattern.TileSlots) {
-			writeToStream(oStream, static_cast<int>(key));
-			Serialize(oStream, entry);
-		}
-
-		return oStream;
+		return SerializeTileSlots(oStream, tilePattern.TileSlots);
 	}
 
 	inline std::ostream& Serialize(std::ostream& oStream, const Tiles::ITilePattern* iTilePattern) {
@@ -227,11 +264,7 @@ namespace Serialization {
 
 	inline Tiles::AutoTilePattern DeserializeAutoTilePattern(std::istream& stream) {
 		Tiles::AutoTilePattern tilePattern;
-		size_t count = 0; readFromStream(stream, count);
-		for (size_t i = 0; i < count; ++i) {
-			int pattern = 0; readFromStream(stream, pattern);
-			tilePattern.TileSlots[static_cast<Tiles::AutoTilePatternFlag>(pattern)] = DeserializeTileSlot(stream);
-		}
+		DeserializeTileSlots(stream, tilePattern.TileSlots);
 
 		return tilePattern;
 	}
@@ -245,11 +278,7 @@ namespace Serialization {
 
 	inline Tiles::AutoWallPattern DeserializeAutoWallPattern(std::istream& stream) {
 		Tiles::AutoWallPattern tilePattern;
-		size_t count = 0; readFromStream(stream, count);
-		for (size_t i = 0; i < count; ++i) {
-			int pattern = 0; readFromStream(stream, pattern);
-			tilePattern.TileSlots[static_cast<Tiles::AutoWallPatternFlag>(pattern)] = DeserializeTileSlot(stream);
-		}
+		DeserializeTileSlots(stream, tilePattern.TileSlots);
 
 		return tilePattern;
 	}
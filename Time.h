@@ -12,6 +12,8 @@ class Time {
 	inline static nanoseconds lastTick;
 	inline static double deltaTimeMS;
 	inline static double deltaTimeD;
+	// used instead of the measured delta when above 0
+	inline static double fixedDeltaTimeMS = 0;
 	Time() = default;
 
 public:
@@ -40,7 +42,7 @@ public:
 		//auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(deltaNano);
 		//deltaTimeMS = ms.count();
 		auto deltaNanoCount = deltaNano.count();
-		deltaTimeMS = deltaNanoCount / 1000000.0;
+		deltaTimeMS = fixedDeltaTimeMS > 0 ? fixedDeltaTimeMS : deltaNanoCount / 1000000.0;
 		deltaTimeD = deltaTimeMS / 1000.0;
 		//auto c = ms.count();
 
@@ -52,6 +54,9 @@ public:
 		lastTick = epoch;
 	}
 
+	// Makes every frame advance by the same time, e.g. to replay input deterministically. 0 measures again
+	static void SetFixedDeltaTimeMS(const double ms) { fixedDeltaTimeMS = ms; }
+
 	static double GetDeltaTime_Double() { return deltaTimeD;  }
 	static float GetDeltaTime() { return static_cast<float>(deltaTimeD); }
 	static double GetDeltaTimeMS() { return deltaTimeMS; }
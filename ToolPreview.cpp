@@ -0,0 +1,106 @@
+#include "ToolPreview.h"
+
+#include <map>
+#include <unordered_map>
+
+#include "Camera.h"
+#include "glad.h"
+#include "InstanceBuffer.h"
+#include "Mesh.h"
+#include "Renderer.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "TextureAtlas.h"
+#include "Tile.h"
+#include "TileInstance.h"
+
+namespace {
+	constexpr float previewDepth = 0.02f;
+	constexpr float previewOpacity = 0.5f;
+}
+
+GridTools::ToolPreview::ToolPreview() = default;
+GridTools::ToolPreview::~ToolPreview() = default;
+
+void GridTools::ToolPreview::Set(std::vector<PreviewCell> previewCells, const glm::ivec2 previewTileDimensions) {
+	cells = std::move(previewCells);
+	tileDimensions = previewTileDimensions;
+	instancesDirty = true;
+}
+
+void GridTools::ToolPreview::Clear() {
+	cells.clear();
+	instancesDirty = true;
+}
+
+void GridTools::ToolPreview::RebuildInstances() const {
+	using namespace glm;
+	struct TileTexture {
+		Rendering::InstanceTexture Texture;
+		vec4 UvRect;
+		float Layer = -1.0f;
+	};
+	// the ghost shows tiles without neighbours, autotiling happens once the cells are placed
+	std::unordered_map<const Tiles::Tile*, TileTexture> tileTextures;
+	const auto getTileTexture = [&tileTextures](const Tiles::Tile* tile) {
+		if (const auto it = tileTextures.find(tile); it != tileTextures.end()) return it->second;
+		const Rendering::Texture* texture = Tiles::TileInstance::GetTextureFromMask(tile, Tiles::SurroundingTileFlags::NONE, ivec2(0));
+		TileTexture tileTexture{ { texture->GetTextureID() }, texture->GetUvRect() };
+		unsigned int arrayTextureId;
+		int layer;
+		if (Rendering::AtlasRegion region; Rendering::TextureAtlas::TryGetRegion(texture->AssetId, region)) {
+			tileTexture = { { Rendering::TextureAtlas::GetPageTextureId(region.Page) }, region.UvRect };
+		}
+		else if (texture->TryGetArrayLayer(arrayTextureId, layer)) {
+			tileTexture = { { arrayTextureId, true }, vec4(0, 0, 1, 1), static_cast<float>(layer) };
+		}
+		tileTextures.emplace(tile, tileTexture);
+		return tileTexture;
+	};
+
+	// large shapes are clipped to the visible part of the grid
+	std::map<Rendering::InstanceTexture, std::vector<Rendering::InstanceData>> instancesByTexture;
+	const vec2 scale = tileDimensions;
+	for (const auto& [position, tile] : cells) {
+		if (tile == nullptr) continue;
+		if (any(lessThan(position + tileDimensions, visibleMin)) || any(greaterThan(position, visibleMax))) continue;
+		const TileTexture tileTexture = getTileTexture(tile);
+		instancesByTexture[tileTexture.Texture].push_back({ vec2(position) + scale / 2.0f, scale, tileTexture.UvRect, tileTexture.Layer });
+	}
+
+	std::vector<Rendering::InstanceData> instances;
+	batches.clear();
+	for (const auto& [instanceTexture, textureInstances] : instancesByTexture) {
+		batches.push_back({ instanceTexture, instances.size(), textureInstances.size() });
+		instances.insert(instances.end(), textureInstances.begin(), textureInstances.end());
+	}
+
+	if (instanceBuffer == nullptr) instanceBuffer = std::make_unique<Rendering::InstanceBuffer>(Mesh::StaticMesh::GetDefaultQuad());
+	instanceBuffer->Upload(instances);
+	instancesDirty = false;
+}
+
+void GridTools::ToolPreview::Render() const {
+	if (!IsActive()) return;
+
+	glm::ivec2 boundsMin, boundsMax;
+	Rendering::Camera::Main->GetVisibleGridBounds(boundsMin, boundsMax);
+	if (boundsMin != visibleMin || boundsMax != visibleMax) {
+		visibleMin = boundsMin;
+		visibleMax = boundsMax;
+		instancesDirty = true;
+	}
+	if (instancesDirty) RebuildInstances();
+	if (instanceBuffer->GetInstanceCount() == 0) return;
+
+	const auto& shader = Rendering::Renderer::instancedShader;
+	shader->Use();
+	shader->setFloat("depth", previewDepth);
+	shader->setFloat("opacity", previewOpacity);
+	for (const auto& batch : batches) {
+		batch.Texture.Bind();
+		instanceBuffer->Draw(batch.FirstInstance, batch.InstanceCount);
+	}
+	shader->setFloat("opacity", 1.0f);
+	Rendering::Renderer::defaultShader->Use();
+}
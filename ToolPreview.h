@@ -0,0 +1,52 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <glm/vec2.hpp>
+
+#include "InstanceBuffer.h"
+
+namespace Tiles {
+	class Tile;
+}
+
+namespace GridTools {
+	struct PreviewCell {
+		// grid position in the active tileMap
+		glm::ivec2 Position;
+		const Tiles::Tile* Tile;
+	};
+
+	// Translucent ghost of the cells a tool is about to place, nothing is written to the tileMap
+	class ToolPreview {
+		std::vector<PreviewCell> cells;
+		glm::ivec2 tileDimensions = glm::ivec2(1, 1);
+
+		struct TextureBatch {
+			Rendering::InstanceTexture Texture;
+			size_t FirstInstance;
+			size_t InstanceCount;
+		};
+
+		// Instances are only rebuilt when the cells or the visible part of the grid change
+		mutable std::unique_ptr<Rendering::InstanceBuffer> instanceBuffer;
+		mutable std::vector<TextureBatch> batches;
+		mutable bool instancesDirty = true;
+		mutable glm::ivec2 visibleMin = glm::ivec2(0);
+		mutable glm::ivec2 visibleMax = glm::ivec2(-1);
+
+		void RebuildInstances() const;
+
+	public:
+		ToolPreview(const ToolPreview& other) = delete;
+		ToolPreview& operator=(const ToolPreview& other) = delete;
+		ToolPreview();
+		~ToolPreview();
+
+		void Set(std::vector<PreviewCell> previewCells, glm::ivec2 previewTileDimensions);
+		void Clear();
+		bool IsActive() const { return !cells.empty(); }
+		const std::vector<PreviewCell>& GetCells() const { return cells; }
+
+		void Render() const;
+	};
+}
@@ -1,17 +1,41 @@
 #include <SDL.h>
+#include <string>
+#include "AssetLoader.h"
+#include "InputRecording.h"
 #include "MainWindow.h"
 #include "imgui.h"
 #include "imgui_impl_sdl.h"
 #include "imgui_impl_opengl3.h"
 #include "Input.h"
+#include "Profiler.h"
 #include "Resources.h"
 #include "Time.h"
 
-void HandleSDLEvents(SDL_Event& sdlEvent, bool& quit);
+void HandleSDLEvent(const SDL_Event& sdlEvent, bool& quit);
+void HandleSDLEvents(SDL_Event& sdlEvent, bool& quit, InputRecorder& recorder, bool replaying);
+void ReplayFrame(InputReplay& replay, bool& quit);
 
 int main(int arg, char** args) {
+	// --record <file> captures the input of the session, --replay <file> feeds it back at a fixed frame time
+	// and writes the time of each frame to --replay-out (default <file>.frames.csv)
+	std::string recordPath, replayPath, replayOutPath;
+	for (int i = 1; i + 1 < arg; ++i) {
+		const std::string argument = args[i];
+		if (argument == "--record") recordPath = args[++i];
+		else if (argument == "--replay") replayPath = args[++i];
+		else if (argument == "--replay-out") replayOutPath = args[++i];
+	}
+	if (replayOutPath.empty()) replayOutPath = replayPath + ".frames.csv";
+
+	InputRecorder recorder;
+	InputReplay replay;
+	const bool replaying = !replayPath.empty();
+	if (replaying && !replay.Load(replayPath)) return 1;
+
 	//init time module
 	Time::Init();
+	if (replaying) Time::SetFixedDeltaTimeMS(1000.0 / 60.0);
+	Profiling::Profiler::SetThreadName("Main");
 	{
 		//Create SDL Window
 		Rendering::MainWindow mainWindow = Rendering::MainWindow(1200, 800, "LevelEditor");
@@ -23,11 +47,37 @@ int main(int arg, char** args) {
 		ImGuiIO& imgui_io = ImGui::GetIO();
 		SDL_Event sdlEvent;
 		bool quit = false;
+		// recording and replay start once the assets are loaded, input before that is not reproducible
+		bool inputSessionStarted = false;
 		while (!quit) {
+			const uint64_t frameStart = Profiling::Profiler::Now();
+			Profiling::Profiler::NewFrame();
 			Time::CalcDeltaTime();
-			HandleSDLEvents(sdlEvent, quit);
+
+			if (!inputSessionStarted && !AssetLoader::IsLoading()) {
+				inputSessionStarted = true;
+				int width, height, mouseX, mouseY;
+				if (replaying) {
+					const InputRecording& recording = replay.GetRecording();
+					SDL_SetWindowSize(Rendering::MainWindow::GetSDLWindow(), recording.WindowWidth, recording.WindowHeight);
+					Rendering::MainWindow::OnResized(recording.WindowWidth, recording.WindowHeight);
+					Input::OverrideMousePosition(recording.MouseX, recording.MouseY);
+				}
+				else if (!recordPath.empty()) {
+					Rendering::MainWindow::GetSize(width, height);
+					SDL_GetMouseState(&mouseX, &mouseY);
+					recorder.Start(recordPath, width, height, mouseX, mouseY);
+				}
+			}
+
+			{
+				PROFILE_SCOPE("HandleSDLEvents");
+				HandleSDLEvents(sdlEvent, quit, recorder, replaying);
+				if (replaying && inputSessionStarted) ReplayFrame(replay, quit);
+			}
 
 			if (!imgui_io.WantCaptureMouse) {
+				PROFILE_SCOPE("Input::DelegateMouseActions");
 				Input::DelegateMouseActions();
 			}
 			else {
@@ -35,13 +85,23 @@ int main(int arg, char** args) {
 			}
 
 			if (!imgui_io.WantCaptureKeyboard) {
+				PROFILE_SCOPE("Input::DelegateKeyboardActions");
 				Input::DelegateKeyboardActions();
 			}
 			else {
 				Input::ClearKeyboardActions();
 			}
 			mainWindow.Render();
+
+			const double frameTimeMS = static_cast<double>(Profiling::Profiler::Now() - frameStart) / 1000000.0;
+			if (recorder.IsRecording()) recorder.EndFrame(frameTimeMS);
+			if (replaying && inputSessionStarted) {
+				replay.EndFrame(frameTimeMS);
+				if (replay.IsFinished()) quit = true;
+			}
 		}
+		recorder.Stop();
+		if (replaying) replay.WriteFrameTimes(replayOutPath);
 		mainWindow.Close();
 	}
 
@@ -56,44 +116,45 @@ int main(int arg, char** args) {
 	return 0;
 }
 
-void HandleSDLEvents(SDL_Event& sdlEvent, bool& quit) {
-	while (SDL_PollEvent(&sdlEvent)) {
-		ImGui_ImplSDL2_ProcessEvent(&sdlEvent);
-		switch (sdlEvent.type) {
-		case SDL_QUIT:
-			quit = true;
-			break;
+void HandleSDLEvent(const SDL_Event& sdlEvent, bool& quit) {
+	ImGui_ImplSDL2_ProcessEvent(&sdlEvent);
+	switch (sdlEvent.type) {
+	case SDL_QUIT:
+		quit = true;
+		break;
 
-		case SDL_WINDOWEVENT:
-			switch (sdlEvent.window.event) {
-			case SDL_WINDOWEVENT_RESIZED:
-				const int w = sdlEvent.window.data1;
-				const int h = sdlEvent.window.data2;
-				Rendering::MainWindow::OnResized(w, h);
-				break;
-			}
-			break;
-
-		case SDL_KEYDOWN:
-			Input::ReceiveKeyDownInput(sdlEvent.key.keysym.sym);
-			break;
-
-		case SDL_KEYUP:
-			Input::ReceiveKeyUpInput(sdlEvent.key.keysym.sym);
+	case SDL_WINDOWEVENT:
+		switch (sdlEvent.window.event) {
+		case SDL_WINDOWEVENT_RESIZED:
+			const int w = sdlEvent.window.data1;
+			const int h = sdlEvent.window.data2;
+			Rendering::MainWindow::OnResized(w, h);
 			break;
+		}
+		break;
 
-		case SDL_MOUSEMOTION:
-			Input::ReceiveMouseMotion(sdlEvent.motion);
-			break;
+	default:
+		Input::ReceiveSDLEvent(sdlEvent);
+	}
+}
 
-		case SDL_MOUSEBUTTONUP:
-		case SDL_MOUSEBUTTONDOWN:
-			Input::ReceiveMouseButtonEvent(sdlEvent.button);
-			break;
+void HandleSDLEvents(SDL_Event& sdlEvent, bool& quit, InputRecorder& recorder, const bool replaying) {
+	RecordedEventKind kind;
+	while (SDL_PollEvent(&sdlEvent)) {
+		// real input would mix with the replayed input
+		if (replaying && InputRecording::TryGetKind(sdlEvent, kind)) continue;
+		recorder.Record(sdlEvent);
+		HandleSDLEvent(sdlEvent, quit);
+	}
+}
 
-		case SDL_MOUSEWHEEL:
-			Input::ReceiveMouseWheelEvent(sdlEvent.wheel);
+void ReplayFrame(InputReplay& replay, bool& quit) {
+	const auto [events, eventCount] = replay.NextFrame();
+	for (size_t i = 0; i < eventCount; ++i) {
+		const SDL_Event& sdlEvent = events[i];
+		if (sdlEvent.type == SDL_WINDOWEVENT) {
+			SDL_SetWindowSize(Rendering::MainWindow::GetSDLWindow(), sdlEvent.window.data1, sdlEvent.window.data2);
 		}
+		HandleSDLEvent(sdlEvent, quit);
 	}
 }
-